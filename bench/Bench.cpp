@@ -0,0 +1,69 @@
+#include "Bench.h"
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+namespace bench {
+    struct Entry {
+        std::string name;
+        BenchFn fn;
+        size_t size = 0; // BENCH_SIZES, 0 for the others
+    };
+
+    static std::vector<Entry>& registry() {
+        static std::vector<Entry> entries;
+        return entries;
+    }
+
+    Registrar::Registrar(const std::string& name, BenchFn fn) {
+        registry().push_back({ name, std::move(fn) });
+    }
+
+    Registrar::Registrar(const std::string& name, std::initializer_list<size_t> sizes, SizedBenchFn fn) {
+        for (size_t size : sizes) {
+            registry().push_back({ name + "/" + std::to_string(size), [fn, size](size_t iterations) { fn(iterations, size); }, size });
+        }
+    }
+
+    static const void* volatile sink = nullptr;
+
+    void doNotOptimize(const void* p) {
+        sink = p;
+    }
+
+    static double timeRun(const BenchFn& fn, size_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        fn(iterations);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    int runAll(const std::string& filter) {
+        constexpr double targetNs = 50e6; // ~50 ms per repetition
+        constexpr int repetitions = 5;
+        std::printf("%-48s %14s %14s %12s %12s\n", "benchmark", "median ns/op", "min ns/op", "iterations", "ns/item");
+        int count = 0;
+        for (const auto& entry : registry()) {
+            if (!filter.empty() && entry.name.find(filter) == std::string::npos) continue;
+            count++;
+            // grow the iteration count until one run takes long enough to measure
+            size_t iterations = 1;
+            double ns = timeRun(entry.fn, iterations);
+            while (ns < targetNs && iterations < (size_t(1) << 30)) {
+                double factor = ns > 0.0 ? std::min(10.0, std::max(2.0, 1.2 * targetNs / ns)) : 10.0;
+                iterations = static_cast<size_t>(iterations * factor);
+                ns = timeRun(entry.fn, iterations);
+            }
+            std::vector<double> perOp;
+            for (int r = 0; r < repetitions; r++) {
+                perOp.push_back(timeRun(entry.fn, iterations) / static_cast<double>(iterations));
+            }
+            std::sort(perOp.begin(), perOp.end());
+            std::printf("%-48s %14.1f %14.1f %12zu", entry.name.c_str(), perOp[repetitions / 2], perOp[0], iterations);
+            if (entry.size) std::printf(" %12.2f", perOp[repetitions / 2] / static_cast<double>(entry.size));
+            std::printf("\n");
+        }
+        if (count == 0) std::printf("no benchmark matches '%s'\n", filter.c_str());
+        return 0;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <initializer_list>
+#include <cstddef>
+
+// tiny micro benchmark harness (build target: microbench)
+// register a function with BENCH(name) { for (size_t i = 0; i < iterations; i++) { ... } }
+// the harness picks the iteration count, runs a few repetitions and reports the median time per iteration
+// BENCH_SIZES(name, 16, 256, 4096) { ... } runs once per size (the size argument), one row each as name/size,
+// with the time per item next to it, so it shows how the cost scales
+
+namespace bench {
+    using BenchFn = std::function<void(size_t iterations)>;
+    using SizedBenchFn = std::function<void(size_t iterations, size_t size)>;
+
+    struct Registrar {
+        Registrar(const std::string& name, BenchFn fn);
+        Registrar(const std::string& name, std::initializer_list<size_t> sizes, SizedBenchFn fn);
+    };
+
+    // keeps the compiler from optimizing away a result
+    void doNotOptimize(const void* p);
+    template <typename T>
+    void keep(const T& value) { doNotOptimize(&value); }
+
+    int runAll(const std::string& filter);
+}
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCH(name) \
+    static void name(size_t iterations); \
+    static bench::Registrar BENCH_CONCAT(name, _registrar)(#name, name); \
+    static void name(size_t iterations)
+
+#define BENCH_SIZES(name, ...) \
+    static void name(size_t iterations, size_t size); \
+    static bench::Registrar BENCH_CONCAT(name, _registrar)(#name, { __VA_ARGS__ }, name); \
+    static void name(size_t iterations, size_t size)
@@ -0,0 +1,35 @@
+#include "BenchGame.h"
+#include "Game.h"
+#include <chrono>
+#include <exception>
+#include <memory>
+
+namespace bench {
+    Game& game() {
+        static std::unique_ptr<Game> instance;
+        if (instance) return *instance;
+        LaunchOptions options;
+        options.headless = true;
+        options.newGame = true;
+        instance = std::make_unique<Game>(options);
+        Game& g = *instance;
+        // the loop of Game::run until Preload is done and InGame is running
+        // (limited by time, not frames: the headless frames are so short that the workers decoding the assets fall behind)
+        float deltaTime = 1.0f / g.getSetting("targetFPS").get<float>();
+        auto start = std::chrono::steady_clock::now();
+        g.startScene("Preload");
+        while (g.getScene("Preload") || !g.getPlayer()) {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(120)) {
+                TraceLog(LOG_ERROR, "BENCH: The game didn't finish booting");
+                std::terminate();
+            }
+            g.update(deltaTime);
+            g.lateUpdate();
+            g.processMarkedSprites();
+            g.processMarkedScenes();
+            g.captureScenes();
+            g.draw();
+        }
+        return g;
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+class Game;
+
+namespace bench {
+    // the game, booted once without window or sound (assets loaded, a new game started)
+    // for the benchmarks that need a Game, it also opens the GL context the fonts and textures need
+    Game& game();
+}
@@ -0,0 +1,55 @@
+#include "Bench.h"
+#include "Utils.h"
+#include "raylib.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// the linear wall checks: isPathClear (line of sight for ChaseBehavior) and the CheckCollisionRecs loop over
+// game.walls that InGame runs for every colliding sprite, for rooms with more and more walls
+
+using Walls = std::vector<std::unique_ptr<Rectangle>>;
+
+static const Walls& walls(size_t count) {
+    // 16 px wall tiles in rows, the way the Tiled wall objects of a big map end up in game.walls
+    static std::unordered_map<size_t, Walls> cache;
+    Walls& w = cache[count];
+    if (w.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            float x = static_cast<float>((i * 3) % 256) * 16.0f;
+            float y = 512.0f + static_cast<float>(i / 256) * 48.0f;
+            w.push_back(std::make_unique<Rectangle>(Rectangle{ x, y, 16.0f, 16.0f }));
+        }
+    }
+    return w;
+}
+
+// worst case: the path is clear, every wall is tested
+BENCH_SIZES(is_path_clear, 64, 512, 4096) {
+    const Walls& w = walls(size);
+    Rectangle enemy = { 100.0f, 100.0f, 14.0f, 12.0f };
+    size_t clear = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        Vector2 target = { 100.0f + static_cast<float>(i % 200), 300.0f };
+        clear += isPathClear(enemy, target, w);
+    }
+    bench::keep(clear);
+}
+
+// 16 sprites against all walls, some of them overlap a wall
+BENCH_SIZES(collision_sweep, 64, 512, 4096) {
+    const Walls& w = walls(size);
+    std::vector<Rectangle> sprites;
+    for (int s = 0; s < 16; ++s) {
+        sprites.push_back({ static_cast<float>(s * 150 % 4096), 500.0f + static_cast<float>(s * 37 % 200), 14.0f, 12.0f });
+    }
+    size_t hits = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        for (const Rectangle& sprite : sprites) {
+            for (const auto& wall : w) {
+                hits += CheckCollisionRecs(sprite, *wall);
+            }
+        }
+    }
+    bench::keep(hits);
+}
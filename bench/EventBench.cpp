@@ -0,0 +1,87 @@
+#include "Bench.h"
+#include "EventChannel.h"
+#include "EventManager.h"
+#include "GameEvents.h"
+#include <any>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// event dispatch: the string-keyed EventManager as it was (the value is stored in the events map,
+// listeners are std::function<void(std::any)> that any_cast a tuple) against a typed EventChannel
+// 4 listeners, like screenShake with the camera, HUD and a couple of behaviors listening
+
+static constexpr int LISTENERS = 4;
+
+struct LegacyEvents {
+    std::unordered_map<std::string, std::any> events;
+    std::unordered_map<std::string, std::vector<std::function<void(std::any)>>> listeners;
+
+    void pushEvent(const std::string& key, std::any value) {
+        events[key] = value;
+        auto it = listeners.find(key);
+        if (it != listeners.end()) {
+            for (auto& callback : it->second) callback(value);
+        }
+    }
+};
+
+BENCH(event_dispatch_legacy) {
+    static float sum = 0.0f;
+    static LegacyEvents events;
+    if (events.listeners.empty()) {
+        for (int i = 0; i < LISTENERS; ++i) {
+            events.listeners["screenShake"].push_back([](std::any value) {
+                auto [duration, x, y] = std::any_cast<std::tuple<float, float, float>>(value);
+                sum += duration + x + y;
+                });
+            events.listeners["showHelpText"].push_back([](std::any value) {
+                auto [label, key, index] = std::any_cast<std::tuple<std::string, char, int>>(value);
+                sum += static_cast<float>(label.size() + key + index);
+                });
+        }
+    }
+    for (size_t i = 0; i < iterations; i++) {
+        events.pushEvent("screenShake", std::make_tuple(0.1f, 0.0f, 10.0f));
+        events.pushEvent("showHelpText", std::make_any<std::tuple<std::string, char, int>>(std::tuple<std::string, char, int>{ "OPEN", 'O', 9 }));
+    }
+    bench::keep(sum);
+}
+
+BENCH(event_dispatch_typed) {
+    static float sum = 0.0f;
+    static EventChannel<ScreenShake> shake;
+    static EventChannel<ShowHelpText> helpText;
+    if (shake.size() == 0) {
+        for (int i = 0; i < LISTENERS; ++i) {
+            shake.subscribe(i + 1, [](const ScreenShake& event) { sum += event.duration + event.xMagnitude + event.yMagnitude; });
+            helpText.subscribe(i + 1, [](const ShowHelpText& event) { sum += static_cast<float>(event.label[0] + event.key + event.buttonIndex); });
+        }
+    }
+    for (size_t i = 0; i < iterations; i++) {
+        shake.dispatch(ScreenShake{ 0.1f, 0.0f, 10.0f });
+        helpText.dispatch(ShowHelpText{ "OPEN", 'O', 9 });
+    }
+    bench::keep(sum);
+}
+
+// EventManager::pushEvent with a string key and n listeners, the way most of the game's events still go
+// (std::any value, listeners added with addListener)
+BENCH_SIZES(event_push, 1, 8, 64) {
+    static std::unordered_map<size_t, std::unique_ptr<EventManager>> managers;
+    static float sum = 0.0f;
+    auto& events = managers[size];
+    if (!events) {
+        events = std::make_unique<EventManager>();
+        for (size_t i = 0; i < size; ++i) {
+            events->addListener("benchEvent", [](std::any value) { sum += std::any_cast<float>(value); });
+        }
+    }
+    for (size_t i = 0; i < iterations; i++) {
+        events->pushEvent("benchEvent"_id, 1.0f);
+    }
+    bench::keep(sum);
+}
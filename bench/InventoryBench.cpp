@@ -0,0 +1,46 @@
+#include "Bench.h"
+#include "BenchGame.h"
+#include "Game.h"
+#include <string>
+#include <vector>
+
+// InventoryManager lookups with size items in the inventory (spread over the item types like the real
+// ones): getItemQuantity for every item (it searches the maps of all types) and the item data lookup
+// that the HUD and the UI do
+
+static const std::vector<std::string>& inventoryKeys(size_t size) {
+    // adds bench items to the game's inventory until there are size of them
+    static std::vector<std::string> keys;
+    Game& game = bench::game();
+    auto& itemData = game.inventory.getItemData();
+    while (keys.size() < size) {
+        std::string key = "bench_item_" + std::to_string(keys.size());
+        ItemData data = itemData.begin()->second;
+        data.type = static_cast<ItemType>(keys.size() % NUM_ITEM_TYPES);
+        data.onConsume = nullptr;
+        itemData[key] = data;
+        game.eventManager.pushEvent("addItem"_id, std::make_any<std::pair<std::string, uint32_t>>(key, 1));
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+BENCH_SIZES(inventory_quantity, 8, 64, 512) {
+    const std::vector<std::string>& keys = inventoryKeys(size);
+    const InventoryManager& inventory = bench::game().inventory;
+    uint32_t sum = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        for (size_t k = 0; k < size; ++k) sum += inventory.getItemQuantity(keys[k]);
+    }
+    bench::keep(sum);
+}
+
+BENCH_SIZES(inventory_item_data, 8, 64, 512) {
+    const std::vector<std::string>& keys = inventoryKeys(size);
+    auto& itemData = bench::game().inventory.getItemData();
+    size_t found = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        for (size_t k = 0; k < size; ++k) found += itemData.find(keys[k]) != itemData.end();
+    }
+    bench::keep(found);
+}
@@ -0,0 +1,55 @@
+#include "Bench.h"
+#include "AssetLoader.h"
+#include "Utils.h"
+#include "json.hpp"
+#include <string>
+#include <unordered_map>
+
+// the sprite data loading: resolveInheritance along a chain of "inherits" (enemies.json has a depth of 2,
+// sprite_default -> enemy), and mergeJson of objects with more and more keys
+
+static nlohmann::json spriteEntry(size_t index, size_t fields) {
+    // something like an entry in enemies.json
+    nlohmann::json entry = {
+        { "textures", { "skelet_idle", "skelet_run" } },
+        { "behaviorData", { { "chaseTarget", "player" }, { "level", index } } }
+    };
+    for (size_t f = 0; f < fields; ++f) {
+        entry["field" + std::to_string(f)] = static_cast<float>(index * fields + f);
+    }
+    return entry;
+}
+
+BENCH_SIZES(resolve_inheritance, 1, 4, 16) {
+    static std::unordered_map<size_t, std::unordered_map<std::string, nlohmann::json>> chains;
+    auto& data = chains[size];
+    if (data.empty()) {
+        // e0 <- e1 <- ... <- e<size>
+        for (size_t i = 0; i <= size; ++i) {
+            nlohmann::json entry = spriteEntry(i, 8);
+            if (i > 0) entry["inherits"] = "e" + std::to_string(i - 1);
+            data["e" + std::to_string(i)] = entry;
+        }
+    }
+    std::string key = "e" + std::to_string(size);
+    for (size_t i = 0; i < iterations; i++) {
+        std::unordered_map<std::string, bool> visited;
+        nlohmann::json resolved = resolveInheritance(data, key, visited);
+        bench::keep(resolved);
+    }
+}
+
+BENCH_SIZES(merge_json, 8, 64, 512) {
+    // the base is copied every time (mergeJson changes it), like resolveInheritance does with the parent
+    static std::unordered_map<size_t, std::pair<nlohmann::json, nlohmann::json>> inputs;
+    auto& [base, override] = inputs[size];
+    if (base.is_null()) {
+        base = spriteEntry(0, size);
+        override = spriteEntry(1, size / 2);
+    }
+    for (size_t i = 0; i < iterations; i++) {
+        nlohmann::json merged = base;
+        mergeJson(merged, override);
+        bench::keep(merged);
+    }
+}
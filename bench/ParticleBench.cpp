@@ -0,0 +1,52 @@
+#include "Bench.h"
+#include "BenchGame.h"
+#include "Game.h"
+#include "Emitter.h"
+#include <memory>
+#include <unordered_map>
+
+// a single emitter with size particle slots: filling all of them with Emitter::emit (it searches for a free
+// slot every time) and Emitter::updateParticles with all of them alive
+
+static Emitter makeEmitter(size_t size) {
+    // the smoke look, but the particles live long enough to stay alive during the benchmark
+    Emitter e;
+    e.velocityVariance = { 20.0f, 20.0f };
+    e.lifetimeVariance = 0.05f;
+    e.maxParticles = size;
+    e.particles.assign(size, Particle{});
+    e.prototype.lifetime = 1.0e9f;
+    e.prototype.endAlpha = 0.0f;
+    e.prototype.endSize = 0.2f;
+    e.prototype.setAnimationFrames(bench::game().loader.getTextures("smoke"));
+    e.alive = true;
+    return e;
+}
+
+BENCH_SIZES(emitter_fill, 16, 256, 4096) {
+    Emitter e = makeEmitter(size);
+    FastRandom rng(1234);
+    size_t emitted = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        while (e.emit(rng)) emitted++;
+        // empty again, like killParticles
+        for (Particle& p : e.particles) p.active = false;
+        e.activeParticles = 0;
+    }
+    bench::keep(emitted);
+}
+
+BENCH_SIZES(emitter_update, 16, 256, 4096) {
+    static std::unordered_map<size_t, std::unique_ptr<Emitter>> emitters;
+    auto& e = emitters[size];
+    if (!e) {
+        e = std::make_unique<Emitter>(makeEmitter(size));
+        FastRandom rng(1234);
+        while (e->emit(rng)) {}
+    }
+    size_t died = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        died += e->updateParticles(1.0f / 120.0f);
+    }
+    bench::keep(died);
+}
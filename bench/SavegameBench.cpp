@@ -0,0 +1,53 @@
+#include "Bench.h"
+#include "Savegame.h"
+#include "json.hpp"
+#include <string>
+#include <unordered_map>
+
+// writeDataToJSON and readSaveDataFromJSON for a save with size rooms
+// (the game's dungeon has 6, every room with a few tile edits and object states)
+
+static SaveGame makeSave(size_t rooms) {
+    SaveGame save;
+    save.playerHealth = 6;
+    save.playerMaxHealth = 10;
+    save.items = { { "coin", 42 }, { "red_potion", 2 }, { "weapon_sword", 1 } };
+    save.dungeonWidth = 16;
+    save.dungeonHeight = (rooms + 15) / 16;
+    for (size_t i = 0; i < rooms; ++i) {
+        RoomData room;
+        room.visited = i % 2 == 0;
+        room.dark = i % 7 == 0;
+        room.doors = static_cast<uint8_t>(i % 16);
+        room.state = static_cast<uint8_t>(1 + i % 3);
+        room.tilemapKey = "dungeon00" + std::to_string(1 + i % 6);
+        for (uint32_t o = 0; o < 8; ++o) {
+            room.objectStates[o * 3 + 1] = ObjectState{ o % 2 == 0, o % 3 == 0, o };
+        }
+        for (uint16_t e = 0; e < 16; ++e) {
+            room.tileEdits.push_back(TileEdit{ 1, static_cast<uint16_t>(e % 16), static_cast<uint16_t>(e / 2), static_cast<uint16_t>(40 + e) });
+        }
+        save.DungeonRooms[static_cast<uint32_t>(i)] = room;
+    }
+    return save;
+}
+
+BENCH_SIZES(savegame_write, 16, 64, 256) {
+    static std::unordered_map<size_t, SaveGame> saves;
+    auto found = saves.find(size);
+    if (found == saves.end()) found = saves.emplace(size, makeSave(size)).first;
+    for (size_t i = 0; i < iterations; i++) {
+        nlohmann::json j = writeDataToJSON(found->second);
+        bench::keep(j);
+    }
+}
+
+BENCH_SIZES(savegame_read, 16, 64, 256) {
+    static std::unordered_map<size_t, nlohmann::json> inputs;
+    auto& j = inputs[size];
+    if (j.is_null()) j = writeDataToJSON(makeSave(size));
+    for (size_t i = 0; i < iterations; i++) {
+        SaveGame save = readSaveDataFromJSON(j);
+        bench::keep(save);
+    }
+}
@@ -0,0 +1,63 @@
+#include "Bench.h"
+#include "Scheduler.h"
+#include <any>
+#include <functional>
+#include <vector>
+
+// delayed events per frame at 60 fps: every frame KILLS sprites die and each adds a 2 second
+// "killSprite" event (see InGame::update), so about 120 * KILLS timers are pending and KILLS fire per frame
+// the old EventManager counted every timer down each frame and erased the fired ones from the vector
+
+static constexpr int KILLS = 20;
+static constexpr float FRAME = 1.0f / 60.0f;
+
+struct LegacyTimers {
+    struct TimedEvent {
+        StringId key;
+        float timeRemaining;
+        std::any value;
+        std::function<void()> callback;
+    };
+    std::vector<TimedEvent> delayedEvents;
+
+    void update(float deltaTime) {
+        for (auto it = delayedEvents.begin(); it != delayedEvents.end(); ) {
+            it->timeRemaining -= deltaTime;
+            if (it->timeRemaining <= 0.0f) {
+                if (it->callback) it->callback();
+                it = delayedEvents.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+};
+
+BENCH(timers_frame_legacy) {
+    static size_t fired = 0;
+    static LegacyTimers timers;
+    for (size_t i = 0; i < iterations; i++) {
+        for (int k = 0; k < KILLS; ++k) {
+            timers.delayedEvents.push_back({ "killSprite"_id, 2.01f, nullptr, []() { fired++; } });
+        }
+        timers.update(FRAME);
+    }
+    bench::keep(fired);
+}
+
+BENCH(timers_frame_heap) {
+    static size_t fired = 0;
+    static Scheduler scheduler;
+    for (size_t i = 0; i < iterations; i++) {
+        for (int k = 0; k < KILLS; ++k) {
+            Scheduler::Timer timer;
+            timer.key = "killSprite"_id;
+            timer.value = nullptr;
+            timer.callback = []() { fired++; };
+            scheduler.add(2.01f, std::move(timer));
+        }
+        scheduler.update(FRAME, [](Scheduler::Timer& timer) { timer.callback(); });
+    }
+    bench::keep(fired);
+}
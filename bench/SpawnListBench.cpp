@@ -0,0 +1,128 @@
+#include "Bench.h"
+#include "SpawnList.h"
+#include "TileMap.h"
+#include "raylib.h"
+#include "json.hpp"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// the spawn decisions of a room transition, for every dungeon room:
+// walking the TileObjects with property lookups and name compares (what loadTilemap did on every entry)
+// against filtering the room's compiled SpawnList
+// only the part before the sprites are created, that part is the same for both
+
+struct SpawnFixture {
+    std::vector<std::unique_ptr<TileMap>> rooms;
+    std::vector<SpawnList> lists;
+    std::unordered_map<std::string, uint32_t> archetypeIds;
+
+    SpawnFixture() {
+        // dungeon_entry is left out, it's an empty placeholder without a tileset
+        const char* names[] = {
+            "dungeon001", "dungeon002", "dungeon003", "dungeon004", "dungeon005", "dungeon006",
+            "dungeon_shop", "dungeon_template_single", "dungeon_template_double_w", "dungeon_template_double_h"
+        };
+        size_t objects = 0;
+        for (const char* name : names) {
+            std::ifstream file(std::string("./resources/tilemaps/") + name + ".json");
+            if (!file) continue;
+            nlohmann::json j;
+            file >> j;
+            rooms.push_back(std::make_unique<TileMap>(j, name));
+            // stand-in for the loader's archetype table, every sprite name gets an id
+            for (const auto& obj : rooms.back()->objects) {
+                std::string spriteName = obj.properties.value("spriteName", "sprite_default");
+                archetypeIds.emplace(spriteName, static_cast<uint32_t>(archetypeIds.size()));
+            }
+            objects += rooms.back()->objects.size();
+        }
+        for (const auto& room : rooms) {
+            lists.emplace_back(*room, archetypeIds, 0);
+        }
+        std::printf("spawn lists: %zu rooms, %zu objects\n", rooms.size(), objects);
+    }
+};
+
+static const SpawnFixture& fixture() {
+    static SpawnFixture f;
+    return f;
+}
+
+static constexpr uint8_t ROOM_STATE = 1;
+
+BENCH(room_transition_objects) {
+    const auto& f = fixture();
+    for (size_t i = 0; i < iterations; i++) {
+        size_t sum = 0;
+        for (const auto& room : f.rooms) {
+            for (const TileObject& obj : room->objects) {
+                if (!obj.visible) continue;
+                uint8_t objectState = obj.properties.value("roomState", 0);
+                if (objectState != 0 && (objectState & ROOM_STATE) == 0) continue;
+                if (obj.type == "wall") {
+                    sum += static_cast<size_t>(obj.width + obj.height);
+                }
+                else if (obj.type == "sprite") {
+                    std::string spriteName = obj.properties.value("spriteName", "sprite_default");
+                    auto it = f.archetypeIds.find(spriteName);
+                    sum += it != f.archetypeIds.end() ? it->second : 0;
+                    sum += static_cast<size_t>(obj.properties.value("speed", 10.0f));
+                    sum += obj.properties.value("damage", 0);
+                    sum += static_cast<size_t>(obj.properties.value("knockback", 0.0f));
+                    sum += obj.properties.value("drawLayer", 0);
+                    sum += static_cast<size_t>(obj.properties.value("hurtboxW", 0.0f) + obj.properties.value("hurtboxH", 0.0f));
+                    if (obj.name == "teleport") sum += 1;
+                    else if (obj.name == "npc") sum += 2;
+                    else if (obj.name == "tradeItem") sum += 3;
+                    else if (obj.name == "enemy") sum += 4;
+                    else if (obj.name == "door") sum += 5;
+                    else if (obj.name == "hurt") sum += 6;
+                    else if (obj.name == "chest") sum += 7;
+                }
+            }
+        }
+        bench::keep(sum);
+    }
+}
+
+BENCH(room_transition_spawnlist) {
+    const auto& f = fixture();
+    for (size_t i = 0; i < iterations; i++) {
+        size_t sum = 0;
+        for (const auto& list : f.lists) {
+            for (const SpawnEntry& entry : list.getEntries()) {
+                if (!entry.existsIn(ROOM_STATE)) continue;
+                if (entry.kind == SpawnKind::Wall) {
+                    sum += static_cast<size_t>(entry.bounds.width + entry.bounds.height);
+                    continue;
+                }
+                const SpawnOverrides& o = entry.overrides;
+                sum += entry.archetype;
+                sum += static_cast<size_t>((o.set & SpawnOverrides::SPEED) ? o.speed : 10.0f);
+                sum += o.damage;
+                sum += static_cast<size_t>(o.knockback);
+                sum += o.drawLayer;
+                sum += static_cast<size_t>(o.hurtbox.x + o.hurtbox.y);
+                sum += static_cast<size_t>(entry.kind);
+            }
+        }
+        bench::keep(sum);
+    }
+}
+
+// the one-time cost on the first visit
+BENCH(room_spawnlist_compile) {
+    const auto& f = fixture();
+    for (size_t i = 0; i < iterations; i++) {
+        size_t sum = 0;
+        for (const auto& room : f.rooms) {
+            SpawnList list(*room, f.archetypeIds, 0);
+            sum += list.size();
+        }
+        bench::keep(sum);
+    }
+}
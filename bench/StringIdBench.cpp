@@ -0,0 +1,41 @@
+#include "Bench.h"
+#include "StringId.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// a playSound("hurt1") style lookup: the map keyed by std::string (a temporary string is built, hashed and compared)
+// against the map keyed by StringId with the key hashed at compile time
+
+static const std::vector<std::string>& soundNames() {
+    static const std::vector<std::string> names = {
+        "hurt1", "slash", "heart", "rupee", "cash", "hammer", "gameover", "menuOpen", "menuClose",
+        "menuCursor", "menuSelect", "doorOpen_2", "bookPlace1", "Rise02", "Rise03", "creature_hurt_02",
+        "creature_die_01", "tone", "tone2", "tone3"
+    };
+    return names;
+}
+
+BENCH(lookup_string_key) {
+    static std::unordered_map<std::string, int> sounds;
+    if (sounds.empty()) {
+        for (size_t i = 0; i < soundNames().size(); ++i) sounds[soundNames()[i]] = static_cast<int>(i);
+    }
+    auto play = [](const std::string& key) { return sounds.at(key); };
+    for (size_t i = 0; i < iterations; i++) {
+        int sum = play("hurt1") + play("creature_hurt_02") + play("menuCursor") + play("slash");
+        bench::keep(sum);
+    }
+}
+
+BENCH(lookup_string_id) {
+    static std::unordered_map<StringId, int> sounds;
+    if (sounds.empty()) {
+        for (size_t i = 0; i < soundNames().size(); ++i) sounds[StringId::intern(soundNames()[i])] = static_cast<int>(i);
+    }
+    auto play = [](StringId key) { return sounds.at(key); };
+    for (size_t i = 0; i < iterations; i++) {
+        int sum = play("hurt1"_id) + play("creature_hurt_02"_id) + play("menuCursor"_id) + play("slash"_id);
+        bench::keep(sum);
+    }
+}
@@ -0,0 +1,121 @@
+#include "Bench.h"
+#include "BenchGame.h"
+#include "Game.h"
+#include "TextBox.h"
+#include "TextLayout.h"
+#include "raylib.h"
+#include "json.hpp"
+#include <fstream>
+#include <string>
+
+// layout time for long dialogue pages: the old TextBox::formatText algorithm
+// (MeasureText on the accumulated text for every word) against TextLayoutEngine
+
+static const Font& benchFont() {
+    // same settings as AssetLoader::LoadFont
+    static Font font = LoadFontEx("./resources/fonts/slkscr.ttf", 32, NULL, 0);
+    return font;
+}
+
+static std::string dialogueText(size_t length) {
+    // real dialogue lines, repeated until the page is long enough
+    static std::string all;
+    if (all.empty()) {
+        std::ifstream file("./resources/texts.json");
+        nlohmann::json j;
+        if (file) file >> j;
+        for (auto& [key, lines] : j.items()) {
+            for (auto& line : lines) {
+                std::string s = line.get<std::string>();
+                for (char& c : s) if (c == '\f') c = ' ';
+                all += s + " ";
+            }
+        }
+        if (all.empty()) all = "The quick brown fox jumps over the lazy dog. ";
+    }
+    std::string text;
+    while (text.size() < length) text += all;
+    text.resize(length);
+    return text;
+}
+
+static std::string legacyFormat(std::string_view text, int fontSize, float width) {
+    // copy of the old TextBox::formatText without the paging
+    std::string formattedtext;
+    size_t start = 0;
+    size_t spacePos = 0;
+    int currentLine = 0;
+    std::string line;
+    while ((spacePos = text.find(' ', start)) != std::string_view::npos) {
+        std::string_view word = text.substr(start, spacePos - start);
+        std::string testLine = line.empty() ? std::string(word) : line + " " + std::string(word);
+        if (MeasureText(testLine.c_str(), fontSize) > int(width) - 10) {
+            formattedtext += line + "\n";
+            currentLine++;
+            Vector2 size = MeasureTextEx(GetFontDefault(), formattedtext.c_str(), float(fontSize), 2.0f);
+            bench::keep(size);
+            line = std::string(word);
+        }
+        else {
+            line = testLine;
+        }
+        start = spacePos + 1;
+    }
+    formattedtext += line;
+    return formattedtext;
+}
+
+static void legacy(size_t iterations, size_t length) {
+    std::string text = dialogueText(length);
+    for (size_t i = 0; i < iterations; i++) {
+        std::string result = legacyFormat(text, 10, 230.0f);
+        bench::keep(result);
+    }
+}
+
+static void uncached(size_t iterations, size_t length) {
+    std::string text = dialogueText(length);
+    TextLayoutEngine engine;
+    for (size_t i = 0; i < iterations; i++) {
+        TextLayout layout = engine.build(text, benchFont(), 10.0f, 220.0f, 0.0f);
+        bench::keep(layout);
+    }
+}
+
+static void cached(size_t iterations, size_t length) {
+    // what a menu or text box pays per frame for unchanged text
+    std::string text = dialogueText(length);
+    TextLayoutEngine engine;
+    for (size_t i = 0; i < iterations; i++) {
+        auto layout = engine.layout(text, benchFont(), 10.0f, 220.0f, 0.0f);
+        bench::keep(layout);
+    }
+}
+
+BENCH(text_legacy_formatText_500) { legacy(iterations, 500); }
+BENCH(text_legacy_formatText_2000) { legacy(iterations, 2000); }
+BENCH(text_legacy_formatText_8000) { legacy(iterations, 8000); }
+BENCH(text_layout_build_500) { uncached(iterations, 500); }
+BENCH(text_layout_build_2000) { uncached(iterations, 2000); }
+BENCH(text_layout_build_8000) { uncached(iterations, 8000); }
+BENCH(text_layout_cached_500) { cached(iterations, 500); }
+BENCH(text_layout_cached_2000) { cached(iterations, 2000); }
+BENCH(text_layout_cached_8000) { cached(iterations, 8000); }
+
+// TextBox::setTextContent with the game's font and text box size (the first page of a dialogue of n characters),
+// the first time the page is shown (empty layout cache) and when it was shown before
+// (a new TextBox every time, formatText moves on to the next page when the text doesn't fit)
+static void textBox(size_t iterations, size_t length, bool clearCache) {
+    Game& game = bench::game();
+    std::string text = dialogueText(length);
+    float height = game.getSetting("textboxHeight").get<float>();
+    for (size_t i = 0; i < iterations; i++) {
+        if (clearCache) game.textLayout.clear();
+        TextBox box(game, 0.0f, 0.0f, static_cast<float>(game.gameScreenWidth), height, 10, "tone");
+        box.setTextContent(text);
+        bench::keep(box);
+    }
+}
+
+BENCH_SIZES(textbox_format, 64, 512, 4096) { textBox(iterations, size, true); }
+BENCH_SIZES(textbox_format_cached, 64, 512, 4096) { textBox(iterations, size, false); }
@@ -0,0 +1,197 @@
+#include "Bench.h"
+#include "TileMap.h"
+#include "raylib.h"
+#include "json.hpp"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// tile layer storage: the old vector<vector<int>> grid against TileLayer
+// (contiguous uint16_t, mostly empty layers as runs)
+// the map is test_map_big, the biggest one in the game
+
+using LegacyGrid = std::vector<std::vector<int>>;
+
+static nlohmann::json loadMapJson(const std::string& name) {
+    std::ifstream file("./resources/tilemaps/" + name + ".json");
+    nlohmann::json j;
+    if (file) file >> j;
+    return j;
+}
+
+static size_t legacyBytes(const LegacyGrid& grid) {
+    // the outer vector plus one heap block per row
+    size_t bytes = grid.capacity() * sizeof(std::vector<int>);
+    for (const auto& row : grid) bytes += row.capacity() * sizeof(int);
+    return bytes;
+}
+
+static void printMemory(const std::string& name) {
+    nlohmann::json j = loadMapJson(name);
+    if (j.is_null()) return;
+    TileMap map(j, name);
+    size_t legacyTotal = 0, total = 0;
+    for (const auto& layerJson : j["layers"]) {
+        if (layerJson["type"] != "tilelayer") continue;
+        LegacyGrid grid(layerJson["height"].get<int>(), std::vector<int>(layerJson["width"].get<int>()));
+        legacyTotal += legacyBytes(grid);
+    }
+    int sparseLayers = 0;
+    for (const auto& layer : map.layers) {
+        total += layer.memoryUsage();
+        if (layer.isSparse()) sparseLayers++;
+    }
+    std::printf("  %-24s %zu layers (%d sparse): %7zu bytes before, %7zu bytes now\n",
+        name.c_str(), map.layers.size(), sparseLayers, legacyTotal, total);
+}
+
+struct LayerFixture {
+    std::unique_ptr<TileMap> map;
+    std::vector<LegacyGrid> legacy;
+
+    LayerFixture() {
+        nlohmann::json j = loadMapJson("test_map_big");
+        if (j.is_null()) return;
+        map = std::make_unique<TileMap>(j, "test_map_big");
+        for (const auto& layerJson : j["layers"]) {
+            if (layerJson["type"] != "tilelayer") continue;
+            // what the old TileLayer constructor built
+            int w = layerJson["width"], h = layerJson["height"];
+            LegacyGrid grid(h, std::vector<int>(w));
+            const auto& flat = layerJson["data"];
+            for (int i = 0; i < w * h; ++i) grid[i / w][i % w] = flat[i];
+            legacy.push_back(std::move(grid));
+        }
+
+        std::printf("tile layer memory:\n");
+        for (const char* name : { "test_map_big", "test_map_small", "test_fields", "dungeon001", "dungeon_shop" }) {
+            printMemory(name);
+        }
+    }
+};
+
+static const LayerFixture& fixture() {
+    static LayerFixture f;
+    return f;
+}
+
+// the chunk baking loop in InGame::loadTilemap, 16x16 tiles per chunk, without the drawing
+static constexpr int CHUNK_TILES = 16;
+
+BENCH(tilelayer_bake_legacy) {
+    const auto& f = fixture();
+    for (size_t i = 0; i < iterations; i++) {
+        size_t sum = 0;
+        for (const auto& grid : f.legacy) {
+            size_t h = grid.size(), w = h ? grid[0].size() : 0;
+            for (size_t cy = 0; cy < h; cy += CHUNK_TILES) {
+                for (size_t cx = 0; cx < w; cx += CHUNK_TILES) {
+                    for (size_t y = cy; y < cy + CHUNK_TILES; ++y) {
+                        for (size_t x = cx; x < cx + CHUNK_TILES; ++x) {
+                            if (x >= w || y >= h) continue;
+                            if (!grid[y][x]) continue;
+                            sum += grid[y][x] + x + y;
+                        }
+                    }
+                }
+            }
+        }
+        bench::keep(sum);
+    }
+}
+
+BENCH(tilelayer_bake_flat) {
+    const auto& f = fixture();
+    if (!f.map) return;
+    for (size_t i = 0; i < iterations; i++) {
+        size_t sum = 0;
+        for (const auto& layer : f.map->layers) {
+            for (int cy = 0; cy < layer.height; cy += CHUNK_TILES) {
+                for (int cx = 0; cx < layer.width; cx += CHUNK_TILES) {
+                    layer.forEachTile(cx, cy, cx + CHUNK_TILES, cy + CHUNK_TILES, [&](int x, int y, uint16_t id) {
+                        sum += id + x + y;
+                        });
+                }
+            }
+        }
+        bench::keep(sum);
+    }
+}
+
+// random lookups, like collision checks or line of sight along a ray
+BENCH(tilelayer_lookup_legacy) {
+    const auto& f = fixture();
+    if (f.legacy.empty()) return;
+    const LegacyGrid& grid = f.legacy.back();
+    int w = static_cast<int>(grid[0].size()), h = static_cast<int>(grid.size());
+    for (size_t i = 0; i < iterations; i++) {
+        size_t sum = 0;
+        for (int step = 0; step < 4096; ++step) {
+            int x = (step * 7) % w, y = (step * 13) % h;
+            sum += grid[y][x];
+        }
+        bench::keep(sum);
+    }
+}
+
+BENCH(tilelayer_lookup_flat) {
+    const auto& f = fixture();
+    if (!f.map || f.map->layers.empty()) return;
+    const TileLayer& layer = f.map->layers.back();
+    for (size_t i = 0; i < iterations; i++) {
+        size_t sum = 0;
+        for (int step = 0; step < 4096; ++step) {
+            int x = (step * 7) % layer.width, y = (step * 13) % layer.height;
+            sum += layer.at(x, y);
+        }
+        bench::keep(sum);
+    }
+}
+
+// TileLayer construction for square layers of size x size tiles: from the Tiled JSON (what loading a map
+// does without the compiled .tmb) and from a tile vector (TileMapBinary), a ground layer that is all tiles
+// and a wall layer that is mostly empty (stored as runs)
+static nlohmann::json layerJson(int size, bool sparse) {
+    std::vector<uint32_t> data(static_cast<size_t>(size) * size);
+    for (size_t i = 0; i < data.size(); ++i) {
+        int x = static_cast<int>(i % size), y = static_cast<int>(i / size);
+        bool wall = x == 0 || y == 0 || x == size - 1 || y == size - 1 || (x % 16 == 0 && y % 4 != 0);
+        data[i] = sparse ? (wall ? 5 : 0) : static_cast<uint32_t>(1 + (x * 7 + y * 13) % 24);
+    }
+    return { { "name", sparse ? "walls" : "ground" }, { "width", size }, { "height", size }, { "visible", true }, { "data", data } };
+}
+
+BENCH_SIZES(tilelayer_json_dense, 32, 128, 512) {
+    static std::unordered_map<size_t, nlohmann::json> inputs;
+    auto& j = inputs[size];
+    if (j.is_null()) j = layerJson(static_cast<int>(size), false);
+    for (size_t i = 0; i < iterations; i++) {
+        TileLayer layer(j);
+        bench::keep(layer);
+    }
+}
+
+BENCH_SIZES(tilelayer_json_sparse, 32, 128, 512) {
+    static std::unordered_map<size_t, nlohmann::json> inputs;
+    auto& j = inputs[size];
+    if (j.is_null()) j = layerJson(static_cast<int>(size), true);
+    for (size_t i = 0; i < iterations; i++) {
+        TileLayer layer(j);
+        bench::keep(layer);
+    }
+}
+
+BENCH_SIZES(tilelayer_tiles_sparse, 32, 128, 512) {
+    static std::unordered_map<size_t, std::vector<uint16_t>> inputs;
+    auto& tiles = inputs[size];
+    if (tiles.empty()) {
+        for (uint32_t id : layerJson(static_cast<int>(size), true)["data"]) tiles.push_back(static_cast<uint16_t>(id));
+    }
+    for (size_t i = 0; i < iterations; i++) {
+        TileLayer layer("walls", static_cast<int>(size), static_cast<int>(size), tiles);
+        bench::keep(layer);
+    }
+}
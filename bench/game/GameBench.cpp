@@ -0,0 +1,545 @@
+#include "Game.h"
+#include "AllocTracker.h"
+#include "InGame.h"
+#include "Behavior.h"
+#include "Profiler.h"
+#include "Savegame.h"
+#include "ThreadPool.h"
+#include "json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+game_bench: stress scenarios on the headless game (build target: game_bench, see bench/game/scenarios.json)
+every scenario boots a new game, builds its situation in InGame and then runs a fixed number of frames
+with a fixed time step, the profiler zones of each frame are collected and written as mean/p50/p99/max ms,
+with the mean and max heap allocations per frame next to them (see AllocTracker.h)
+a scenario can have an "allocBudget": { "zone path": allocations } with the most allocations a zone may make
+in one measured frame, a scenario that goes over it fails (exit code 1), that's the check that keeps the loop
+from allocating again
+a zone only counts what its own thread allocates, the chunks that run on the job workers count under "job",
+and "total" is everything all threads allocated in the frame
+
+usage (from the project root, the game loads ./resources):
+  game_bench [scenarios.json] [-o results.json] [--only name] [--frames n]
+  game_bench --compare base.json new.json [--threshold percent] [--metric p50|mean|p99] [--min-ms ms]
+  game_bench --loader [runs]
+the comparison exits with 1 if a zone got slower than the threshold (and by more than --min-ms, which keeps
+zones that take a few microseconds from failing on noise)
+--loader times the loading screen with no worker threads and with the default number of them (median of runs)
+*/
+
+using json = nlohmann::json;
+
+namespace {
+    const uint32_t SEED = 1234;
+
+    struct Scenario {
+        std::function<void()> step; // runs at the start of every frame (inside the "frame" zone), can be empty
+    };
+
+    InGame& inGame(Game& game) {
+        return *static_cast<InGame*>(game.getScene("InGame"));
+    }
+
+    AllocCounts runFrame(Game& game, float deltaTime, const Scenario& scenario) {
+        // the order of Game::run, without pipelining (the update and the draw are measured one after the other)
+        // returns what all threads allocated in the frame, without the profiler's own bookkeeping in endFrame
+        AllocCounts before = AllocTracker::total();
+        {
+            PROFILE_ZONE("frame");
+            if (scenario.step) {
+                PROFILE_ZONE("scenario");
+                scenario.step();
+            }
+            game.update(deltaTime);
+            game.lateUpdate();
+            game.processMarkedSprites();
+            game.processMarkedScenes();
+            game.captureScenes();
+            game.draw();
+        }
+        AllocCounts allocated = AllocTracker::total() - before;
+        Profiler::get().endFrame();
+        return allocated;
+    }
+
+    bool boot(Game& game, float deltaTime) {
+        // Preload loads everything and starts InGame (launched with newGame)
+        game.startScene("Preload");
+        Scenario none;
+        for (int frame = 0; frame < 100000; ++frame) {
+            runFrame(game, deltaTime, none);
+            if (!game.getScene("Preload") && game.getScene("InGame") && game.getPlayer()) {
+                // a few more frames for the delayed startup events
+                for (int i = 0; i < 30; ++i) runFrame(game, deltaTime, none);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void enterMap(Game& game, const std::string& map, bool dark = false) {
+        // a dungeon with just this map, the player in the middle of it
+        game.currentDungeon = std::make_unique<Dungeon>(game, 1, 1);
+        Room room{ game.loader.getTilemap(map), 0b0000 };
+        room.dark = dark;
+        game.currentDungeon->insertRoom(0, 0, std::move(room));
+        game.currentDungeon->setStartingRoomIndex(0);
+        game.currentDungeon->setCurrentRoomIndex(0);
+        game.currentDungeon->makeMinimapTextures();
+        InGame& scene = inGame(game);
+        scene.loadTilemap();
+        const TileMap& tileMap = game.currentDungeon->getRooms()[0]->getTemplate();
+        game.getPlayer()->moveTo(tileMap.width * tileMap.tileWidth * 0.5f, tileMap.height * tileMap.tileHeight * 0.5f);
+        scene.camera.target = game.getPlayer()->position;
+    }
+
+    Vector2 ringPosition(Vector2 center, size_t index, size_t count, float radius) {
+        // the sprites start on a few rings around the player, so they don't all stand on top of each other
+        size_t ring = index % 4;
+        float angle = (float)index / (float)count * 2.0f * PI;
+        float r = radius * (1.0f + 0.25f * ring);
+        return { center.x + std::cos(angle) * r, center.y + std::sin(angle) * r };
+    }
+
+    std::shared_ptr<Sprite> spawnArchetype(Game& game, const std::string& key, Vector2 position) {
+        // what InGame::spawnObject does for an enemy, without the map object
+        const SpriteArchetype* archetype = game.loader.findArchetype(key);
+        if (!archetype) {
+            TraceLog(LOG_ERROR, "BENCH: No archetype %s", key.c_str());
+            return nullptr;
+        }
+        Vector2 hitbox = archetype->hasHitbox ? archetype->hitbox : Vector2{ 16.0f, 16.0f };
+        auto sprite = std::make_shared<Sprite>(game, position.x, position.y, hitbox.x, hitbox.y, archetype->name);
+        sprite->health = archetype->health;
+        sprite->damage = archetype->damage;
+        sprite->speed = archetype->speed;
+        sprite->knockback = archetype->knockback;
+        sprite->hitboxOffset = archetype->hitboxOffset;
+        sprite->frames = archetype->frames;
+        if (archetype->hasCollides) sprite->isColliding = archetype->collides;
+        sprite->canHurtPlayer = true;
+        sprite->isEnemy = true;
+        inGame(game).addBehaviorsToSprite(sprite, *archetype);
+        game.sprites.emplace_back(sprite);
+        return sprite;
+    }
+
+    Scenario setupChase(Game& game, const json& params) {
+        enterMap(game, params.value("map", "test_map_big"));
+        std::string key = params.value("archetype", "skelet");
+        size_t count = params.value("count", (size_t)100);
+        Vector2 center = game.getPlayer()->position;
+        for (size_t i = 0; i < count; ++i) {
+            spawnArchetype(game, key, ringPosition(center, i, count, params.value("radius", 96.0f)));
+        }
+        return {};
+    }
+
+    Scenario setupProjectiles(Game& game, const json& params) {
+        // turrets that only shoot, the projectiles and their trails are the load
+        enterMap(game, params.value("map", "test_map_big"));
+        size_t count = params.value("shooters", (size_t)32);
+        Vector2 center = game.getPlayer()->position;
+        auto player = inGame(game).player;
+        for (size_t i = 0; i < count; ++i) {
+            Vector2 position = ringPosition(center, i, count, params.value("radius", 80.0f));
+            auto turret = std::make_shared<Sprite>(game, position.x, position.y, 16.0f, 16.0f, "turret");
+            turret->isColliding = false;
+            shootingConfig conf; // the same as InGame::addBehaviorsToSprite
+            conf.projectileKey = "fireball";
+            conf.speed = 20.0f;
+            turret->addBehavior(std::make_unique<ShootBehavior>(game, turret, player, conf));
+            game.sprites.emplace_back(turret);
+        }
+        return {};
+    }
+
+    Scenario setupParticles(Game& game, const json& params) {
+        // emitters that are always full, the smoke preset with more particles
+        enterMap(game, params.value("map", "dungeon001"));
+        size_t emitters = params.value("emitters", (size_t)16);
+        size_t perEmitter = params.value("particlesPerEmitter", (size_t)64);
+        json presets = game.loader.decodeJson("./resources/particles.json");
+        float lifetime = presets["smokeParticle"].value("lifetime", 1.6f);
+        presets["benchEmitter"] = {
+            { "type", "emitter" },
+            { "inherits", "smoke" },
+            { "spawnInterval", lifetime / (float)perEmitter },
+            { "maxParticles", perEmitter },
+            { "budget", emitters * perEmitter }
+        };
+        game.particles.addPresets(presets, game.loader);
+        game.particles.setGlobalBudget(emitters * perEmitter);
+        Vector2 center = game.getPlayer()->position;
+        for (size_t i = 0; i < emitters; ++i) {
+            game.particles.spawn("benchEmitter", ringPosition(center, i, emitters, 48.0f));
+        }
+        return {};
+    }
+
+    Scenario setupDarkRoom(Game& game, const json& params) {
+        // sprites that carry a light and walk around, only the first MAX_LIGHTS of them get a light circle
+        enterMap(game, params.value("map", "dungeon005"), true);
+        size_t count = params.value("lights", (size_t)10);
+        Vector2 center = game.getPlayer()->position;
+        for (size_t i = 0; i < count; ++i) {
+            Vector2 position = ringPosition(center, i, count, 32.0f);
+            auto lamp = std::make_shared<Sprite>(game, position.x, position.y, 12.0f, 12.0f, "lamp");
+            lamp->emitsLight = true;
+            lamp->addBehavior(std::make_unique<RandomWalkBehavior>(lamp));
+            game.sprites.emplace_back(lamp);
+        }
+        return {};
+    }
+
+    Scenario setupRoomTransitions(Game& game, const json& params) {
+        // walks through every room of the new game's dungeon, one after the other
+        std::vector<size_t> rooms;
+        auto& all = game.currentDungeon->getRooms();
+        for (size_t i = 0; i < all.size(); ++i) {
+            if (all[i]) rooms.push_back(i);
+        }
+        size_t framesPerRoom = std::max(params.value("framesPerRoom", (size_t)2), (size_t)1);
+        auto frame = std::make_shared<size_t>(0);
+        return { [&game, rooms, framesPerRoom, frame]() {
+            if ((*frame)++ % framesPerRoom != 0 || rooms.empty()) return;
+            size_t next = rooms[(*frame / framesPerRoom) % rooms.size()];
+            game.currentDungeon->setCurrentRoomIndex(next);
+            inGame(game).loadTilemap();
+            game.getPlayer()->moveTo(7.5f * 16.0f, 8.0f * 16.0f);
+        } };
+    }
+
+    Scenario setupSaveLoad(Game& game, const json& params) {
+        // a dungeon full of rooms with edited tiles and object states, saved and loaded again every frame
+        size_t width = params.value("width", (size_t)16);
+        size_t height = params.value("height", (size_t)16);
+        size_t edits = params.value("editsPerRoom", (size_t)32);
+        const char* templates[] = { "dungeon001", "dungeon002", "dungeon003", "dungeon004", "dungeon005", "dungeon006" };
+        auto dungeon = std::make_shared<std::unique_ptr<Dungeon>>(std::make_unique<Dungeon>(game, width, height));
+        for (size_t i = 0; i < width * height; ++i) {
+            Room room{ game.loader.getTilemap(templates[i % 6]), static_cast<uint8_t>(i % 16) };
+            room.visited = i % 3 == 0;
+            room.dark = i % 7 == 0;
+            const TileMap& map = room.getTemplate();
+            for (size_t e = 0; e < edits; ++e) {
+                room.setTile(0, GetRandomValue(0, (int)map.width - 1), GetRandomValue(0, (int)map.height - 1), (uint16_t)GetRandomValue(1, 64));
+                room.objectStates[(uint32_t)e] = ObjectState{ e % 2 == 0, e % 3 == 0, e % 4 };
+            }
+            (*dungeon)->insertRoom(i / width, i % width, std::move(room));
+        }
+        (*dungeon)->makeMinimapTextures();
+        return { [&game, dungeon]() {
+            SaveGame save;
+            {
+                PROFILE_ZONE("save");
+                saveDungeon(save, **dungeon);
+            }
+            std::string text;
+            {
+                PROFILE_ZONE("write json");
+                text = writeDataToJSON(save).dump(2);
+            }
+            SaveGame loaded;
+            {
+                PROFILE_ZONE("read json");
+                loaded = readSaveDataFromJSON(json::parse(text));
+            }
+            PROFILE_ZONE("load");
+            *dungeon = loadDungeon(loaded, game);
+        } };
+    }
+
+    const std::map<std::string, std::function<Scenario(Game&, const json&)>> SCENARIOS = {
+        { "chase", setupChase },
+        { "projectiles", setupProjectiles },
+        { "particles", setupParticles },
+        { "dark_room", setupDarkRoom },
+        { "room_transitions", setupRoomTransitions },
+        { "save_load", setupSaveLoad }
+    };
+
+    struct ZoneFrames {
+        std::vector<float> ms;
+        std::vector<uint64_t> allocations;
+        std::vector<uint64_t> bytes;
+
+        void resize(size_t frames) {
+            // zones that don't run in a frame count as 0 ms and 0 allocations in that frame
+            ms.resize(frames, 0.0f);
+            allocations.resize(frames, 0);
+            bytes.resize(frames, 0);
+        }
+    };
+
+    json allocStats(const ZoneFrames& zone) {
+        return {
+            { "mean", (double)std::accumulate(zone.allocations.begin(), zone.allocations.end(), (uint64_t)0) / zone.allocations.size() },
+            { "max", *std::max_element(zone.allocations.begin(), zone.allocations.end()) },
+            { "bytesMean", (double)std::accumulate(zone.bytes.begin(), zone.bytes.end(), (uint64_t)0) / zone.bytes.size() }
+        };
+    }
+
+    json zoneStats(ZoneFrames& zone) {
+        std::vector<float>& values = zone.ms;
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (float v : values) sum += v;
+        // nearest rank, like the profiler overlay
+        auto percentile = [&values](double p) { return values[(size_t)std::ceil(values.size() * p) - 1]; };
+        return {
+            { "mean", sum / values.size() },
+            { "p50", percentile(0.50) },
+            { "p99", percentile(0.99) },
+            { "max", values.back() },
+            { "allocs", allocStats(zone) }
+        };
+    }
+
+    bool checkAllocBudget(const std::string& name, const json& params, const json& result) {
+        // the zone path (or "total") and the most allocations it may make in a frame, a zone that never ran made none
+        bool ok = true;
+        const json& zones = result["zones"];
+        json budgets = params.value("allocBudget", json::object());
+        for (auto& [path, budget] : budgets.items()) {
+            uint64_t most = 0;
+            if (path == "total") most = result["allocs"].value("max", (uint64_t)0);
+            else if (zones.contains(path)) most = zones[path]["allocs"].value("max", (uint64_t)0);
+            if (most <= budget.get<uint64_t>()) continue;
+            std::printf("ALLOC BUDGET %s: %s made %llu allocations in a frame, the budget is %llu\n", name.c_str(), path.c_str(),
+                (unsigned long long)most, (unsigned long long)budget.get<uint64_t>());
+            ok = false;
+        }
+        return ok;
+    }
+
+    bool runScenario(const json& params, size_t warmupFrames, size_t frames, json& result) {
+        std::string name = params.value("name", "");
+        std::string type = params.value("type", "");
+        auto setup = SCENARIOS.find(type);
+        if (setup == SCENARIOS.end()) {
+            TraceLog(LOG_ERROR, "BENCH: %s has an unknown type \"%s\"", name.c_str(), type.c_str());
+            return false;
+        }
+        LaunchOptions options;
+        options.headless = true;
+        options.newGame = true;
+        Game game(options);
+        float deltaTime = 1.0f / game.getSetting("targetFPS").get<float>();
+        if (!boot(game, deltaTime)) {
+            TraceLog(LOG_ERROR, "BENCH: %s: the game didn't finish loading", name.c_str());
+            return false;
+        }
+        SetRandomSeed(SEED);
+        srand(SEED);
+        game.particles.setSeed(SEED);
+        Scenario scenario = setup->second(game, params);
+
+        std::map<std::string, ZoneFrames> zones;
+        ZoneFrames total; // all threads, only the allocations are used
+        for (size_t frame = 0; frame < warmupFrames + frames; ++frame) {
+            // the player can't get hurt, so it doesn't die or get knocked out of the room
+            game.getPlayer()->iFrameTimer = 1.0f;
+            AllocCounts allocated = runFrame(game, deltaTime, scenario);
+            if (frame < warmupFrames) continue;
+            total.allocations.push_back(allocated.allocations);
+            total.bytes.push_back(allocated.bytes);
+            size_t measured = frame - warmupFrames;
+            for (const Profiler::ZoneTime& zone : Profiler::get().lastFrame()) {
+                ZoneFrames& values = zones[zone.path];
+                values.resize(measured);
+                values.ms.push_back(zone.ms);
+                values.allocations.push_back(zone.allocations);
+                values.bytes.push_back(zone.bytes);
+            }
+        }
+
+        result = { { "type", type }, { "params", params }, { "frames", frames }, { "sprites", game.sprites.size() },
+            { "particles", game.particles.getStats().liveParticles }, { "allocs", allocStats(total) }, { "zones", json::object() } };
+        for (auto& [path, values] : zones) {
+            values.resize(frames);
+            result["zones"][path] = zoneStats(values);
+        }
+        const json& frame = result["zones"]["frame"];
+        std::printf("%-24s frame ms: mean %7.3f  p50 %7.3f  p99 %7.3f  allocs %8.1f  (%zu sprites, %zu particles)\n", name.c_str(),
+            frame.value("mean", 0.0), frame.value("p50", 0.0), frame.value("p99", 0.0), frame["allocs"].value("mean", 0.0),
+            game.sprites.size(), game.particles.getStats().liveParticles);
+        std::fflush(stdout);
+        // what Game::run does when the loop ends
+        UnloadRenderTexture(game.target);
+        CloseWindow();
+        return true;
+    }
+
+    double measureLoading(int threads) {
+        // wall time from starting Preload until the game is running, with all the frames in between
+        LaunchOptions options;
+        options.headless = true;
+        options.newGame = true;
+        options.loaderThreads = threads;
+        Game game(options);
+        float deltaTime = 1.0f / game.getSetting("targetFPS").get<float>();
+        Scenario none;
+        auto start = std::chrono::steady_clock::now();
+        game.startScene("Preload");
+        while (game.getScene("Preload") || !game.getPlayer()) {
+            runFrame(game, deltaTime, none);
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        UnloadRenderTexture(game.target);
+        CloseWindow();
+        return ms;
+    }
+
+    int compareLoading(size_t runs) {
+        size_t workers = ThreadPool::defaultThreadCount();
+        measureLoading(0); // so the files are in the OS cache for both
+        std::vector<double> sequential, parallel;
+        // alternating, so both get the same conditions
+        for (size_t i = 0; i < runs; ++i) {
+            sequential.push_back(measureLoading(0));
+            parallel.push_back(measureLoading(static_cast<int>(workers)));
+        }
+        std::sort(sequential.begin(), sequential.end());
+        std::sort(parallel.begin(), parallel.end());
+        double sequentialMs = sequential[runs / 2];
+        double parallelMs = parallel[runs / 2];
+        std::printf("loading, %zu runs each (median, min - max):\n", runs);
+        std::printf("  sequential:          %8.1f ms (%.1f - %.1f)\n", sequentialMs, sequential.front(), sequential.back());
+        std::printf("  %2zu worker threads:   %8.1f ms (%.1f - %.1f)\n", workers, parallelMs, parallel.front(), parallel.back());
+        std::printf("  measured speedup %.2fx (%u hardware threads)\n", sequentialMs / parallelMs, std::thread::hardware_concurrency());
+        return 0;
+    }
+
+    bool readJson(const std::string& path, json& out) {
+        std::ifstream file(path);
+        if (!file) {
+            TraceLog(LOG_ERROR, "BENCH: Can't open %s", path.c_str());
+            return false;
+        }
+        try {
+            file >> out;
+        }
+        catch (const json::exception& e) {
+            TraceLog(LOG_ERROR, "BENCH: %s isn't valid JSON: %s", path.c_str(), e.what());
+            return false;
+        }
+        return true;
+    }
+
+    int run(const std::string& scenariosPath, const std::string& outputPath, const std::string& only, size_t framesOverride) {
+        json config;
+        if (!readJson(scenariosPath, config)) return 2;
+        size_t warmupFrames = config.value("warmupFrames", (size_t)60);
+        json results = {
+#ifdef NDEBUG
+            { "build", "release" },
+#else
+            { "build", "debug" },
+#endif
+            { "scenarios", json::object() }
+        };
+        int failed = 0;
+        for (const json& params : config["scenarios"]) {
+            std::string name = params.value("name", "");
+            if (!only.empty() && name != only) continue;
+            size_t frames = framesOverride ? framesOverride : params.value("frames", config.value("frames", (size_t)600));
+            json result;
+            if (!runScenario(params, warmupFrames, frames, result)) {
+                failed++;
+                continue;
+            }
+            results["scenarios"][name] = result;
+            if (!checkAllocBudget(name, params, result)) failed++;
+        }
+        std::ofstream out(outputPath);
+        out << results.dump(2) << "\n";
+        if (!out) {
+            TraceLog(LOG_ERROR, "BENCH: Can't write %s", outputPath.c_str());
+            return 2;
+        }
+        std::printf("wrote %zu scenarios to %s\n", results["scenarios"].size(), outputPath.c_str());
+        return failed ? 1 : 0;
+    }
+
+    int compare(const std::string& basePath, const std::string& newPath, double threshold, const std::string& metric, double minMs) {
+        json base, current;
+        if (!readJson(basePath, base) || !readJson(newPath, current)) return 2;
+        if (base.value("build", "") != current.value("build", "")) {
+            std::printf("warning: comparing a %s build with a %s build\n", base.value("build", "?").c_str(), current.value("build", "?").c_str());
+        }
+        size_t regressions = 0;
+        size_t compared = 0;
+        for (auto& [name, oldResult] : base["scenarios"].items()) {
+            if (!current["scenarios"].contains(name)) {
+                std::printf("%s: missing in %s\n", name.c_str(), newPath.c_str());
+                continue;
+            }
+            const json& newZones = current["scenarios"][name]["zones"];
+            for (auto& [path, oldStats] : oldResult["zones"].items()) {
+                if (!newZones.contains(path)) continue;
+                double before = oldStats.value(metric, 0.0);
+                double after = newZones[path].value(metric, 0.0);
+                double change = before > 0.0 ? (after - before) / before * 100.0 : 0.0;
+                compared++;
+                if (std::fabs(after - before) < minMs || std::fabs(change) < threshold) continue;
+                bool slower = after > before;
+                if (slower) regressions++;
+                std::printf("%-8s %s: %s %s %.3f -> %.3f ms (%+.1f%%)\n", slower ? "SLOWER" : "faster",
+                    name.c_str(), path.c_str(), metric.c_str(), before, after, change);
+            }
+        }
+        std::printf("%zu zones compared, %zu slower than %.1f%% (%s)\n", compared, regressions, threshold, metric.c_str());
+        return regressions ? 1 : 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    SetTraceLogLevel(LOG_WARNING);
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (!args.empty() && args[0] == "--compare") {
+        if (args.size() < 3) {
+            std::printf("usage: game_bench --compare base.json new.json [--threshold percent] [--metric p50|mean|p99] [--min-ms ms]\n");
+            return 2;
+        }
+        double threshold = 10.0;
+        std::string metric = "p50";
+        double minMs = 0.05;
+        for (size_t i = 3; i + 1 < args.size(); i += 2) {
+            if (args[i] == "--threshold") threshold = std::atof(args[i + 1].c_str());
+            else if (args[i] == "--metric") metric = args[i + 1];
+            else if (args[i] == "--min-ms") minMs = std::atof(args[i + 1].c_str());
+        }
+        return compare(args[1], args[2], threshold, metric, minMs);
+    }
+
+    if (!args.empty() && args[0] == "--loader") {
+        size_t runs = args.size() > 1 ? std::strtoul(args[1].c_str(), nullptr, 10) : 5;
+        return compareLoading(std::max<size_t>(runs, 1));
+    }
+
+    std::string scenariosPath = "./bench/game/scenarios.json";
+    std::string outputPath = "./bench_results.json";
+    std::string only;
+    size_t frames = 0;
+    for (size_t i = 0; i < args.size(); ++i) {
+        bool hasValue = i + 1 < args.size();
+        if (args[i] == "-o" && hasValue) outputPath = args[++i];
+        else if (args[i] == "--only" && hasValue) only = args[++i];
+        else if (args[i] == "--frames" && hasValue) frames = std::strtoul(args[++i].c_str(), nullptr, 10);
+        else scenariosPath = args[i];
+    }
+    return run(scenariosPath, outputPath, only, frames);
+}
@@ -0,0 +1,14 @@
+#include "Bench.h"
+#include "BenchGame.h"
+#include "raylib.h"
+#include <string>
+
+// usage: microbench [filter]
+// run it from the project root, some benchmarks load files from ./resources
+int main(int argc, char** argv) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    SetTraceLogLevel(LOG_WARNING);
+    // fonts and textures need a GL context, the game opens a hidden window for it (and closes it again on exit)
+    bench::game();
+    return bench::runAll(filter);
+}
@@ -0,0 +1,104 @@
+#include "AllocTracker.h"
+
+#ifdef GAME_ALLOC_TRACKING
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// the replacements of the global operator new and delete, all of them go through allocate/deallocate
+// nothing in here may allocate with new itself
+
+namespace {
+    // constant-initialized, so they work before main and on threads the game didn't start
+    thread_local AllocCounts threadCounts;
+    std::atomic<uint64_t> totalAllocations{ 0 };
+    std::atomic<uint64_t> totalBytes{ 0 };
+
+    void count(std::size_t size) {
+        threadCounts.allocations++;
+        threadCounts.bytes += size;
+        totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        totalBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void* tryAllocate(std::size_t size, std::size_t alignment) {
+        if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        void* p = nullptr;
+        return posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+#endif
+    }
+
+    // nullptr if it failed and there's no new_handler to free something
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        count(size);
+        if (size == 0) size = 1; // new has to return a unique pointer
+        while (true) {
+            if (void* p = tryAllocate(size, alignment)) return p;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) return nullptr;
+            handler(); // throws bad_alloc if it can't help
+        }
+    }
+
+    void deallocate(void* p, std::size_t alignment = alignof(std::max_align_t)) {
+#ifdef _WIN32
+        if (alignment > alignof(std::max_align_t)) {
+            _aligned_free(p);
+            return;
+        }
+#else
+        (void)alignment;
+#endif
+        std::free(p);
+    }
+
+    void* allocateOrThrow(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        if (void* p = allocate(size, alignment)) return p;
+        throw std::bad_alloc();
+    }
+
+    void* allocateNoThrow(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) noexcept {
+        try {
+            return allocate(size, alignment);
+        }
+        catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+    }
+}
+
+AllocCounts AllocTracker::thread() {
+    return threadCounts;
+}
+
+AllocCounts AllocTracker::total() {
+    return { totalAllocations.load(std::memory_order_relaxed), totalBytes.load(std::memory_order_relaxed) };
+}
+
+void* operator new(std::size_t size) { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateNoThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateNoThrow(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* p) noexcept { deallocate(p); }
+void operator delete[](void* p) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept { deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(p, static_cast<std::size_t>(alignment)); }
+
+#endif
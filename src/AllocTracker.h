@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+/*
+Heap allocation counters: with GAME_ALLOC_TRACKING (CMake option) the global operator new is replaced by
+one that counts every allocation and its size, for each thread and for the whole program
+
+the profiler zones are the subsystem tags: every zone also records the allocations its thread made while
+it was open, the overlay shows them per frame next to the times, and game_bench has budgets for them
+AllocScope counts the allocations of the current thread while it exists, for a check around a single call:
+    AllocScope scope;
+    scene->update(deltaTime);
+    if (scope.counts().allocations > 0) ...
+without GAME_ALLOC_TRACKING nothing is replaced and everything reads 0 (AllocTracker::enabled is false)
+*/
+
+struct AllocCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0; // requested, not what malloc actually used
+
+    AllocCounts operator-(const AllocCounts& other) const { return { allocations - other.allocations, bytes - other.bytes }; }
+};
+
+namespace AllocTracker {
+#ifdef GAME_ALLOC_TRACKING
+    constexpr bool enabled = true;
+    AllocCounts thread(); // this thread since it started
+    AllocCounts total(); // all threads since the program started
+#else
+    constexpr bool enabled = false;
+    inline AllocCounts thread() { return {}; }
+    inline AllocCounts total() { return {}; }
+#endif
+}
+
+class AllocScope {
+public:
+    AllocScope() : start(AllocTracker::thread()) {}
+    AllocCounts counts() const { return AllocTracker::thread() - start; }
+
+private:
+    AllocCounts start;
+};
@@ -0,0 +1,97 @@
+#include "AssetArchive.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+
+template <typename T>
+static bool readValue(const unsigned char*& cursor, const unsigned char* end, T& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(T)) return false;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+bool AssetArchive::open(const std::string& filename) {
+    entries.clear();
+    if (!file.open(filename)) return false;
+
+    const unsigned char* begin = file.data();
+    const unsigned char* end = begin + file.size();
+    const unsigned char* cursor = begin;
+
+    ArchiveHeader header;
+    if (!readValue(cursor, end, header) || std::memcmp(header.magic, ARCHIVE_MAGIC, 4) != 0) {
+        TraceLog(LOG_ERROR, "ARCHIVE: %s is not an asset archive", filename.c_str());
+        file.close();
+        return false;
+    }
+    if (header.version != ARCHIVE_VERSION) {
+        TraceLog(LOG_ERROR, "ARCHIVE: %s has version %u, expected %u", filename.c_str(), header.version, ARCHIVE_VERSION);
+        file.close();
+        return false;
+    }
+
+    // the count isn't trusted until the entries were read, there can't be more of them than fit into the rest of the file
+    constexpr size_t minEntrySize = sizeof(uint64_t) * 3 + sizeof(uint32_t) * 2; // offset, sizes, flags, path length
+    entries.reserve(std::min<size_t>(header.entryCount, static_cast<size_t>(end - cursor) / minEntrySize));
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        ArchiveEntry entry;
+        uint32_t pathLength = 0;
+        bool ok = readValue(cursor, end, entry.offset) && readValue(cursor, end, entry.size)
+            && readValue(cursor, end, entry.rawSize) && readValue(cursor, end, entry.flags)
+            && readValue(cursor, end, pathLength)
+            && static_cast<size_t>(end - cursor) >= pathLength
+            && entry.offset <= file.size() && entry.size <= file.size() - entry.offset; // (offset + size could wrap)
+        if (!ok) {
+            TraceLog(LOG_ERROR, "ARCHIVE: %s is truncated or corrupt (entry %u)", filename.c_str(), i);
+            entries.clear();
+            file.close();
+            return false;
+        }
+        entries.emplace(std::string(reinterpret_cast<const char*>(cursor), pathLength), entry);
+        cursor += pathLength;
+    }
+
+    TraceLog(LOG_INFO, "ARCHIVE: mounted %s (%zu files, %zu bytes)", filename.c_str(), entries.size(), file.size());
+    return true;
+}
+
+bool AssetArchive::contains(const std::string& path) const {
+    return entries.find(normalizePath(path)) != entries.end();
+}
+
+AssetBlob AssetArchive::read(const std::string& path) const {
+    AssetBlob blob;
+    if (!isOpen()) return blob;
+    auto it = entries.find(normalizePath(path));
+    if (it == entries.end()) return blob;
+
+    const ArchiveEntry& entry = it->second;
+    const unsigned char* stored = file.data() + entry.offset;
+    if (!(entry.flags & ARCHIVE_FLAG_COMPRESSED)) {
+        blob.data = stored;
+        blob.size = static_cast<size_t>(entry.size);
+        return blob;
+    }
+
+    int rawSize = 0;
+    unsigned char* raw = DecompressData(stored, static_cast<int>(entry.size), &rawSize);
+    if (!raw || static_cast<uint64_t>(rawSize) != entry.rawSize) {
+        TraceLog(LOG_ERROR, "ARCHIVE: failed to decompress %s", path.c_str());
+        if (raw) MemFree(raw);
+        return blob;
+    }
+    // the blob keeps raylib's buffer, no second copy
+    blob.data = raw;
+    blob.size = static_cast<size_t>(rawSize);
+    blob.owner = std::shared_ptr<const void>(raw, [](const void* p) { MemFree(const_cast<void*>(p)); });
+    return blob;
+}
+
+std::string AssetArchive::normalizePath(const std::string& path) {
+    std::string normal = std::filesystem::path(path).lexically_normal().generic_string();
+    if (normal.rfind("./", 0) == 0) normal.erase(0, 2);
+    return normal;
+}
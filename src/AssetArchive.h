@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <memory>
+#include "MappedFile.h"
+
+/*
+Packed asset archive (built by tools/asset_packer.cpp)
+
+layout (little endian):
+    header      magic "GPAK", version, entry count, size of the table of contents
+    toc         per entry: offset, stored size, raw size, flags, path length, path (no terminator)
+    blobs       the file contents, each one starts at a multiple of ARCHIVE_ALIGNMENT
+
+paths are stored like the game uses them, relative to the working directory ("resources/textures/...")
+*/
+
+constexpr char ARCHIVE_MAGIC[4] = { 'G', 'P', 'A', 'K' };
+constexpr uint32_t ARCHIVE_VERSION = 1;
+constexpr uint64_t ARCHIVE_ALIGNMENT = 16;
+constexpr uint32_t ARCHIVE_FLAG_COMPRESSED = 1; // DEFLATE, via raylib's CompressData
+
+struct ArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t tocSize;
+};
+
+struct ArchiveEntry {
+    uint64_t offset = 0; // from the start of the file
+    uint64_t size = 0; // size in the archive
+    uint64_t rawSize = 0; // size after decompression
+    uint32_t flags = 0;
+};
+
+struct AssetBlob {
+    // points into the mapped archive, or into the memory owner keeps alive
+    // (raylib's buffer for a compressed entry, a loose file that was mapped on its own)
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    std::shared_ptr<const void> owner;
+
+    AssetBlob() = default;
+    AssetBlob(AssetBlob&&) = default;
+    AssetBlob& operator=(AssetBlob&&) = default;
+    AssetBlob(const AssetBlob&) = delete; // one owner per blob, share the blob instead
+    explicit operator bool() const { return data != nullptr; }
+};
+
+class AssetArchive {
+public:
+    bool open(const std::string& filename);
+    bool isOpen() const { return file.isOpen(); }
+    bool contains(const std::string& path) const;
+    // no copy for stored entries, the data stays valid as long as the archive is open
+    // safe to call from several threads
+    AssetBlob read(const std::string& path) const;
+    size_t entryCount() const { return entries.size(); }
+
+    static std::string normalizePath(const std::string& path); // "./resources/a/../b.png" -> "resources/b.png"
+
+private:
+    MappedFile file;
+    std::unordered_map<std::string, ArchiveEntry> entries;
+};
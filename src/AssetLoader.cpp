@@ -1,7 +1,9 @@
 #include "AssetLoader.h"
 #include <iostream>
 #include <fstream>
+#include <unordered_set>
 #include "Utils.h"
+#include "TileMapBinary.h"
 
 
 nlohmann::json resolveInheritance(const std::unordered_map<std::string, nlohmann::json>& allData, const std::string& key, std::unordered_map<std::string, bool>& visited)
@@ -55,6 +57,39 @@ AssetLoader::~AssetLoader() {
     }
 }
 
+bool AssetLoader::mountArchive(const std::string& filename) {
+    if (!archive.open(filename)) {
+        TraceLog(LOG_INFO, "ARCHIVE: %s not found, loading loose files", filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+AssetBlob AssetLoader::readAsset(const std::string& filename) const {
+    return archive.read(filename);
+}
+
+AssetBlob AssetLoader::readCompiled(const std::string& source, const char* extension) const {
+    std::string compiledName = fs::path(source).replace_extension(extension).string();
+    if (AssetBlob blob = readAsset(compiledName)) return blob;
+
+    // loose file, only if it's not older than the source (so editing a map in Tiled just works)
+    std::error_code error;
+    auto compiledTime = fs::last_write_time(compiledName, error);
+    if (error) return AssetBlob();
+    auto sourceTime = fs::last_write_time(source, error);
+    if (!error && sourceTime > compiledTime) return AssetBlob();
+
+    // mapped, the loader reads the tiles straight from it
+    auto mapped = std::make_shared<MappedFile>();
+    if (!mapped->open(compiledName)) return AssetBlob();
+    AssetBlob blob;
+    blob.data = mapped->data();
+    blob.size = mapped->size();
+    blob.owner = std::move(mapped);
+    return blob;
+}
+
 void AssetLoader::loadTexturesFromDirectory(const std::string& directory) {
     // Looks for png files in a given directory that match the pattern key_n.png
     // and automatically groups and loads them
@@ -66,7 +101,7 @@ void AssetLoader::loadTexturesFromDirectory(const std::string& directory) {
             size_t pos = filename.find('_');
             if (pos != std::string::npos) {
                 std::string key = filename.substr(0, pos);
-                textureGroups[key].push_back(LoadTexture(entry.path().string().c_str()));
+                textureGroups[StringId::intern(key)].push_back(LoadTexture(entry.path().string().c_str()));
             }
         }
     }
@@ -80,44 +115,60 @@ void AssetLoader::loadTextures(const std::unordered_map<std::string, std::vector
         {"player_run", {"assets/player_run_1.png", "assets/player_run_2.png", "assets/player_run_3.png"}}
     });
     */
-    namespace fs = std::filesystem;
-
     for (const auto& pair : textureMap) {
         const std::string& key = pair.first;
         for (const std::string& filename : pair.second) {
-            // TODO: maybe raylib does check this internally?
-            if (fs::exists(filename)) {
-                textureGroups[key].push_back(LoadTexture(filename.c_str()));
-            }
-            else {
-                TraceLog(LOG_ERROR, "ERROR: File not found:  %s", filename.c_str());
-            }
+            Image image = decodeImage(filename);
+            addTexture(key, image);
         }
     }
 }
 
 void AssetLoader::loadSpritesheet(const std::string& filename, int frameWidth, int frameHeight, const std::string& key) {
-    namespace fs = std::filesystem;
-    if (!fs::exists(filename)) {
+    std::string id = key.empty() ? keyFromFilename(filename) : key;
+    for (Image& frame : decodeSpritesheet(filename, frameWidth, frameHeight)) {
+        addTexture(id, frame);
+    }
+}
+
+Image AssetLoader::decodeImage(const std::string& filename) const {
+    Image image = { 0 };
+    if (AssetBlob blob = readAsset(filename)) {
+        image = LoadImageFromMemory(GetFileExtension(filename.c_str()), blob.data, static_cast<int>(blob.size));
+    }
+    else {
+        image = LoadImage(filename.c_str());
+    }
+    if (!image.data) {
         TraceLog(LOG_ERROR, "ERROR: File not found:  %s", filename.c_str());
-        return;
     }
-    std::string id = key.empty() ? fs::path(filename).stem().string() : key;
-    Texture2D sheet = LoadTexture(filename.c_str());
+    return image;
+}
+
+std::vector<Image> AssetLoader::decodeSpritesheet(const std::string& filename, int frameWidth, int frameHeight) const {
+    // cuts the sheet into frames on the CPU (left to right, top to bottom)
+    std::vector<Image> frames;
+    Image sheet = decodeImage(filename);
+    if (!sheet.data) return frames;
     int columns = sheet.width / frameWidth;
     int rows = sheet.height / frameHeight;
+    frames.reserve(static_cast<size_t>(columns) * rows);
     for (int y = 0; y < rows; ++y) {
         for (int x = 0; x < columns; ++x) {
-            Image subImage = LoadImageFromTexture(sheet);
             Rectangle src = { (float)(x * frameWidth), (float)(y * frameHeight), (float)frameWidth, (float)frameHeight };
-            ImageCrop(&subImage, src);
-            textureGroups[id].push_back(LoadTextureFromImage(subImage));
-            UnloadImage(subImage);
+            frames.push_back(ImageFromImage(sheet, src));
         }
     }
-    UnloadTexture(sheet);
+    UnloadImage(sheet);
+    return frames;
 }
 
+void AssetLoader::addTexture(const std::string& key, Image& image) {
+    if (!image.data) return;
+    textureGroups[StringId::intern(key)].push_back(LoadTextureFromImage(image));
+    UnloadImage(image);
+    image = { 0 };
+}
 
 void AssetLoader::Loadtileset(const std::string& filename, int tileSize) {
     // Loads the tiles directly from an image, give the correct tile size
@@ -142,67 +193,118 @@ void AssetLoader::Loadtileset(const std::string& filename, int tileSize) {
 
     UnloadImage(tilesetImg);
     std::string baseName = std::filesystem::path(filename).stem().string();
-    textureGroups[baseName] = tiles;
+    textureGroups[StringId::intern(baseName)] = tiles;
     TraceLog(LOG_INFO, "Tileset loaded successfully: %s", baseName.c_str());
 }
 
 void AssetLoader::LoadtilesetFromTiled(const std::string& filename) {
     // loads a Tiled tileset file (.json or .tsj)
-    std::ifstream file(filename); // Open JSON file
-    if (!file) {
-        TraceLog(LOG_ERROR, "Failed to open tileset file %s", filename.c_str());
-        return;
-    }
-    nlohmann::json j;
-    file >> j; // construct a json-like object from the file data
+    Image image = { 0 };
+    Tileset tileset = decodeTileset(filename, image);
+    if (!image.data) return;
+    addTileset(keyFromFilename(filename), std::move(tileset), image);
+}
 
-    if (!j.contains("image") || !j.contains("tilewidth")) {
-        TraceLog(LOG_ERROR, "Invalid tileset format: missing 'image' or 'tilewidth'.");
-        return;
+Tileset AssetLoader::decodeTileset(const std::string& filename, Image& image) const {
+    Tileset tileset;
+    std::string imageFile;
+    AssetBlob compiled = readCompiled(filename, ".tsb");
+    if (!compiled || !loadCompiledTileset(compiled.data, compiled.size, tileset, imageFile)) {
+        nlohmann::json j = decodeJson(filename);
+        if (!j.contains("image") || !j.contains("tilewidth")) {
+            TraceLog(LOG_ERROR, "Invalid tileset format: missing 'image' or 'tilewidth'.");
+            return Tileset();
+        }
+        imageFile = j["image"];
+        // construct the Tileset object
+        tileset = Tileset(j);
     }
 
-    std::string imageFile = j["image"];
-
     // Resolve relative to the .tsj file directory
     std::filesystem::path tilesetDir = std::filesystem::path(filename).parent_path();
     std::filesystem::path fullImagePath = tilesetDir / imageFile;
     fullImagePath = fullImagePath.lexically_normal(); // Clean up '..' parts
 
-    std::string baseName = std::filesystem::path(filename).stem().string();
-    textureGroups.emplace(baseName, std::vector<Texture2D>{ LoadTexture(fullImagePath.string().c_str()) });
-    // construct the Tileset object
-    tilesets.emplace(baseName, Tileset(j));
+    // keep the image on the CPU until the tile colours are computed (and for the upload)
+    image = decodeImage(fullImagePath.string());
+    tileset.computeTileColors(image);
+    return tileset;
+}
+
+void AssetLoader::addTileset(const std::string& key, Tileset&& tileset, Image& image) {
+    StringId id = StringId::intern(key);
+    textureGroups.emplace(id, std::vector<Texture2D>{ LoadTextureFromImage(image) });
+    UnloadImage(image);
+    image = { 0 };
+    tilesets.emplace(id, std::move(tileset));
 }
 
 void AssetLoader::LoadtileMapFromTiled(const std::string& filename) {
     // Loads a Tiled map file (json or tsj)
     // a TileMap is a class that stores collections of TileLayer (2D arrays of tile indices)
     // and TileObjects (contains information to construct game entities)
+    auto tileMap = decodeTileMap(filename);
+    if (tileMap) addTileMap(keyFromFilename(filename), std::move(tileMap));
+}
+
+std::unique_ptr<TileMap> AssetLoader::decodeTileMap(const std::string& filename) const {
+    // the compiled map needs no parsing, the JSON is only read if there is none
+    if (AssetBlob compiled = readCompiled(filename, ".tmb")) {
+        auto tileMap = loadCompiledTileMap(compiled.data, compiled.size, keyFromFilename(filename));
+        if (tileMap) return tileMap;
+        TraceLog(LOG_WARNING, "Compiled tilemap for %s is invalid, loading the JSON", filename.c_str());
+    }
+    nlohmann::json j = decodeJson(filename);
+    if (j.is_null()) return nullptr;
+    return std::make_unique<TileMap>(j, keyFromFilename(filename));
+}
+
+void AssetLoader::addTileMap(const std::string& key, std::unique_ptr<TileMap> tileMap) {
+    tileMaps[StringId::intern(key)] = std::move(tileMap);
+    TraceLog(LOG_INFO, "Tilemap file loaded successfully: %s", key.c_str());
+}
+
+nlohmann::json AssetLoader::decodeJson(const std::string& filename) const {
+    if (AssetBlob blob = readAsset(filename)) {
+        return nlohmann::json::parse(blob.data, blob.data + blob.size);
+    }
     std::ifstream file(filename);
     if (!file) {
-        TraceLog(LOG_ERROR, "Failed to open tilemap file %s", filename.c_str());
-        return;
+        TraceLog(LOG_ERROR, "Failed to open JSON file %s", filename.c_str());
+        return nullptr;
     }
     nlohmann::json j;
     file >> j;
-
-    std::string baseName = std::filesystem::path(filename).stem().string();
-    tileMaps[baseName] = std::make_unique<TileMap>(j, baseName);
-    TraceLog(LOG_INFO, "Tilemap file loaded successfully: %s", baseName.c_str());
+    return j;
 }
 
 void  AssetLoader::LoadFont(const std::string& filename) {
-    Font fontTtf = LoadFontEx(filename.c_str(), 32, NULL, 0);
+    Font fontTtf;
+    if (AssetBlob blob = readAsset(filename)) {
+        fontTtf = LoadFontFromMemory(GetFileExtension(filename.c_str()), blob.data, static_cast<int>(blob.size), 32, NULL, 0);
+    }
+    else {
+        fontTtf = LoadFontEx(filename.c_str(), 32, NULL, 0);
+    }
     std::string baseName = std::filesystem::path(filename).stem().string();
-    fonts[baseName] = fontTtf;
-    SetTextureFilter(fonts[baseName].texture, TEXTURE_FILTER_POINT);
+    StringId id = StringId::intern(baseName);
+    fonts[id] = fontTtf;
+    SetTextureFilter(fonts[id].texture, TEXTURE_FILTER_POINT);
     // TODO: still no idea how to disable anti-aliasing
 }
 
 void AssetLoader::LoadShaderFile(const std::string& filename) {
-    auto shader = std::make_shared<Shader>(LoadShader(0, filename.c_str()));
+    std::shared_ptr<Shader> shader;
+    if (AssetBlob blob = readAsset(filename)) {
+        // needs a terminated string
+        std::string code(reinterpret_cast<const char*>(blob.data), blob.size);
+        shader = std::make_shared<Shader>(LoadShaderFromMemory(0, code.c_str()));
+    }
+    else {
+        shader = std::make_shared<Shader>(LoadShader(0, filename.c_str()));
+    }
     std::string baseName = std::filesystem::path(filename).stem().string();
-    shaders[baseName] = shader;
+    shaders[StringId::intern(baseName)] = shader;
 }
 
 void AssetLoader::loadSettings(const std::string& filename) {
@@ -219,15 +321,11 @@ const nlohmann::json& AssetLoader::getSettings() {
 }
 
 void AssetLoader::loadSpriteData(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file) {
-        TraceLog(LOG_ERROR, "Failed to open sprite data file %s", filename.c_str());
-        return;
-    }
-
-    nlohmann::json newData;
-    file >> newData;
+    nlohmann::json newData = decodeJson(filename);
+    if (!newData.is_null()) addSpriteData(std::move(newData));
+}
 
+void AssetLoader::addSpriteData(nlohmann::json&& newData) {
     for (auto& [key, value] : newData.items()) {
         spriteData[key] = std::move(value); // overwrite if the data already exists
     }
@@ -255,19 +353,59 @@ void AssetLoader::postprocessSpriteData()
     for (const auto& item : resolvedData) {
         spriteData[item.first] = item.second;
     }
+
+    // spawning only copies these, the JSON isn't touched after loading
+    archetypes.clear();
+    archetypeIds.clear();
+    const nlohmann::json& spriteDefaults = spriteData.at("sprite_default");
+    nlohmann::json weaponDefaults = spriteData.value("weapon_default", nlohmann::json::object());
+    // the parents and the defaults are never spawned as they are, their textures can be placeholders
+    std::unordered_set<std::string> abstractKeys = { "sprite_default", "weapon_default" };
+    for (const auto& item : rawData) {
+        if (item.second.contains("inherits")) abstractKeys.insert(item.second["inherits"].get<std::string>());
+    }
+    for (const auto& [key, data] : spriteData.items()) {
+        SpriteArchetype archetype = SpriteArchetype::fromData(key, data, spriteDefaults, weaponDefaults);
+        archetype.id = static_cast<uint32_t>(archetypes.size());
+        archetype.isAbstract = abstractKeys.count(key) > 0;
+        auto own = textureGroups.find(key);
+        if (own != textureGroups.end()) archetype.weapon.frames = own->second;
+        // weapons have no textures of their own in the data, they are drawn with the texture of their name
+        bool checkTextures = !archetype.isAbstract && (data.contains("textures") || own == textureGroups.end());
+        std::string missing;
+        for (const auto& textureKey : archetype.textureKeys) {
+            auto it = textureGroups.find(textureKey);
+            if (it == textureGroups.end() || it->second.empty()) {
+                missing += (missing.empty() ? "" : ", ") + textureKey;
+                archetype.frames.emplace_back();
+            }
+            else {
+                archetype.frames.push_back(it->second);
+            }
+        }
+        if (checkTextures && !missing.empty()) {
+            TraceLog(LOG_ERROR, "Missing textures for sprite data %s: %s", key.c_str(), missing.c_str());
+        }
+        archetypeIds[key] = archetype.id;
+        archetypes.push_back(std::move(archetype));
+    }
+    TraceLog(LOG_INFO, "Compiled %zu sprite archetypes", archetypes.size());
+}
+
+const SpriteArchetype* AssetLoader::findArchetype(const std::string& name) const {
+    auto it = archetypeIds.find(name);
+    return it != archetypeIds.end() ? &archetypes[it->second] : nullptr;
 }
 
 void AssetLoader::loadtextData(const std::string& filename)
 {
-    std::ifstream file(filename);
-    if (!file) {
-        TraceLog(LOG_ERROR, "Failed to open text data file %s", filename.c_str());
-        return;
-    }
-    nlohmann::json j;
-    file >> j;
+    nlohmann::json j = decodeJson(filename);
+    if (!j.is_null()) addTextData(j);
+}
+
+void AssetLoader::addTextData(const nlohmann::json& j) {
     for (auto& el : j.items()) {
-        textData[el.key()] = el.value().get<std::vector<std::string>>();
+        textData[StringId::intern(el.key())] = el.value().get<std::vector<std::string>>();
     }
 }
 
@@ -275,59 +413,81 @@ const nlohmann::json& AssetLoader::getSpriteData() {
     return spriteData;
 }
 
-const std::vector<std::string>& AssetLoader::getText(std::string& key)
+const std::vector<std::string>& AssetLoader::getText(StringId key)
 {
     return textData.at(key);
 }
 
-const std::vector<Texture2D>& AssetLoader::getTextures(const std::string& key) {
+const std::vector<Texture2D>& AssetLoader::getTextures(StringId key) {
     return textureGroups[key]; // Returns and empty vector if key doesn't exist
 }
 
-const TileMap& AssetLoader::getTilemap(const std::string& key) {
+const TileMap& AssetLoader::getTilemap(StringId key) {
     auto it = tileMaps.find(key);
     if (it != tileMaps.end()) {
         return *it->second;
     }
-    throw std::out_of_range("TileMap key not found: " + key);
+    throw std::out_of_range(std::string("TileMap key not found: ") + key.str());
 }
 
-const Tileset& AssetLoader::getTileset(const std::string& key)
+const Tileset& AssetLoader::getTileset(StringId key)
 {
     return tilesets.at(key);
 }
 
-const Font& AssetLoader::getFont(const std::string& key) {
+const Font& AssetLoader::getFont(StringId key) {
     return fonts.at(key);
 }
 
-const Shader& AssetLoader::getShader(const std::string& key) {
+const Shader& AssetLoader::getShader(StringId key) {
     auto it = shaders.find(key);
     if (it == shaders.end()) {
-        throw std::runtime_error("Shader not found: " + key);
+        throw std::runtime_error(std::string("Shader not found: ") + key.str());
     }
     return *(it->second);
 }
 
 void AssetLoader::LoadMusicFile(const std::string& filename, const float volume, const std::string& key) {
-    Music music = LoadMusicStream(filename.c_str());
+    Music music;
+    // the packer never compresses audio, a compressed entry has its own buffer that would be freed too early
+    if (AssetBlob blob = readAsset(filename); blob && !blob.owner) {
+        // streams straight from the mapped archive, which stays open as long as the loader exists
+        music = LoadMusicStreamFromMemory(GetFileExtension(filename.c_str()), blob.data, static_cast<int>(blob.size));
+    }
+    else {
+        music = LoadMusicStream(filename.c_str());
+    }
     SetMusicVolume(music, volume);
     std::string id = key.empty() ? std::filesystem::path(filename).stem().string() : key;
-    musicTracks[id] = music;
+    musicTracks[StringId::intern(id)] = music;
 }
 
-const Music& AssetLoader::getMusic(const std::string& key) {
+const Music& AssetLoader::getMusic(StringId key) {
     return musicTracks.at(key);
 }
 
 void AssetLoader::LoadSoundFile(const std::string& filename, const float volume, const std::string& key) {
-    Sound sound = LoadSound(filename.c_str());
+    Wave wave = decodeWave(filename);
+    addSound(key.empty() ? keyFromFilename(filename) : key, wave, volume);
+}
+
+Wave AssetLoader::decodeWave(const std::string& filename) const {
+    if (AssetBlob blob = readAsset(filename)) {
+        return LoadWaveFromMemory(GetFileExtension(filename.c_str()), blob.data, static_cast<int>(blob.size));
+    }
+    return LoadWave(filename.c_str());
+}
+
+void AssetLoader::addSound(const std::string& key, Wave& wave, float volume) {
+    // LoadSoundFromWave needs the audio device, so this stays on the main thread
+    Sound sound = LoadSoundFromWave(wave);
+    UnloadWave(wave);
+    wave = { 0 };
     SetSoundVolume(sound, volume);
-    std::string id = key.empty() ? std::filesystem::path(filename).stem().string() : key;
-    sounds[id] = sound;
+    sounds[StringId::intern(key)] = sound;
 }
 
-Sound& AssetLoader::getSound(const std::string& key) {
+Sound& AssetLoader::getSound(StringId key) {
     return sounds.at(key);
 }
 
@@ -6,6 +6,9 @@
 #include "raylib.h"
 #include "json.hpp"
 #include "TileMap.h"
+#include "AssetArchive.h"
+#include "SpriteArchetype.h"
+#include "StringId.h"
 
 namespace fs = std::filesystem;
 
@@ -13,19 +16,29 @@ nlohmann::json resolveInheritance(const std::unordered_map<std::string, nlohmann
 
 class AssetLoader {
 private:
-    std::unordered_map<std::string, std::vector<Texture2D>> textureGroups; // animation frames are grouped together
-    std::unordered_map<std::string, Tileset> tilesets;
-    std::unordered_map<std::string, Font> fonts;
-    std::unordered_map<std::string, std::unique_ptr<TileMap>> tileMaps;
-    std::unordered_map<std::string, std::shared_ptr<Shader>> shaders;
-    std::unordered_map<std::string, Music> musicTracks;
-    std::unordered_map<std::string, Sound> sounds;
-    std::unordered_map<std::string, std::vector<std::string>> textData;
+    // all keyed by the interned key (see StringId), the getters still accept strings
+    std::unordered_map<StringId, std::vector<Texture2D>> textureGroups; // animation frames are grouped together
+    std::unordered_map<StringId, Tileset> tilesets;
+    std::unordered_map<StringId, Font> fonts;
+    std::unordered_map<StringId, std::unique_ptr<TileMap>> tileMaps;
+    std::unordered_map<StringId, std::shared_ptr<Shader>> shaders;
+    std::unordered_map<StringId, Music> musicTracks;
+    std::unordered_map<StringId, Sound> sounds;
+    std::unordered_map<StringId, std::vector<std::string>> textData;
     nlohmann::json settings;
     nlohmann::json spriteData;
+    std::vector<SpriteArchetype> archetypes; // compiled from spriteData, index == SpriteArchetype::id
+    std::unordered_map<std::string, uint32_t> archetypeIds;
+    AssetArchive archive;
+
+    AssetBlob readAsset(const std::string& filename) const; // empty if there is no archive or the file is not in it
+    AssetBlob readCompiled(const std::string& source, const char* extension) const; // the .tmb/.tsb made from a Tiled file, if there is one
     
 public:
     ~AssetLoader();
+    // if the archive exists, all load functions read from it first and fall back to loose files
+    // (so in development just don't build the archive)
+    bool mountArchive(const std::string& filename);
     void loadTexturesFromDirectory(const std::string& directory);
     void loadTextures(const std::unordered_map<std::string, std::vector<std::string>>& textureMap);
     void loadSpritesheet(const std::string& filename, int frameWidth, int frameHeight, const std::string& key = "");
@@ -36,20 +49,41 @@ public:
     void LoadShaderFile(const std::string& filename);
     void loadSettings(const std::string& filename);
     void loadSpriteData(const std::string& filename);
-    void postprocessSpriteData(); // resolves inheritance
+    void postprocessSpriteData(); // resolves inheritance and compiles the archetypes (textures have to be loaded)
     void loadtextData(const std::string& filename);
     void LoadMusicFile(const std::string& filename, const float volume = 1.0f, const std::string& key = "");
     void LoadSoundFile(const std::string& filename, const float volume = 1.0f, const std::string& key = "");
 
-    const std::vector<Texture2D>& getTextures(const std::string& key);
-    const TileMap& getTilemap(const std::string& key);
-    const Tileset& getTileset(const std::string& key);
-    const Font& getFont(const std::string& key);
-    const Shader& getShader(const std::string& key);
-    const Music& getMusic(const std::string& key);
-    Sound& getSound(const std::string& key); // not const since I need to change the pitch
+    // the loading is split into a decode step (file IO and parsing, no GPU or audio device calls,
+    // safe to run on worker threads) and an add step that has to run on the main thread
+    // the load functions above just do both, the AsyncLoader runs them separately
+    Image decodeImage(const std::string& filename) const;
+    std::vector<Image> decodeSpritesheet(const std::string& filename, int frameWidth, int frameHeight) const;
+    Tileset decodeTileset(const std::string& filename, Image& image) const; // parses the .tsj, loads the image and computes the tile colours
+    std::unique_ptr<TileMap> decodeTileMap(const std::string& filename) const;
+    nlohmann::json decodeJson(const std::string& filename) const;
+    Wave decodeWave(const std::string& filename) const;
+    static std::string keyFromFilename(const std::string& filename) { return fs::path(filename).stem().string(); }
+
+    void addTexture(const std::string& key, Image& image); // uploads the image and unloads it
+    void addTileset(const std::string& key, Tileset&& tileset, Image& image);
+    void addTileMap(const std::string& key, std::unique_ptr<TileMap> tileMap);
+    void addSpriteData(nlohmann::json&& data);
+    void addTextData(const nlohmann::json& data);
+    void addSound(const std::string& key, Wave& wave, float volume); // unloads the wave
+
+    const std::vector<Texture2D>& getTextures(StringId key);
+    const TileMap& getTilemap(StringId key);
+    const Tileset& getTileset(StringId key);
+    const Font& getFont(StringId key);
+    const Shader& getShader(StringId key);
+    const Music& getMusic(StringId key);
+    Sound& getSound(StringId key); // not const since I need to change the pitch
     const nlohmann::json& getSettings();
     const nlohmann::json& getSpriteData();
-    const std::vector<std::string>& getText(std::string& key);
+    const SpriteArchetype* findArchetype(const std::string& name) const; // nullptr if there is no such entry
+    const SpriteArchetype& getArchetype(uint32_t id) const { return archetypes[id]; }
+    const std::unordered_map<std::string, uint32_t>& getArchetypeIds() const { return archetypeIds; }
+    const std::vector<std::string>& getText(StringId key);
     Texture2D fallbackTexture;
 };
@@ -0,0 +1,189 @@
+#include "AsyncLoader.h"
+#include "AssetLoader.h"
+#include "Profiler.h"
+#include "raylib.h"
+#include <chrono>
+#include <algorithm>
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+
+AsyncLoader::AsyncLoader(AssetLoader& loader, size_t threadCount) : loader(loader), started(Clock::now()) {
+    if (threadCount > 0) {
+        pool = std::make_unique<ThreadPool>(threadCount);
+    }
+}
+
+AsyncLoader::~AsyncLoader() {
+    // join the workers before the jobs they point to are destroyed
+    pool.reset();
+}
+
+void AsyncLoader::submit(const std::string& name, DecodeFn decode) {
+    auto job = std::make_unique<Job>();
+    job->name = name;
+    job->group = group;
+    job->decode = std::move(decode);
+    Job* jobPtr = job.get();
+    jobs.push_back(std::move(job));
+    if (pool) {
+        pool->enqueue([jobPtr]() { runDecode(*jobPtr); });
+    }
+}
+
+void AsyncLoader::submitMainThread(const std::string& name, std::function<void()> work) {
+    auto job = std::make_unique<Job>();
+    job->name = name;
+    job->group = group;
+    job->mainThreadWork = std::move(work);
+    job->decoded = true; // nothing to do on the workers
+    jobs.push_back(std::move(job));
+}
+
+void AsyncLoader::runDecode(Job& job) {
+    PROFILE_ZONE(Profiler::name("decode " + job.group));
+    auto start = Clock::now();
+    try {
+        job.upload = job.decode();
+    }
+    catch (...) {
+        // rethrown on the main thread
+        job.error = std::current_exception();
+    }
+    job.decodeMs = msSince(start);
+    job.decoded.store(true, std::memory_order_release);
+}
+
+bool AsyncLoader::drain(double budgetMs) {
+    auto start = Clock::now();
+    while (nextJob < jobs.size()) {
+        Job& job = *jobs[nextJob];
+        if (!job.decoded.load(std::memory_order_acquire)) {
+            if (pool) break; // still being decoded, try again next frame
+            runDecode(job);
+        }
+        if (job.error) std::rethrow_exception(job.error);
+
+        PROFILE_ZONE(Profiler::name("upload " + job.group));
+        auto uploadStart = Clock::now();
+        if (job.mainThreadWork) job.mainThreadWork();
+        if (job.upload) job.upload();
+        job.uploadMs = msSince(uploadStart);
+        // free the captured data
+        job.decode = nullptr;
+        job.upload = nullptr;
+        job.mainThreadWork = nullptr;
+        nextJob++;
+
+        if (done()) wallMs = msSince(started);
+        if (msSince(start) >= budgetMs) break;
+    }
+    return done();
+}
+
+const std::string& AsyncLoader::currentGroup() const {
+    static const std::string finished = "Loading finished";
+    return done() ? finished : jobs[nextJob]->group;
+}
+
+void AsyncLoader::report() const {
+    double decodeTotal = 0.0;
+    double uploadTotal = 0.0;
+    for (const auto& job : jobs) {
+        TraceLog(LOG_INFO, "[Loader] %-40s decode %7.2f ms  upload %6.2f ms", job->name.c_str(), job->decodeMs, job->uploadMs);
+        decodeTotal += job->decodeMs;
+        uploadTotal += job->uploadMs;
+    }
+
+    // the slowest ones are the interesting ones
+    std::vector<const Job*> sorted;
+    for (const auto& job : jobs) sorted.push_back(job.get());
+    std::sort(sorted.begin(), sorted.end(), [](const Job* a, const Job* b) {
+        return a->decodeMs + a->uploadMs > b->decodeMs + b->uploadMs;
+        });
+    for (size_t i = 0; i < std::min<size_t>(5, sorted.size()); ++i) {
+        TraceLog(LOG_INFO, "[Loader] slowest: %s (decode %.2f ms, upload %.2f ms)", sorted[i]->name.c_str(), sorted[i]->decodeMs, sorted[i]->uploadMs);
+    }
+
+    // decode is summed over all threads, so it can be more than the wall time
+    // for the speedup, time a run with --loader-threads 0 as well (game_bench --loader does both)
+    TraceLog(LOG_INFO, "[Loader] %zu assets, %zu worker threads: wall %.1f ms (decode %.1f ms, upload %.1f ms summed up)",
+        jobs.size(), getThreadCount(), wallMs, decodeTotal, uploadTotal);
+}
+
+// convenience functions
+
+void AsyncLoader::texture(const std::string& key, const std::string& filename) {
+    submit(filename, [this, key, filename]() -> UploadFn {
+        Image image = loader.decodeImage(filename);
+        return [this, key, image]() mutable { loader.addTexture(key, image); };
+        });
+}
+
+void AsyncLoader::textures(const std::unordered_map<std::string, std::vector<std::string>>& textureMap) {
+    for (const auto& pair : textureMap) {
+        for (const std::string& filename : pair.second) {
+            texture(pair.first, filename);
+        }
+    }
+}
+
+void AsyncLoader::spritesheet(const std::string& filename, int frameWidth, int frameHeight, const std::string& key) {
+    std::string id = key.empty() ? AssetLoader::keyFromFilename(filename) : key;
+    submit(filename, [this, id, filename, frameWidth, frameHeight]() -> UploadFn {
+        auto frames = loader.decodeSpritesheet(filename, frameWidth, frameHeight);
+        return [this, id, frames]() mutable {
+            for (Image& frame : frames) loader.addTexture(id, frame);
+            };
+        });
+}
+
+void AsyncLoader::tilesetFromTiled(const std::string& filename) {
+    submit(filename, [this, filename]() -> UploadFn {
+        Image image = { 0 };
+        Tileset tileset = loader.decodeTileset(filename, image);
+        if (!image.data) return nullptr;
+        return [this, filename, image, tileset = std::move(tileset)]() mutable {
+            loader.addTileset(AssetLoader::keyFromFilename(filename), std::move(tileset), image);
+            };
+        });
+}
+
+void AsyncLoader::tileMapFromTiled(const std::string& filename) {
+    submit(filename, [this, filename]() -> UploadFn {
+        // std::function needs a copyable lambda, hence the shared_ptr around the unique_ptr
+        auto tileMap = std::make_shared<std::unique_ptr<TileMap>>(loader.decodeTileMap(filename));
+        if (!*tileMap) return nullptr;
+        return [this, filename, tileMap]() {
+            loader.addTileMap(AssetLoader::keyFromFilename(filename), std::move(*tileMap));
+            };
+        });
+}
+
+void AsyncLoader::spriteData(const std::string& filename) {
+    submit(filename, [this, filename]() -> UploadFn {
+        auto data = std::make_shared<nlohmann::json>(loader.decodeJson(filename));
+        if (data->is_null()) return nullptr;
+        return [this, data]() { loader.addSpriteData(std::move(*data)); };
+        });
+}
+
+void AsyncLoader::textData(const std::string& filename) {
+    submit(filename, [this, filename]() -> UploadFn {
+        auto data = std::make_shared<nlohmann::json>(loader.decodeJson(filename));
+        if (data->is_null()) return nullptr;
+        return [this, data]() { loader.addTextData(*data); };
+        });
+}
+
+void AsyncLoader::sound(const std::string& filename, float volume, const std::string& key) {
+    std::string id = key.empty() ? AssetLoader::keyFromFilename(filename) : key;
+    submit(filename, [this, id, filename, volume]() -> UploadFn {
+        Wave wave = loader.decodeWave(filename);
+        return [this, id, wave, volume]() mutable { loader.addSound(id, wave, volume); };
+        });
+}
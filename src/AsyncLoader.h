@@ -0,0 +1,77 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <chrono>
+#include "ThreadPool.h"
+
+class AssetLoader;
+
+/*
+Loads assets in two steps:
+the decode step (file IO, image/sound decoding, JSON parsing) runs on a worker thread,
+the upload step (GPU textures, audio device, inserting into the AssetLoader) runs on the main thread in drain()
+results are applied in the order they were submitted, so animation frames and
+overwritten sprite data end up the same as with the old sequential loading
+*/
+
+class AsyncLoader {
+public:
+    // threadCount 0 decodes everything on the main thread inside drain() (same as before, useful for comparing)
+    AsyncLoader(AssetLoader& loader, size_t threadCount);
+    ~AsyncLoader();
+
+    // the decode function returns the upload function
+    using UploadFn = std::function<void()>;
+    using DecodeFn = std::function<UploadFn()>;
+    void submit(const std::string& name, DecodeFn decode);
+    void submitMainThread(const std::string& name, std::function<void()> work); // for things that can only be loaded on the main thread (fonts, shaders, music streams)
+    void setGroup(const std::string& message) { group = message; } // shown by the loading screen for the following jobs
+
+    // convenience functions, same arguments as the AssetLoader functions
+    void texture(const std::string& key, const std::string& filename);
+    void textures(const std::unordered_map<std::string, std::vector<std::string>>& textureMap);
+    void spritesheet(const std::string& filename, int frameWidth, int frameHeight, const std::string& key = "");
+    void tilesetFromTiled(const std::string& filename);
+    void tileMapFromTiled(const std::string& filename);
+    void spriteData(const std::string& filename);
+    void textData(const std::string& filename);
+    void sound(const std::string& filename, float volume = 1.0f, const std::string& key = "");
+
+    // applies finished jobs until the time budget (in milliseconds) is used up
+    // returns true when all jobs are done
+    bool drain(double budgetMs);
+    bool done() const { return nextJob == jobs.size(); }
+    size_t getCompleted() const { return nextJob; }
+    size_t getTotal() const { return jobs.size(); }
+    size_t getThreadCount() const { return pool ? pool->size() : 0; }
+    const std::string& currentGroup() const;
+    void report() const; // logs the timings of each asset and the totals
+
+private:
+    struct Job {
+        std::string name;
+        std::string group;
+        DecodeFn decode;
+        UploadFn upload;
+        std::function<void()> mainThreadWork;
+        std::exception_ptr error;
+        std::atomic<bool> decoded{ false };
+        double decodeMs = 0.0;
+        double uploadMs = 0.0;
+    };
+
+    AssetLoader& loader;
+    std::vector<std::unique_ptr<Job>> jobs; // only touched by the main thread, workers get a pointer to their job
+    size_t nextJob = 0;
+    std::string group = "Loading...";
+    std::chrono::steady_clock::time_point started; // when the loader was created
+    double wallMs = 0.0; // from creation until the last job was applied
+    std::unique_ptr<ThreadPool> pool;
+
+    static void runDecode(Job& job);
+};
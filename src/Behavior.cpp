@@ -6,8 +6,6 @@
 #include "Controls.h"
 #include "Utils.h"
 #include "ItemData.h"
-#include "Emitter.h"
-#include "Particle.h"
 #include <any>
 #include <cmath>
 #include <array>
@@ -18,12 +16,18 @@ WatchBehavior::WatchBehavior(std::shared_ptr<Sprite> sprite, std::shared_ptr<Spr
 }
 
 void WatchBehavior::update(float deltaTime) {
+    Steering out;
+    steer(deltaTime, out);
+    if (auto s = self.lock()) s->applySteering(out);
+}
+
+void WatchBehavior::steer(float deltaTime, Steering& out) {
     if (auto s = self.lock(), t = target.lock(); s && t) {
         if (t->position.x < s->position.x) {
-            s->lastDirection = LEFT;
+            out.lastDirection = LEFT;
         }
         else {
-            s->lastDirection = RIGHT;
+            out.lastDirection = RIGHT;
         }
     }
 }
@@ -86,7 +90,15 @@ ChaseBehavior::ChaseBehavior(Game& game, std::shared_ptr<Sprite> sprite, std::sh
 }
 
 void ChaseBehavior::update(float deltaTime) {
-    if (auto s = self.lock(), o = other.lock(); s && o) {
+    Steering out;
+    steer(deltaTime, out);
+    if (auto s = self.lock()) s->applySteering(out);
+}
+
+void ChaseBehavior::steer(float deltaTime, Steering& out) {
+    auto s = self.lock();
+    if (!s) return;
+    if (auto o = other.lock()) {
         Vector2 selfCenter = GetRectCenter(s->rect);
         Vector2 otherCenter = GetRectCenter(o->rect);
         float dx = otherCenter.x - selfCenter.x;
@@ -100,54 +112,55 @@ void ChaseBehavior::update(float deltaTime) {
         }
         else {
             float dist = sqrtf(distSq);
-            s->acc.x = dx / dist;
-            s->acc.y = dy / dist;
+            out.acc = { dx / dist, dy / dist };
+            out.hasAcc = true;
             if (dist > deAggroDist) {
                 isChasing = false;
             }
             else if (dist <= minDist) {
-                s->acc = { 0.0f, 0.0f };
-                s->vel = { 0.0f, 0.0f };
+                out.acc = { 0.0f, 0.0f };
+                out.stop = true;
             }
         }
     }
     // seperation behavior between enemies
+    // every chasing enemy keeps itself away from the others (used to push all enemies once per chasing enemy)
     // TODO: does this scale well with deltaTime?
-    for (auto& sprite : game.sprites) {
-        if (!sprite->isEnemy) continue;
-
-        Vector2 sum = { 0, 0 };
-        int count = 0;
-        float desiredSeparation = sprite->rect.width / 2.0f;
-
-        for (auto& other : game.sprites) {
-            if (other != sprite && other->isEnemy) {
-                float dx = sprite->position.x - other->position.x;
-                float dy = sprite->position.y - other->position.y;
-                float distSq = dx * dx + dy * dy;
-                if (distSq < desiredSeparation * desiredSeparation) {
-                    float dist = std::sqrt(distSq);
-                    Vector2 diff = { dx / dist, dy / dist };
-                    float mag = 1.0f / dist;
-                    diff.x *= mag;
-                    diff.y *= mag;
-                    sum.x += diff.x;
-                    sum.y += diff.y;
-                    count++;
-                }
+    if (!s->isEnemy) return;
+
+    Vector2 sum = { 0, 0 };
+    int count = 0;
+    float desiredSeparation = s->rect.width / 2.0f;
+
+    for (auto& other : game.sprites) {
+        if (other != s && other->isEnemy) {
+            float dx = s->position.x - other->position.x;
+            float dy = s->position.y - other->position.y;
+            float distSq = dx * dx + dy * dy;
+            if (distSq < desiredSeparation * desiredSeparation) {
+                float dist = std::sqrt(distSq);
+                Vector2 diff = { dx / dist, dy / dist };
+                float mag = 1.0f / dist;
+                diff.x *= mag;
+                diff.y *= mag;
+                sum.x += diff.x;
+                sum.y += diff.y;
+                count++;
             }
         }
-        if (count > 0) {
-            sum.x /= count;
-            sum.y /= count;
-
-            float mag = std::sqrt(sum.x * sum.x + sum.y * sum.y);
-            sum.x = sum.x / mag;
-            sum.y = sum.y / mag;
-
-            sprite->acc.x += (sum.x - sprite->acc.x);
-            sprite->acc.y += (sum.y - sprite->acc.y);
-        }
+    }
+    if (count > 0) {
+        sum.x /= count;
+        sum.y /= count;
+
+        float mag = std::sqrt(sum.x * sum.x + sum.y * sum.y);
+        sum.x = sum.x / mag;
+        sum.y = sum.y / mag;
+
+        Vector2 acc = out.hasAcc ? out.acc : s->acc;
+        out.acc.x = acc.x + (sum.x - acc.x);
+        out.acc.y = acc.y + (sum.y - acc.y);
+        out.hasAcc = true;
     }
 }
 
@@ -166,7 +179,7 @@ void WeaponBehavior::update(float deltaTime) {
         lifetime -= deltaTime;
         // show the weapon sprite for a split second longer than the lifetime
         if (lifetime < originalLifetime * -0.2f && !done) {
-            s->game.eventManager.pushEvent("killWeapon", nullptr);
+            s->game.eventManager.pushEvent("killWeapon"_id, nullptr);
             done = true;
         }
         s->position.x = o->position.x;
@@ -183,8 +196,8 @@ void WeaponBehavior::update(float deltaTime) {
                     s->rotationAngle = (s->lastDirection == RIGHT) ? 90.0f * angle : -90.0f * angle;
 
                     if (!shaken && progress > 0.5f) {
-                        s->game.eventManager.pushEvent("screenShake", std::make_tuple(0.1f, 0.0f, 10.0f));
-                        s->game.playSound("hammer");
+                        s->game.eventManager.emit<ScreenShake>(0.1f, 0.0f, 10.0f);
+                        s->game.playSound("hammer"_id);
                         // player jumps
                         o->jump();
                         shaken = true;
@@ -214,7 +227,7 @@ DeathBehavior::DeathBehavior(Game& game, std::shared_ptr<Sprite> sprite, float l
     : game{ game }, self {sprite}, lifetime{ lifetime }, maxLifetime{ lifetime } {
     if (auto s = self.lock()) {
         shader = &s->game.loader.getShader("crumble");
-        game.playSound("creature_die_01");
+        game.playSound("creature_die_01"_id);
     }
 }
 
@@ -238,9 +251,9 @@ void TeleportBehavior::update(float deltaTime) {
     if (auto s = self.lock(), o = other.lock(); s && o && !done) {
         if (CheckCollisionRecs(s->rect, o->rect)) {
             done = true;
-            game.eventManager.pushDelayedEvent("teleportStart", 0.0f, nullptr, [this]() {
-                game.eventManager.pushEvent("teleport", std::any(TeleportEvent{ targetMap, targetPos }));
-                game.playSound("bookPlace1");
+            game.eventManager.pushDelayedEvent("teleportStart"_id, 0.0f, nullptr, [this]() {
+                game.eventManager.pushEvent("teleport"_id, std::any(TeleportEvent{ targetMap, targetPos }));
+                game.playSound("bookPlace1"_id);
                 });
         }
     }
@@ -257,7 +270,7 @@ void HealBehavior::update(float deltaTime) {
             // add the amount to health, cap at maxHealth
             o->health = std::min(o->health + amount, o->maxHealth);
             // play sound
-            game.playSound("heart");
+            game.playSound("heart"_id);
             // delete this item
             s->markForDeletion();
         }
@@ -277,9 +290,9 @@ void CollectItemBehavior::update(float deltaTime) {
                 // check collision and collect the item
                 if (CheckCollisionRecs(s->rect, o->rect)) {
                     // add the item
-                    game.eventManager.pushEvent("addItem", std::make_any<std::pair<std::string, uint32_t>>(name, amount));
-                    game.playSound("rupee");
-                    game.eventManager.pushEvent("itemAdded", name);
+                    game.eventManager.pushEvent("addItem"_id, std::make_any<std::pair<std::string, uint32_t>>(name, amount));
+                    game.playSound("rupee"_id);
+                    game.eventManager.pushEvent("itemAdded"_id, name);
                     state++;
                 }
                 break;
@@ -315,7 +328,7 @@ void DialogueBehavior::update(float deltaTime) {
     if (auto s = self.lock(), p = player.lock(); s && p) {
         if (CheckCollisionRecs(s->rect, p->rect)) {
             if (!collided) {
-                game.eventManager.pushEvent("showHelpText", std::make_any<std::tuple<std::string, char, int>>(std::tuple<std::string, char, int>{"TALK", 'O', 9}));
+                game.eventManager.emit<ShowHelpText>("TALK", 'O', 9);
                 collided = true;
             }
             if (game.buttonsDown & CONTROL_ACTION1 && !Command_Textbox::isTextboxCooldown()) {
@@ -325,7 +338,7 @@ void DialogueBehavior::update(float deltaTime) {
                     bool pitch = (voice == "tone") ? false : true;
                     game.cutsceneManager.queueCommand(new Command_Textbox(game, dialogTexts[currentTextIndex], voice, pitch));
                     game.cutsceneManager.queueCommand(new Command_Callback([this]() {
-                        game.eventManager.pushDelayedEvent("resetDialogTrigger", 0.3f, nullptr, [this]() {
+                        game.eventManager.pushDelayedEvent("resetDialogTrigger"_id, 0.3f, nullptr, [this]() {
                             if (currentTextIndex < dialogTexts.size() - 1)
                                 ++currentTextIndex;
                             triggered = false;
@@ -337,7 +350,7 @@ void DialogueBehavior::update(float deltaTime) {
         else {
             if (collided) {
                 collided = false;
-                game.eventManager.pushEvent("hideHelpText");
+                game.eventManager.emit<HideHelpText>();
             }
         }
     }
@@ -353,7 +366,7 @@ void TradeItemBehavior::update(float deltaTime) {
         if (CheckCollisionRecs(s->rect, p->rect)) {
             // show the coin amount
             if (!collided) {
-                game.eventManager.pushEvent("showCoinAmount");
+                game.eventManager.pushEvent("showCoinAmount"_id);
                 collided = true;
             }
             if (game.buttonsDown & CONTROL_ACTION1) {
@@ -364,13 +377,13 @@ void TradeItemBehavior::update(float deltaTime) {
                 uint32_t qty = game.inventory.getItemQuantity("coin");
 
                 if (qty >= price) {
-                    game.eventManager.pushEvent("addItem", std::make_any<std::pair<std::string, uint32_t>>(name, 1));
-                    game.eventManager.pushEvent("removeItem", std::make_any<std::pair<std::string, uint32_t>>("coin", price));
+                    game.eventManager.pushEvent("addItem"_id, std::make_any<std::pair<std::string, uint32_t>>(name, 1));
+                    game.eventManager.pushEvent("removeItem"_id, std::make_any<std::pair<std::string, uint32_t>>("coin", price));
                     done = true;
-                    game.playSound("cash");
+                    game.playSound("cash"_id);
                     game.cutsceneManager.queueCommand(new Command_Textbox(game, "Thanks for your purchase."));
                     game.cutsceneManager.queueCommand(new Command_Callback([this]() {
-                        game.eventManager.pushDelayedEvent("resetDialogTrigger", 0.1f, nullptr, [this]() {
+                        game.eventManager.pushDelayedEvent("resetDialogTrigger"_id, 0.1f, nullptr, [this]() {
                             triggered = false;
                             });
                         }));
@@ -379,7 +392,7 @@ void TradeItemBehavior::update(float deltaTime) {
                     game.cutsceneManager.queueCommand(new Command_Textbox(game, "You can't afford this item."));
                     game.cutsceneManager.queueCommand(new Command_Callback([this]() {
                         // "de-bounce" the interaction by delaying the "triggered" flag
-                        game.eventManager.pushDelayedEvent("resetDialogTrigger", 0.2f, nullptr, [this]() {
+                        game.eventManager.pushDelayedEvent("resetDialogTrigger"_id, 0.2f, nullptr, [this]() {
                             triggered = false;
                             });
                         }));
@@ -390,21 +403,20 @@ void TradeItemBehavior::update(float deltaTime) {
             if (collided) {
                 collided = false;
                 done = false;
-                game.eventManager.pushEvent("hideCoinAmount");
+                game.eventManager.pushEvent("hideCoinAmount"_id);
             }
         }
     }
 }
 
-void TradeItemBehavior::draw() {
+void TradeItemBehavior::draw(RenderSnapshot& out) {
     // draw the coin amount needed to buy this item
     if (auto s = self.lock()) {
         int x = (int)s->position.x - 4;
         int y = (int)s->position.y + 16;
         const auto& coinTex = game.loader.getTextures("itemDropCoin")[0];
-        DrawTexture(coinTex, x, y, WHITE);
-        std::string priceText = "x" + std::to_string(price);
-        DrawText(priceText.c_str(), x + 8, y, 10, WHITE);
+        out.drawTexture(coinTex, x, y, WHITE);
+        out.drawText("x" + std::to_string(price), x + 8, y, 10, WHITE);
     }
 }
 
@@ -472,36 +484,26 @@ void ShootBehavior::update(float deltaTime) {
             projectile->speed = config.speed;
             projectile->frameTime = config.frameTime;
             // add a Particle effect that imitates the sprite, but slowly fades
-            std::unique_ptr<Emitter> emitter = std::make_unique<Emitter>(config.amount);
-            emitter->location = s->position;
-            emitter->spawnInterval = config.spawnInterval;
-            emitter->lifetimeVariance = config.lifetimeVariance;
-            emitter->velocityVariance = config.velocityVariance;
-            std::unique_ptr<Particle> proto = std::make_unique<Particle>();
-            proto->velocity = config.particleVelocity;
-            proto->lifetime = config.particleLifetime;
-            proto->alpha = config.particleStartingAlpha;
-            proto->endSize = config.particleEndSize;
-            proto->setAnimationFrames(game.loader.getTextures(config.projectileKey));
-            emitter->prototype = *proto;
-            projectile->addBehavior(std::make_unique<EmitterBehavior>(game, projectile, std::move(emitter), std::move(proto)));
+            projectile->addBehavior(std::make_unique<EmitterBehavior>(game, projectile, config.particlePreset, config.projectileKey));
         }
     }
 }
 
-EmitterBehavior::EmitterBehavior(Game& game, std::shared_ptr<Sprite> self, std::unique_ptr<Emitter> emitter, std::unique_ptr<Particle> prototype) : game{ game }, self{ self }, emitter{ std::move(emitter) }, prototype{ std::move(prototype) }
+EmitterBehavior::EmitterBehavior(Game& game, std::shared_ptr<Sprite> self, const std::string& preset, const std::string& textureKey) : game{ game }, self{ self }
 {
+    const std::vector<Texture2D>* frames = textureKey.empty() ? nullptr : &game.loader.getTextures(textureKey);
+    emitter = game.particles.spawn(preset, GetRectCenter(self->rect), frames);
+}
+
+EmitterBehavior::~EmitterBehavior() {
+    // the particles that are still alive fade out on their own
+    game.particles.release(emitter);
 }
 
 void EmitterBehavior::update(float deltaTime) {
     if (auto s = self.lock(); s) {
-        emitter->location = GetRectCenter(s->rect);
+        game.particles.setLocation(emitter, GetRectCenter(s->rect));
     }
-    emitter->update(deltaTime);
-}
-
-void EmitterBehavior::draw() {
-    emitter->draw();
 }
 
 ChestBehavior::ChestBehavior(Game& game, std::shared_ptr<Sprite> self, std::shared_ptr<Sprite> player, const std::string& itemName, uint32_t itemAmount) : game{ game }, self{ self }, player{ player }, itemName{ itemName }, itemAmount{ itemAmount }
@@ -516,7 +518,7 @@ void ChestBehavior::update(float deltaTime) {
         interactionRect.height = s->rect.height + 4.0f;
         if (CheckCollisionRecs(interactionRect, p->rect)) {
             if (!collided) {
-                game.eventManager.pushEvent("showHelpText", std::make_any<std::tuple<std::string, char, int>>(std::tuple<std::string, char, int>{"OPEN", 'O', 9}));
+                game.eventManager.emit<ShowHelpText>("OPEN", 'O', 9);
                 collided = true;
             }
             if (game.buttonsDown & CONTROL_ACTION1) {
@@ -525,14 +527,14 @@ void ChestBehavior::update(float deltaTime) {
                 const ItemData& data = itemData.at(itemName);
                 s->currentFrame = 2;
                 showItem = true;
-                game.playSound("doorOpen_2");
-                game.eventManager.pushDelayedEvent("hideItem", 2.0f, nullptr, [&]() {
+                game.playSound("doorOpen_2"_id);
+                game.eventManager.pushDelayedEvent("hideItem"_id, 2.0f, nullptr, [&]() {
                     showItem = false;
                     });
 
                 game.cutsceneManager.queueCommand(new Command_Wait(0.5f));
                 game.cutsceneManager.queueCommand(new Command_Callback([&]() {
-                    game.playSound("Rise03");
+                    game.playSound("Rise03"_id);
                     }));
                 game.cutsceneManager.queueCommand(new Command_Wait(0.5f));
                 std::string message;
@@ -550,7 +552,7 @@ void ChestBehavior::update(float deltaTime) {
                 }
                 game.cutsceneManager.queueCommand(new Command_Textbox(game, message));
                 // event that adds the item to the inventory
-                game.eventManager.pushEvent("addItem", std::make_any<std::pair<std::string, uint32_t>>(itemName, itemAmount));
+                game.eventManager.pushEvent("addItem"_id, std::make_any<std::pair<std::string, uint32_t>>(itemName, itemAmount));
                 // trigger the event that changes the object state
                 std::string eventKey = "chest_opened_" + std::to_string(s->tileMapID);
                 game.eventManager.pushEvent(eventKey, s->tileMapID);
@@ -558,14 +560,14 @@ void ChestBehavior::update(float deltaTime) {
         } 
         else {
             if (collided) {
-                game.eventManager.pushEvent("hideHelpText");
+                game.eventManager.emit<HideHelpText>();
                 collided = false;
             }
         }
     }
 }
 
-void ChestBehavior::draw() {
+void ChestBehavior::draw(RenderSnapshot& out) {
     if (!showItem) return;
     if (auto s = self.lock()) {
         int x = (int)s->position.x;
@@ -573,7 +575,7 @@ void ChestBehavior::draw() {
         auto& itemData = game.inventory.getItemData();
         const ItemData& data = itemData.at(itemName);
         const auto& textures = game.loader.getTextures(data.textureKey);
-        DrawTexture(textures[0], x, y, WHITE);
+        out.drawTexture(textures[0], x, y, WHITE);
     }
 }
 
@@ -590,7 +592,7 @@ void OpenLockBehavior::update(float deltaTime) {
         interactionRect.height = d->rect.height + 4.0f;
         if (CheckCollisionRecs(interactionRect, p->rect)) {
             if (!collided) {
-                game.eventManager.pushEvent("showHelpText", std::make_any<std::tuple<std::string, char, int>>(std::tuple<std::string, char, int>{"OPEN", 'O', 9}));
+                game.eventManager.emit<ShowHelpText>("OPEN", 'O', 9);
                 collided = true;
             }
             if (game.buttonsDown & CONTROL_ACTION1) {
@@ -601,21 +603,21 @@ void OpenLockBehavior::update(float deltaTime) {
                     game.cutsceneManager.queueCommand(new Command_Textbox(game, "Looks like you need a key to open this door."));
                     game.cutsceneManager.queueCommand(new Command_Callback([this]() {
                         // "de-bounce" the interaction by delaying the "triggered" flag
-                        game.eventManager.pushDelayedEvent("resetDialogTrigger", 0.2f, nullptr, [this]() {
+                        game.eventManager.pushDelayedEvent("resetDialogTrigger"_id, 0.2f, nullptr, [this]() {
                             triggered = false;
                             });
                         }));
                     return;
                 }
-                game.eventManager.pushEvent("removeItem", std::make_any<std::pair<std::string, uint32_t>>("key", 1));
-                game.eventManager.pushDelayedEvent("unlockedDoor", 0.1f, nullptr, [d, this]() {
-                    this->game.playSound("bookPlace1");
+                game.eventManager.pushEvent("removeItem"_id, std::make_any<std::pair<std::string, uint32_t>>("key", 1));
+                game.eventManager.pushDelayedEvent("unlockedDoor"_id, 0.1f, nullptr, [d, this]() {
+                    this->game.playSound("bookPlace1"_id);
                     d->currentFrame = 0;
                     this->game.eventManager.pushEvent(triggerKey); // triggers a change in the persistent room data
                     // TODO: open the same door from the other side
                     });
-                game.eventManager.pushDelayedEvent("openedDoor", 0.8f, nullptr, [d, this]() {
-                    this->game.playSound("doorOpen_2");
+                game.eventManager.pushDelayedEvent("openedDoor"_id, 0.8f, nullptr, [d, this]() {
+                    this->game.playSound("doorOpen_2"_id);
                     d->currentFrame = 1;
                     d->staticCollision = false;
                     this->done = true;
@@ -624,7 +626,7 @@ void OpenLockBehavior::update(float deltaTime) {
         }
         else {
             if (collided) {
-                game.eventManager.pushEvent("hideHelpText");
+                game.eventManager.emit<HideHelpText>();
                 collided = false;
             }
         }
@@ -6,8 +6,8 @@
 
 class Game;
 class Sprite;
-struct Emitter;
-struct Particle;
+class RenderSnapshot;
+#include "ParticleSystem.h"
 
 enum direction {
     RIGHT,
@@ -32,23 +32,27 @@ struct shootingConfig {
     float speed = 1.0f;
     float frameTime = 0.1f;
     float hitboxSize = 8.0f;
-    // emitter
-    float spawnInterval = 1.0f;
-    float lifetimeVariance = 0.0f;
-    Vector2 velocityVariance = { 0.0f, 0.0f };
-    uint32_t amount = 1;
-    // particle prototype
-    Vector2 particleVelocity = { 0.0f, 0.0f };
-    float particleLifetime = 1.0f;
-    float particleStartingAlpha = 1.0f;
-    float particleEndSize = 0.1f;
+    // trail effect (preset in particles.json), uses the projectile's textures
+    std::string particlePreset = "projectileTrail";
+};
+
+struct Steering {
+    // what a steering behavior wants its sprite to do, applied once all of them have run
+    Vector2 acc = { 0.0f, 0.0f };
+    bool hasAcc = false;
+    bool stop = false; // sets vel to 0
+    int lastDirection = -1; // -1 keeps it
 };
 
 class Behavior {
 public:
     virtual ~Behavior() = default;
     virtual void update(float deltaTime) = 0;
-    virtual void draw() {};
+    virtual void draw(RenderSnapshot& out) {};
+    // steering behaviors run in parallel (see InGame::update), steer() may only read the other
+    // sprites and write to out and its own members, update() runs it on its own
+    virtual bool isSteering() const { return false; }
+    virtual void steer(float deltaTime, Steering& out) {}
     bool done = false;
 };
 
@@ -56,6 +60,8 @@ class WatchBehavior : public Behavior {
 public:
     WatchBehavior(std::shared_ptr<Sprite> self, std::shared_ptr<Sprite> target);
     void update(float deltaTime) override;
+    bool isSteering() const override { return true; }
+    void steer(float deltaTime, Steering& out) override;
 
 private:
     std::weak_ptr<Sprite> self;
@@ -78,6 +84,8 @@ class ChaseBehavior : public Behavior {
 public:
     ChaseBehavior(Game& game, std::shared_ptr<Sprite> self, std::shared_ptr<Sprite> other, float aggroDist, float minDist, float deAggroDist);
     void update(float deltaTime) override;
+    bool isSteering() const override { return true; }
+    void steer(float deltaTime, Steering& out) override;
     
 private:
     Game& game;
@@ -194,7 +202,7 @@ class TradeItemBehavior : public Behavior {
 public:
     TradeItemBehavior(Game& game, std::shared_ptr<Sprite> self, std::shared_ptr<Sprite> player, std::string name, uint32_t price);
     void update(float deltaTime) override;
-    void draw() override;
+    void draw(RenderSnapshot& out) override;
 
 private:
     Game& game;
@@ -237,22 +245,22 @@ private:
 
 class EmitterBehavior : public Behavior {
 public:
-    EmitterBehavior(Game& game, std::shared_ptr<Sprite> self, std::unique_ptr<Emitter> emitter, std::unique_ptr<Particle> prototype);
+    // the emitter is owned by game.particles, this only moves it along with the sprite
+    EmitterBehavior(Game& game, std::shared_ptr<Sprite> self, const std::string& preset, const std::string& textureKey = "");
+    ~EmitterBehavior();
     void update(float deltaTime) override;
-    void draw() override;
 
 private:
     Game& game;
     std::weak_ptr<Sprite> self;
-    std::unique_ptr<Emitter> emitter;
-    std::unique_ptr<Particle> prototype;
+    EmitterHandle emitter;
 };
 
 class ChestBehavior : public Behavior {
 public:
     ChestBehavior(Game& game, std::shared_ptr<Sprite> self, std::shared_ptr<Sprite> player, const std::string& itemName, uint32_t itemAmount);
     void update(float deltaTime) override;
-    void draw() override;
+    void draw(RenderSnapshot& out) override;
 
 private:
     Game& game;
@@ -0,0 +1,222 @@
+#include "ChunkStreamer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+
+void ChunkStreamer::setBudget(size_t vramBytes, float margin, size_t bakes) {
+    vramBudget = vramBytes;
+    prefetchMargin = margin;
+    bakesPerFrame = bakes;
+}
+
+void ChunkStreamer::setMap(const Room* newRoom, const Texture2D& tilesetTexture, size_t columns) {
+    retire();
+    room = newRoom;
+    map = room ? &room->getTemplate() : nullptr;
+    tileset = tilesetTexture;
+    tilesPerRow = std::max<size_t>(columns, 1);
+    if (!map) return;
+    tileSize = std::max<size_t>(map->tileWidth, 1);
+    chunksX = (map->width * tileSize + chunkSize - 1) / chunkSize;
+    chunksY = (map->height * tileSize + chunkSize - 1) / chunkSize;
+    activeCells.assign(chunksX * chunksY, false);
+}
+
+void ChunkStreamer::clear() {
+    retire();
+    for (auto& target : retired) UnloadRenderTexture(target);
+    retired.clear();
+}
+
+void ChunkStreamer::retire() {
+    for (auto& [key, chunk] : chunks) {
+        if (chunk.target.id != 0) retired.push_back(chunk.target);
+    }
+    chunks.clear();
+    lru.clear();
+    activeCells.clear();
+    activeList.clear();
+    room = nullptr;
+    map = nullptr;
+    chunksX = chunksY = 0;
+    stats = ChunkStats();
+}
+
+size_t ChunkStreamer::cellAt(float x, float y) const {
+    size_t cx = static_cast<size_t>(std::clamp(x / chunkSize, 0.0f, static_cast<float>(chunksX - 1)));
+    size_t cy = static_cast<size_t>(std::clamp(y / chunkSize, 0.0f, static_cast<float>(chunksY - 1)));
+    return cy * chunksX + cx;
+}
+
+ChunkStreamer::CellRange ChunkStreamer::cellsAround(Rectangle view, float margin) const {
+    CellRange range;
+    if (chunksX == 0 || chunksY == 0) return range;
+    auto toCell = [&](float value, size_t count) {
+        return static_cast<size_t>(std::clamp(std::floor(value / chunkSize), 0.0f, static_cast<float>(count)));
+    };
+    range.x0 = toCell(view.x - margin, chunksX);
+    range.y0 = toCell(view.y - margin, chunksY);
+    // + 1 because the last cell is only partially covered
+    range.x1 = std::min(toCell(view.x + view.width + margin, chunksX) + 1, chunksX);
+    range.y1 = std::min(toCell(view.y + view.height + margin, chunksY) + 1, chunksY);
+    return range;
+}
+
+bool ChunkStreamer::isResident(size_t layer, size_t cx, size_t cy) const {
+    return chunks.find((layer * chunksY + cy) * chunksX + cx) != chunks.end();
+}
+
+ChunkStreamer::Chunk& ChunkStreamer::acquire(size_t layer, size_t cx, size_t cy) {
+    size_t key = (layer * chunksY + cy) * chunksX + cx;
+    auto it = chunks.find(key);
+    if (it == chunks.end()) {
+        it = chunks.emplace(key, Chunk()).first;
+        bake(it->second, layer, cx, cy);
+        if (it->second.target.id != 0) {
+            lru.push_front(key);
+            it->second.lruPosition = lru.begin();
+            stats.residentChunks++;
+            stats.residentBytes += chunkBytes();
+        }
+        stats.bakedThisFrame++;
+    }
+    else if (it->second.target.id != 0 && it->second.lastUsed != frame) {
+        lru.splice(lru.begin(), lru, it->second.lruPosition);
+    }
+    it->second.lastUsed = frame;
+    return it->second;
+}
+
+void ChunkStreamer::bake(Chunk& chunk, size_t layer, size_t cx, size_t cy) {
+    PROFILE_ZONE("bake chunk");
+    int tilesPerChunk = chunkSize / static_cast<int>(tileSize);
+    int startTileX = static_cast<int>(cx) * tilesPerChunk;
+    int startTileY = static_cast<int>(cy) * tilesPerChunk;
+    int endTileX = startTileX + tilesPerChunk;
+    int endTileY = startTileY + tilesPerChunk;
+
+    // chunks without tiles (common in wall and decoration layers) don't need a texture
+    bool empty = true;
+    room->forEachTile(layer, startTileX, startTileY, endTileX, endTileY, [&](int, int, uint16_t) { empty = false; });
+    if (empty) return;
+
+    chunk.target = LoadRenderTexture(chunkSize, chunkSize);
+    BeginTextureMode(chunk.target);
+    ClearBackground(BLANK);
+    room->forEachTile(layer, startTileX, startTileY, endTileX, endTileY, [&](int mapX, int mapY, uint16_t id) {
+        int tileIndex = id - 1;
+
+        size_t tileX = ((size_t)tileIndex % tilesPerRow) * tileSize;
+        size_t tileY = ((size_t)tileIndex / tilesPerRow) * tileSize;
+        float srcX = std::clamp(static_cast<float>(tileX), 0.0f, static_cast<float>(tileset.width - tileSize));
+        float srcY = std::clamp(static_cast<float>(tileY), 0.0f, static_cast<float>(tileset.height - tileSize));
+        Rectangle src = { srcX, srcY, static_cast<float>(tileSize), static_cast<float>(tileSize) };
+
+        Vector2 pos = { static_cast<float>((mapX - startTileX) * tileSize), static_cast<float>((mapY - startTileY) * tileSize) };
+        DrawTextureRec(tileset, src, pos, WHITE);
+        });
+    EndTextureMode();
+}
+
+void ChunkStreamer::evict() {
+    // chunks that were used this frame stay, even if that means going over the budget
+    while (stats.residentBytes > vramBudget && !lru.empty()) {
+        size_t key = lru.back();
+        auto it = chunks.find(key);
+        if (it->second.lastUsed == frame) break;
+        UnloadRenderTexture(it->second.target);
+        chunks.erase(it);
+        lru.pop_back();
+        stats.residentChunks--;
+        stats.residentBytes -= chunkBytes();
+        stats.evictedThisFrame++;
+    }
+    // empty chunks have no texture, but the entries would pile up while walking across a huge map
+    // (they are rare and cheap to find again, so they are just dropped all at once)
+    if (chunks.size() - lru.size() > 4096) {
+        for (auto it = chunks.begin(); it != chunks.end();) {
+            if (it->second.target.id == 0 && it->second.lastUsed != frame) it = chunks.erase(it);
+            else ++it;
+        }
+    }
+}
+
+void ChunkStreamer::update(Rectangle view, float releaseMargin, const CellCallback& onActivate, const CellCallback& onDeactivate) {
+    PROFILE_ZONE("chunks");
+    for (auto& target : retired) UnloadRenderTexture(target);
+    retired.clear();
+    if (!map) return;
+    frame++;
+    stats.bakedThisFrame = 0;
+    stats.evictedThisFrame = 0;
+
+    // everything on screen has to be there this frame
+    CellRange visible = cellsAround(view, 0.0f);
+    for (size_t layer = 0; layer < map->layers.size(); ++layer) {
+        if (!map->layers[layer].visible) continue;
+        for (size_t cy = visible.y0; cy < visible.y1; ++cy) {
+            for (size_t cx = visible.x0; cx < visible.x1; ++cx) acquire(layer, cx, cy);
+        }
+    }
+    // the margin around it is baked a few chunks per frame, so walking doesn't cause spikes
+    CellRange prefetch = cellsAround(view, prefetchMargin);
+    size_t bakes = 0;
+    for (size_t cy = prefetch.y0; cy < prefetch.y1 && bakes < bakesPerFrame; ++cy) {
+        for (size_t cx = prefetch.x0; cx < prefetch.x1 && bakes < bakesPerFrame; ++cx) {
+            if (visible.contains(cx, cy)) continue;
+            for (size_t layer = 0; layer < map->layers.size() && bakes < bakesPerFrame; ++layer) {
+                if (!map->layers[layer].visible || isResident(layer, cx, cy)) continue;
+                acquire(layer, cx, cy);
+                bakes++;
+            }
+        }
+    }
+    evict();
+
+    // objects: cells in the prefetch area are activated, cells outside the (bigger) release area deactivated
+    // the gap between the two keeps objects at the border from flickering in and out
+    CellRange keep = cellsAround(view, std::max(releaseMargin, prefetchMargin));
+    for (size_t i = 0; i < activeList.size();) {
+        size_t cell = activeList[i];
+        if (keep.contains(cell % chunksX, cell / chunksX)) {
+            i++;
+            continue;
+        }
+        activeCells[cell] = false;
+        activeList[i] = activeList.back();
+        activeList.pop_back();
+        if (onDeactivate) onDeactivate(cell);
+    }
+    for (size_t cy = prefetch.y0; cy < prefetch.y1; ++cy) {
+        for (size_t cx = prefetch.x0; cx < prefetch.x1; ++cx) {
+            size_t cell = cy * chunksX + cx;
+            if (activeCells[cell]) continue;
+            activeCells[cell] = true;
+            activeList.push_back(cell);
+            if (onActivate) onActivate(cell);
+        }
+    }
+    stats.activeCells = activeList.size();
+}
+
+void ChunkStreamer::drawLayer(size_t layer, Rectangle view, bool debug, RenderSnapshot& out) const {
+    if (!map || layer >= map->layers.size()) return;
+    // only the chunks in view are looked at, not the whole map
+    CellRange visible = cellsAround(view, 0.0f);
+    for (size_t cy = visible.y0; cy < visible.y1; ++cy) {
+        for (size_t cx = visible.x0; cx < visible.x1; ++cx) {
+            auto it = chunks.find((layer * chunksY + cy) * chunksX + cx);
+            if (it == chunks.end() || it->second.target.id == 0) continue; // empty, or not baked yet (paused scene)
+
+            // chunks are flipped, so the src rect has to be flipped to draw the chunk correctly
+            Vector2 drawPos = { static_cast<float>(cx * chunkSize), static_cast<float>(cy * chunkSize) };
+            Rectangle src = { 0, 0, (float)chunkSize, -(float)chunkSize };
+            Rectangle dst = { drawPos.x, drawPos.y, (float)chunkSize, (float)chunkSize };
+            out.drawTexturePro(it->second.target.texture, src, dst, Vector2{ 0, 0 }, 0.0f, WHITE);
+            if (debug) {
+                out.drawRectangleLines((int)drawPos.x, (int)drawPos.y, chunkSize, chunkSize, RED);
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include "raylib.h"
+#include "TileMap.h"
+#include "Dungeon.h"
+#include "RenderSnapshot.h"
+
+struct ChunkStats {
+    size_t residentChunks = 0; // chunk textures in VRAM
+    size_t residentBytes = 0;
+    size_t bakedThisFrame = 0;
+    size_t evictedThisFrame = 0;
+    size_t activeCells = 0; // cells whose objects are spawned
+};
+
+class ChunkStreamer {
+    // keeps the baked tile layer textures of the current map, square chunks of chunkSize pixels
+    // chunks are baked when the camera (plus a margin) gets close and are evicted least recently used first
+    // once the VRAM budget is full, so the cost per frame doesn't depend on the size of the map
+    // the same grid of cells is used to activate and deactivate the map objects (see InGame::updateStreaming)
+public:
+    // called with the cell index (cy * cellsX + cx) when a cell enters or leaves the active area
+    using CellCallback = std::function<void(size_t cell)>;
+
+    explicit ChunkStreamer(int chunkSize) : chunkSize(chunkSize) {}
+    ~ChunkStreamer() { clear(); }
+    ChunkStreamer(const ChunkStreamer&) = delete; // owns textures
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    void setBudget(size_t vramBytes, float prefetchMargin, size_t bakesPerFrame);
+    // switches to a new room, the textures of the old one are unloaded by the next update()
+    // (setMap can run on the simulation thread while the last snapshot, which still uses them, is drawn)
+    void setMap(const Room* room, const Texture2D& tilesetTexture, size_t tilesPerRow);
+    void clear(); // unloads everything right away
+
+    // view is the part of the world the camera sees (in pixels)
+    // bakes what's visible and some of the prefetch area, cells further away than releaseMargin are deactivated
+    // update() and clear() load and unload textures, so they have to run on the main thread
+    void update(Rectangle view, float releaseMargin, const CellCallback& onActivate, const CellCallback& onDeactivate);
+    void drawLayer(size_t layer, Rectangle view, bool debug, RenderSnapshot& out) const;
+
+    int getChunkSize() const { return chunkSize; }
+    size_t getCellsX() const { return chunksX; }
+    size_t getCellsY() const { return chunksY; }
+    size_t cellAt(float x, float y) const; // cell index of a world position (clamped to the map)
+    bool isCellActive(size_t cell) const { return cell < activeCells.size() && activeCells[cell]; }
+    const ChunkStats& getStats() const { return stats; }
+
+private:
+    struct Chunk {
+        RenderTexture2D target = { 0 }; // id 0 for chunks without any tiles
+        uint64_t lastUsed = 0; // frame number
+        std::list<size_t>::iterator lruPosition;
+    };
+    struct CellRange {
+        size_t x0 = 0, y0 = 0, x1 = 0, y1 = 0; // [x0, x1) x [y0, y1)
+        bool contains(size_t cx, size_t cy) const { return cx >= x0 && cx < x1 && cy >= y0 && cy < y1; }
+    };
+
+    int chunkSize;
+    const Room* room = nullptr; // the tiles are baked with the room's edits
+    const TileMap* map = nullptr; // its template
+    Texture2D tileset = { 0 };
+    size_t tilesPerRow = 1;
+    size_t tileSize = 16;
+    size_t chunksX = 0, chunksY = 0;
+
+    size_t vramBudget = 64 * 1024 * 1024;
+    float prefetchMargin = 128.0f;
+    size_t bakesPerFrame = 2;
+
+    std::unordered_map<size_t, Chunk> chunks; // key: (layer * chunksY + cy) * chunksX + cx
+    std::list<size_t> lru; // most recently used first, only chunks that hold a texture
+    std::vector<bool> activeCells;
+    std::vector<size_t> activeList; // the same cells as a list, so the update doesn't have to look at the whole map
+    std::vector<RenderTexture2D> retired; // textures of the last map, see setMap
+    uint64_t frame = 0;
+    ChunkStats stats;
+
+    CellRange cellsAround(Rectangle view, float margin) const;
+    size_t chunkBytes() const { return static_cast<size_t>(chunkSize) * chunkSize * 4; }
+    Chunk& acquire(size_t layer, size_t cx, size_t cy); // bakes if needed
+    bool isResident(size_t layer, size_t cx, size_t cy) const;
+    void bake(Chunk& chunk, size_t layer, size_t cx, size_t cy);
+    void evict();
+    void retire(); // forgets the map, its textures go into retired
+};
@@ -1,12 +1,56 @@
 #include "Dungeon.h"
 #include <raylib.h>
 #include "Game.h"
+#include <algorithm>
+#include <unordered_set>
+
+uint16_t Room::getTile(size_t layer, int x, int y) const
+{
+    if (layer >= tilemap->layers.size()) return 0;
+    TileEdit key{ static_cast<uint32_t>(layer), static_cast<uint16_t>(x), static_cast<uint16_t>(y), 0 };
+    if (x >= 0 && y >= 0 && x <= 0xFFFF && y <= 0xFFFF) {
+        auto it = std::lower_bound(tileEdits.begin(), tileEdits.end(), key);
+        if (it != tileEdits.end() && !(key < *it)) return it->id;
+    }
+    return tilemap->layers[layer].at(x, y);
+}
+
+void Room::setTile(size_t layer, int x, int y, uint16_t id)
+{
+    if (layer >= tilemap->layers.size()) return;
+    const TileLayer& tileLayer = tilemap->layers[layer];
+    if (x < 0 || y < 0 || x >= tileLayer.width || y >= tileLayer.height || x > 0xFFFF || y > 0xFFFF) return;
+    TileEdit edit{ static_cast<uint32_t>(layer), static_cast<uint16_t>(x), static_cast<uint16_t>(y), id };
+    auto it = std::lower_bound(tileEdits.begin(), tileEdits.end(), edit);
+    bool edited = it != tileEdits.end() && !(edit < *it);
+    if (id == tileLayer.at(x, y)) {
+        if (edited) tileEdits.erase(it); // back to the template
+    }
+    else if (edited) {
+        it->id = id;
+    }
+    else {
+        tileEdits.insert(it, edit);
+    }
+}
+
+size_t Room::memoryUsage() const
+{
+    size_t bytes = sizeof(Room) + tileEdits.capacity() * sizeof(TileEdit);
+    bytes += objectStates.size() * (sizeof(uint32_t) + sizeof(ObjectState) + sizeof(void*) * 2); // node estimate
+    return bytes;
+}
 
 Dungeon::Dungeon(Game& game, size_t roomsW, size_t roomsH) : game{ game }, roomsW { roomsW }, roomsH{ roomsH }
 {
     rooms.resize(roomsW * roomsH);
 }
 
+Dungeon::~Dungeon()
+{
+    if (minimapAtlas.id != 0) UnloadTexture(minimapAtlas);
+}
+
 std::vector<std::optional<Room>>& Dungeon::getRooms()
 {
     return rooms;
@@ -29,7 +73,8 @@ void Dungeon::advanceRoomState(size_t index) {
     rooms[index]->state <<= 1;
     if (rooms[index]->state == 0)
         rooms[index]->state = 1;
-    TraceLog(LOG_INFO, "Room state of %s is now %d", rooms[index]->tilemap.getName().c_str(), rooms[index]->state);
+    game.eventManager.raiseSignal(SIGNAL_ROOM_STATE_CHANGED);
+    TraceLog(LOG_INFO, "Room state of %s is now %d", rooms[index]->getTemplate().getName().c_str(), rooms[index]->state);
 }
 
 uint8_t Dungeon::getCurrentRoomState()
@@ -65,7 +110,13 @@ const TileMap* Dungeon::loadCurrentTileMap()
         return nullptr;
     }
     setVisited(currentRoomIndex); // TODO: is it always correct to set this here?
-    return &rooms[currentRoomIndex]->tilemap;
+    return &rooms[currentRoomIndex]->getTemplate();
+}
+
+const Room* Dungeon::getCurrentRoom() const
+{
+    if (currentRoomIndex >= rooms.size() || !rooms[currentRoomIndex]) return nullptr;
+    return &*rooms[currentRoomIndex];
 }
 
 void Dungeon::insertRoom(size_t row, size_t col, Room&& room) {
@@ -85,9 +136,10 @@ std::pair<size_t, size_t> Dungeon::getSize() const
 
 std::pair<size_t, size_t> Dungeon::getRoomSize(size_t index) const
 {
-    size_t w = rooms[index]->tilemap.width;
-    size_t h = rooms[index]->tilemap.height;
-    size_t ts = rooms[index]->tilemap.tileWidth;
+    const TileMap& tileMap = rooms[index]->getTemplate();
+    size_t w = tileMap.width;
+    size_t h = tileMap.height;
+    size_t ts = tileMap.tileWidth;
     return { w * ts, h * ts };
 }
 
@@ -107,93 +159,72 @@ void Dungeon::setVisited(size_t index)
 void Dungeon::makeMinimapTextures()
 {
     // creates downscaled images of the rooms for the mini map
-    constexpr int miniWidth = 36;
-    constexpr int miniHeight = 24;
-    constexpr int tileSize = 16;
-    for (int i = 0; i < roomsW * roomsH; i++) {
-        if (!rooms[i]) {
-            // store an empty texture for nonexistent rooms
-            RenderTexture2D mini = LoadRenderTexture(miniWidth, miniHeight);
-            BeginTextureMode(mini);
-            ClearBackground(BLANK);
-            EndTextureMode();
-            minimapTextures.push_back(mini);
-            continue;
+    // every tile becomes one pixel with the tile's most common colour (precomputed per tileset),
+    // all rooms are packed into a single atlas texture
+    double startTime = GetTime();
+    constexpr int atlasMaxWidth = 1024;
+
+    // pack the rooms into rows (shelves) first, so the atlas size is known
+    minimapRects.assign(rooms.size(), Rectangle{ 0, 0, 0, 0 });
+    int penX = 0, penY = 0, shelfHeight = 0, atlasWidth = 0;
+    for (size_t i = 0; i < rooms.size(); i++) {
+        if (!rooms[i]) continue;
+        int w = static_cast<int>(rooms[i]->getTemplate().width);
+        int h = static_cast<int>(rooms[i]->getTemplate().height);
+        if (penX + w > atlasMaxWidth) {
+            penX = 0;
+            penY += shelfHeight;
+            shelfHeight = 0;
         }
-        auto tileMap = &rooms[i]->tilemap;
-        const Tileset& tileset = game.loader.getTileset(tileMap->getTilesetName());
-        const Texture2D& texture = game.loader.getTextures(tileset.name)[0];
-        const size_t tilesPerRow = tileset.columns;
-
-        // NEW: scaling down the room image AFTER all tiles have been drawn
-        std::pair<size_t, size_t> tilemapSize = getRoomSize(currentRoomIndex);
-        RenderTexture2D normal = LoadRenderTexture(static_cast<int>(tilemapSize.first), static_cast<int>(tilemapSize.second)); // 1:1 size
-        RenderTexture2D mini = LoadRenderTexture(miniWidth, miniHeight); // downscaled room texture
-        BeginTextureMode(normal);
-        ClearBackground(BLANK);
-        for (size_t layerIndex = 0; layerIndex < tileMap->layers.size(); ++layerIndex) {
-            const auto& layer = tileMap->getLayer(layerIndex);
-            if (!layer.visible) continue;
-            for (size_t y = 0; y < tileMap->height; ++y) {
-                for (size_t x = 0; x < tileMap->width; ++x) {
-                    if (!layer.data[y][x]) continue;
-                    // sample the source rect from the normally sized Tilemap
-                    size_t tileIndex = static_cast<size_t>(layer.data[y][x] - 1);
-                    float tileX = static_cast<float>(tileIndex % tilesPerRow) * tileSize;
-                    float tileY = (static_cast<float>(tileIndex) / static_cast<float>(tilesPerRow)) * tileSize;
-                    Rectangle src = { tileX, tileY, (float)tileSize, (float)tileSize };
-
-                    float px = static_cast<float>(x) * static_cast<float>(tileSize);
-                    float py = static_cast<float>(y) * static_cast<float>(tileSize);
-                    Rectangle dst = { px, py, tileSize, tileSize };
-                    // draw the tile
-                    DrawTexturePro(texture, src, dst, { 0, 0 }, 0.0f, WHITE);
-                }
-            }
-        }
-        EndTextureMode();
-        // draw to the small surface
-        BeginTextureMode(mini);
-        // TODO: testing modal filtering for less noisy images
-        Image fullImg = LoadImageFromTexture(normal.texture);
-        Color* pixels = LoadImageColors(fullImg);
-        size_t tilesX = tilemapSize.first / tileSize;
-        size_t tilesY = tilemapSize.second / tileSize;
-
-        BeginTextureMode(mini);
-        ClearBackground(BLANK);
-        for (size_t ty = 0; ty < tilesY; ++ty) {
-            for (size_t tx = 0; tx < tilesX; ++tx) {
-                std::unordered_map<unsigned int, int> colorCount; // hash table that counts pixel colors
-                for (size_t py = 0; py < tileSize; ++py) {
-                    for (size_t px = 0; px < tileSize; ++px) {
-                        size_t ix = tx * tileSize + px;
-                        size_t iy = ty * tileSize + py;
-                        Color c = pixels[iy * fullImg.width + ix];
-                        uint32_t key = *(uint32_t*)&c; // use raw bytes of color as hash
-                        colorCount[key]++;
-                    }
-                }
-                // find most frequent color in hash table
-                int maxCount = 0;
-                Color mode = BLANK;
-                for (const auto& [key, count] : colorCount) {
-                    if (count > maxCount) {
-                        maxCount = count;
-                        mode = *(Color*)&key;
-                    }
-                }
-                float sx = static_cast<float>(tx) * (static_cast<float>(mini.texture.width) / static_cast<float>(tilesX));
-                float sy = static_cast<float>(ty) * (static_cast<float>(mini.texture.height) / static_cast<float>(tilesY));
-                float sw = static_cast<float>(mini.texture.width) / static_cast<float>(tilesX);
-                float sh = static_cast<float>(mini.texture.height) / static_cast<float>(tilesY);
-                DrawRectangleRec({ sx, sy, sw, sh }, mode);
-            }
+        minimapRects[i] = { (float)penX, (float)penY, (float)w, (float)h };
+        penX += w;
+        shelfHeight = std::max(shelfHeight, h);
+        atlasWidth = std::max(atlasWidth, penX);
+    }
+    int atlasHeight = penY + shelfHeight;
+    if (atlasWidth == 0 || atlasHeight == 0) return;
+
+    Image atlas = GenImageColor(atlasWidth, atlasHeight, BLANK);
+    Color* pixels = static_cast<Color*>(atlas.data);
+
+    for (size_t i = 0; i < rooms.size(); i++) {
+        if (!rooms[i]) continue;
+        const Room& room = *rooms[i];
+        const TileMap& tileMap = room.getTemplate();
+        const Tileset& tileset = game.loader.getTileset(tileMap.getTilesetName());
+        const auto& colors = tileset.tileColors;
+        int ox = static_cast<int>(minimapRects[i].x);
+        int oy = static_cast<int>(minimapRects[i].y);
+
+        // the topmost visible tile with an opaque colour wins,
+        // so the layers are painted bottom to top (the atlas starts out BLANK)
+        for (size_t layer = 0; layer < tileMap.layers.size(); layer++) {
+            if (!tileMap.layers[layer].visible) continue;
+            room.forEachTile(layer, [&](int x, int y, uint16_t id) {
+                if (static_cast<size_t>(x) >= tileMap.width || static_cast<size_t>(y) >= tileMap.height) return;
+                if (id > colors.size() || colors[id - 1].a == 0) return;
+                pixels[(oy + y) * atlasWidth + ox + x] = colors[id - 1];
+                });
         }
-        EndTextureMode();
-        UnloadImageColors(pixels);
-        UnloadImage(fullImg);
+    }
 
-        minimapTextures.push_back(mini);
+    if (minimapAtlas.id != 0) UnloadTexture(minimapAtlas);
+    minimapAtlas = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+    TraceLog(LOG_INFO, "Mini map atlas (%dx%d) for %zux%zu rooms built in %.2f ms",
+        atlasWidth, atlasHeight, roomsW, roomsH, (GetTime() - startTime) * 1000.0);
+}
+
+void Dungeon::logMemoryUsage() const
+{
+    std::unordered_set<const TileMap*> templates;
+    size_t roomCount = 0, roomBytes = 0, templateBytes = 0;
+    for (const auto& room : rooms) {
+        if (!room) continue;
+        roomCount++;
+        roomBytes += room->memoryUsage();
+        if (templates.insert(&room->getTemplate()).second) templateBytes += room->getTemplate().memoryUsage();
     }
+    TraceLog(LOG_INFO, "Dungeon: %zu rooms from %zu templates, %zu bytes of templates + %zu bytes of room data",
+        roomCount, templates.size(), templateBytes, roomBytes);
 }
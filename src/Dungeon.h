@@ -3,6 +3,8 @@
 #include <vector>
 #include <optional>
 #include <unordered_map>
+#include <algorithm>
+#include <tuple>
 #include "TileMap.h"
 #include <raylib.h>
 #include "json.hpp"
@@ -33,18 +35,70 @@ inline void from_json(const nlohmann::json& jsonInput, ObjectState& state) {
 }
 
 
+struct TileEdit {
+    // one changed tile of a room, relative to the room's template map
+    uint32_t layer;
+    uint16_t x, y;
+    uint16_t id;
+
+    // by layer, then row major (the order TileLayer::forEachTile visits the tiles in), the id doesn't count
+    bool operator<(const TileEdit& other) const { return std::tie(layer, y, x) < std::tie(other.layer, other.y, other.x); }
+};
+
 class Room {
 public:
     uint8_t doors; // 4-bit mask with one bit for each cardinal direction, starting at the right and going counter clockwise
-    TileMap tilemap;
     uint8_t state = 1;
     bool visited = false;
     bool dark = false; // in dark rooms, the player needs a lamp
     std::unordered_map<uint32_t, ObjectState> objectStates; // makes object states (dead etc) persistent
 
-    Room(TileMap tilemap, uint8_t doors = 0b0000)
-        : doors(doors), tilemap(std::move(tilemap)) {
+    // the map is owned by the AssetLoader and shared by all rooms made from the same template
+    Room(const TileMap& tilemap, uint8_t doors = 0b0000)
+        : doors(doors), tilemap(&tilemap) {
     }
+
+    // the shared map without the edits, for the size, objects and layer settings
+    // the tiles have to be read with getTile and forEachTile, which look at the edits first
+    const TileMap& getTemplate() const { return *tilemap; }
+    uint16_t getTile(size_t layer, int x, int y) const; // 0 outside of the layer
+    // every cell has at most one edit: setting it again replaces the id, setting the template's id removes the edit
+    void setTile(size_t layer, int x, int y, uint16_t id);
+    const std::vector<TileEdit>& getTileEdits() const { return tileEdits; }
+    size_t memoryUsage() const; // bytes that belong to this room only (not the template)
+
+    // calls f(x, y, id) for every non-empty tile of a layer in [x0, x1) x [y0, y1) with the edits applied, row by row
+    template <typename F>
+    void forEachTile(size_t layer, int x0, int y0, int x1, int y1, F&& f) const {
+        if (layer >= tilemap->layers.size()) return;
+        // the edits of the layer are sorted the same way, so they are merged in while walking the template's tiles
+        auto edit = std::lower_bound(tileEdits.begin(), tileEdits.end(),
+            TileEdit{ static_cast<uint32_t>(layer), 0, static_cast<uint16_t>(std::clamp(y0, 0, 0xFFFF)), 0 });
+        auto end = std::lower_bound(edit, tileEdits.end(), TileEdit{ static_cast<uint32_t>(layer) + 1, 0, 0, 0 });
+        // edits in cells that come before (x, y), these are empty in the template
+        auto editsBefore = [&](int x, int y) {
+            for (; edit != end && (edit->y < y || (edit->y == y && edit->x < x)); ++edit) {
+                if (edit->id && edit->y < y1 && edit->x >= x0 && edit->x < x1) f(edit->x, edit->y, edit->id);
+            }
+        };
+        tilemap->layers[layer].forEachTile(x0, y0, x1, y1, [&](int x, int y, uint16_t id) {
+            editsBefore(x, y);
+            if (edit != end && edit->y == y && edit->x == x) {
+                id = edit->id;
+                ++edit;
+            }
+            if (id) f(x, y, id);
+            });
+        editsBefore(0, y1);
+    }
+    template <typename F>
+    void forEachTile(size_t layer, F&& f) const {
+        forEachTile(layer, 0, 0, static_cast<int>(tilemap->width), static_cast<int>(tilemap->height), std::forward<F>(f));
+    }
+
+private:
+    const TileMap* tilemap;
+    std::vector<TileEdit> tileEdits; // sorted (see TileEdit), this is all the tile data a room has of its own
 };
 
 class Dungeon {
@@ -59,6 +113,9 @@ private:
 
 public:
     Dungeon(Game& game, size_t roomsW, size_t roomsH);
+    ~Dungeon();
+    Dungeon(const Dungeon&) = delete; // owns the mini map texture
+    Dungeon& operator=(const Dungeon&) = delete;
     std::vector<std::optional<Room>>& getRooms();
     void setStartingRoomIndex(size_t idx); // defines in which room the player starts;
     void setCurrentRoomIndex(size_t idx) { currentRoomIndex = idx; } // defines which room (on the grid) the player is currently in
@@ -71,11 +128,15 @@ public:
     uint8_t getRoomDoors(size_t index); // TODO: might make a single getter for "Room"...
     std::unordered_map<uint32_t, ObjectState>& getCurrentRoomObjectStates();
     const TileMap* loadCurrentTileMap(); // TODO: does this load or get?
+    const Room* getCurrentRoom() const; // nullptr if there is none
     void insertRoom(size_t row, size_t col, Room&& room);
     std::pair<size_t, size_t> getSize() const;  // gets ( rooms wide, rooms high )
     std::pair<size_t, size_t> getRoomSize(size_t index) const; // gets the width and height of the room in pixels
     bool hasVisited(size_t index) const;
     void setVisited(size_t index);
-    std::vector<RenderTexture2D> minimapTextures;
+    // mini maps of all rooms share one texture, one pixel per tile
+    Texture2D minimapAtlas = { 0 };
+    std::vector<Rectangle> minimapRects; // source rect in the atlas for each room index, empty for nonexistent rooms
     void makeMinimapTextures();
+    void logMemoryUsage() const; // templates (shared) and per room data
 };
\ No newline at end of file
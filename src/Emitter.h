@@ -1,12 +1,14 @@
 #pragma once
 
 #include <vector>
-#include <random>
+#include <cstdint>
 #include "raymath.h"
 #include "Particle.h"
+#include "Utils.h"
 
 struct Emitter {
     // emits a certain type of Particle
+    // emitters are owned and recycled by the ParticleSystem, don't create them yourself
     Vector2 location = { 0.0f, 0.0f };
     float spawnInterval = 1.0f;
     float timeSinceLastSpawn = 0.0f;
@@ -20,15 +22,22 @@ struct Emitter {
     float lifetimeVariance = 0.0f;
     float alphaVariance = 0.0f;
 
-    std::vector<Particle> particles;
-    size_t maxParticles;
+    std::vector<Particle> particles; // the capacity is kept when the emitter gets recycled
+    size_t maxParticles = 0;
+    size_t activeParticles = 0;
 
     Particle prototype;
 
-    std::mt19937 rng;
+    // bookkeeping for the ParticleSystem
+    uint32_t presetIndex = 0;
+    uint32_t generation = 0;
+    bool alive = false; // false while it sits in the free list
+    bool released = false; // the owner doesn't need it anymore, stops emitting and retires when empty
 
-    Emitter(size_t maxParticles);
-    void emit();
-    void update(float deltaTime);
-    void draw();
+    bool isEmitting() const { return !released && (emitterLifetime <= 0.0f || age < emitterLifetime); }
+    bool isFinished() const { return !isEmitting() && activeParticles == 0; }
+
+    bool emit(FastRandom& rng); // returns false if all particle slots are in use
+    size_t updateParticles(float deltaTime); // returns how many particles died this frame
+    void draw(RenderSnapshot& out) const;
 };
@@ -0,0 +1,122 @@
+#pragma once
+#include <any>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "InplaceFunction.h"
+
+// the listeners of one typed event (see EventManager::emit/subscribe), kept in one contiguous array
+// listeners may subscribe and unsubscribe (themselves or others) while the event is dispatched,
+// new ones only get the next event and removed ones are compacted away afterwards
+// the string-keyed listeners use EventChannel<std::any>, one channel per key
+
+class EventChannelBase {
+public:
+    virtual ~EventChannelBase() = default;
+    virtual void dispatchAny(const std::any& value) = 0; // for string-keyed pushEvent calls, ignores other payload types
+    virtual bool unsubscribe(uint32_t handle) = 0;
+    virtual size_t size() const = 0;
+    virtual void clear() = 0;
+};
+
+template <typename E>
+class EventChannel : public EventChannelBase {
+public:
+    using Callback = InplaceFunction<void(const E&), 48>;
+
+    // a once listener is removed before its callback runs
+    void subscribe(uint32_t handle, Callback callback, bool once = false) {
+        (dispatching ? pending : listeners).push_back(Listener{ handle, once, std::move(callback) });
+    }
+
+    void dispatch(const E& event) {
+        dispatching++;
+        // listeners added during the dispatch are in pending, so the count doesn't change
+        for (size_t i = 0; i < listeners.size(); ++i) {
+            Listener& listener = listeners[i];
+            if (listener.handle == 0) continue;
+            if (listener.once) {
+                listener.handle = 0;
+                removed = true;
+            }
+            listener.callback(event);
+        }
+        if (--dispatching == 0) flush();
+    }
+
+    void dispatchAny(const std::any& value) override {
+        if (const E* event = std::any_cast<E>(&value)) dispatch(*event);
+    }
+
+    bool unsubscribe(uint32_t handle) override {
+        for (auto* list : { &listeners, &pending }) {
+            for (Listener& listener : *list) {
+                if (listener.handle != handle) continue;
+                // the callback might be running right now, it is only destroyed in flush()
+                listener.handle = 0;
+                removed = true;
+                if (!dispatching) flush();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isDispatching() const { return dispatching > 0; }
+
+    size_t size() const override {
+        size_t count = 0;
+        for (const Listener& listener : listeners) count += listener.handle != 0;
+        for (const Listener& listener : pending) count += listener.handle != 0;
+        return count;
+    }
+
+    void clear() override {
+        for (Listener& listener : listeners) listener.handle = 0;
+        pending.clear();
+        removed = true;
+        if (!dispatching) flush();
+    }
+
+private:
+    struct Listener {
+        uint32_t handle; // 0 = removed
+        bool once;
+        Callback callback;
+    };
+    std::vector<Listener> listeners;
+    std::vector<Listener> pending; // subscribed during a dispatch
+    int dispatching = 0; // > 1 if the event is emitted again from one of its listeners
+    bool removed = false;
+
+    void flush() {
+        if (removed) {
+            size_t kept = 0;
+            for (size_t i = 0; i < listeners.size(); ++i) {
+                if (listeners[i].handle == 0) continue;
+                if (kept != i) listeners[kept] = std::move(listeners[i]);
+                kept++;
+            }
+            listeners.erase(listeners.begin() + kept, listeners.end());
+            removed = false;
+        }
+        for (Listener& listener : pending) {
+            if (listener.handle != 0) listeners.push_back(std::move(listener));
+        }
+        pending.clear();
+    }
+};
+
+namespace detail {
+    // dense index per event type, used to find the channel without hashing
+    inline size_t nextEventIndex() {
+        static std::atomic<size_t> next{ 0 };
+        return next++;
+    }
+
+    template <typename E>
+    size_t eventIndex() {
+        static const size_t index = nextEventIndex();
+        return index;
+    }
+}
@@ -1,76 +1,161 @@
 #include "EventManager.h"
 #include "Utils.h"
+#include "Profiler.h"
+#include <algorithm>
 
 
-EventManager::EventManager() : events{}, listeners{}, delayedEvents{} {}
+EventManager::EventManager() : listeners{} {}
 
-void EventManager::pushEvent(const std::string& key, std::any value) {
-    events[key] = value;
-    // also call the listeners
+void EventManager::pushEvent(StringId key, std::any value) {
+    PROFILE_ZONE("dispatch");
+    // call the listeners
     auto it = listeners.find(key);
     if (it != listeners.end()) {
-        for (auto& callback : it->second) {
-            callback(value);
-        }
+        it->second->dispatch(value);
+        eraseIfEmpty(key); // once listeners
+    }
+    // migration shim: typed listeners of an event with this id, if the value is that event struct
+    auto typed = typedKeys.find(key);
+    if (typed != typedKeys.end()) {
+        typed->second->dispatchAny(value);
     }
 }
 
-void EventManager::pushDelayedEvent(const std::string& key, float delay, std::any value, std::function<void()> callback) {
-    delayedEvents.push_back({ key, delay, value, callback });
+TimerHandle EventManager::pushDelayedEvent(StringId key, float delay, std::any value, std::function<void()> callback) {
+    Scheduler::Timer timer;
+    timer.key = key;
+    timer.value = std::move(value);
+    timer.callback = std::move(callback);
+    return scheduler.add(delay, std::move(timer));
 }
 
-void EventManager::addListener(const std::string& key, std::function<void(std::any)> callback) {
-    TraceLog(LOG_INFO, "Adding a event listener for %s", key.c_str());
-    listeners[key].push_back(callback);
-    TraceLog(LOG_INFO, "Listener count for %s: %zu", key.c_str(), listeners[key].size());
+uint32_t EventManager::addListener(std::string_view key, std::function<void(std::any)> callback, bool once) {
+    StringId id = StringId::intern(key);
+    TraceLog(LOG_INFO, "Adding a event listener for %s", id.str());
+    auto& channel = listeners[id];
+    if (!channel) channel = std::make_unique<EventChannel<std::any>>();
+    uint32_t handle = nextHandle++;
+    channel->subscribe(handle, std::move(callback), once);
+    TraceLog(LOG_INFO, "Listener count for %s: %zu", id.str(), channel->size());
+    return handle;
 }
 
-void EventManager::pushConditionalEvent(std::function<bool()> condition, std::function<void()> callback) {
-    conditionalEvents.push_back({ condition, callback });
+Subscription EventManager::listen(std::string_view key, std::function<void(std::any)> callback, bool once) {
+    uint32_t handle = addListener(key, std::move(callback), once);
+    return Subscription(this, StringId(key), handle);
 }
 
-void EventManager::pushRepeatedEvent(const std::string& key, float interval, std::any value, std::function<void()> callback, int numRepeats, std::function<void()> onComplete) {
-    repeatedEvents.push_back({ key, interval, interval, value, callback, numRepeats, onComplete });
+bool EventManager::removeListener(StringId key, uint32_t handle) {
+    auto it = listeners.find(key);
+    if (it != listeners.end() && it->second->unsubscribe(handle)) {
+        eraseIfEmpty(key);
+        return true;
+    }
+    auto typed = typedKeys.find(key);
+    return typed != typedKeys.end() && typed->second->unsubscribe(handle);
 }
 
-void EventManager::cancelRepeatedEvent(const std::string& key) {
-    for (auto it = repeatedEvents.begin(); it != repeatedEvents.end(); ) {
-        if (it->key == key) {
-            it = repeatedEvents.erase(it);
-        }
-        else {
-            ++it;
-        }
+void EventManager::eraseIfEmpty(StringId key) {
+    auto it = listeners.find(key);
+    // a channel that is dispatching right now is erased by that dispatch when it's done
+    if (it != listeners.end() && !it->second->isDispatching() && it->second->size() == 0) {
+        listeners.erase(it);
     }
 }
 
-void EventManager::removeListeners(const std::string& key) {
-    listeners.erase(key);
+void Subscription::reset() {
+    if (manager) manager->removeListener(key, handle);
+    manager = nullptr;
+    handle = 0;
+}
+
+void EventManager::logListenerCounts() const {
+    std::vector<std::pair<StringId, size_t>> counts;
+    size_t total = 0;
+    for (const auto& [key, channel] : listeners) {
+        if (channel->size() > 0) counts.emplace_back(key, channel->size());
+    }
+    for (const auto& [key, channel] : typedKeys) {
+        if (channel->size() > 0) counts.emplace_back(key, channel->size());
+    }
+    std::sort(counts.begin(), counts.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    for (const auto& [key, count] : counts) {
+        TraceLog(LOG_INFO, "EVENTS: %4zu %s", count, key.str());
+        total += count;
+    }
+    TraceLog(LOG_INFO, "EVENTS: %zu listeners for %zu keys", total, counts.size());
+}
+
+void EventManager::pushConditionalEvent(std::function<bool()> condition, std::function<void()> callback, uint32_t signals) {
+    conditionalEvents.push_back({ condition, callback, signals });
+    if (signals == SIGNAL_EVERY_FRAME) pollingConditions++;
+    newConditions = true;
+}
+
+TimerHandle EventManager::pushRepeatedEvent(StringId key, float interval, std::any value, std::function<void()> callback, int numRepeats, std::function<void()> onComplete) {
+    Scheduler::Timer timer;
+    timer.key = key;
+    timer.value = std::move(value);
+    timer.callback = std::move(callback);
+    timer.interval = interval;
+    timer.repeatsLeft = numRepeats;
+    timer.onComplete = std::move(onComplete);
+    return scheduler.add(interval, std::move(timer));
+}
+
+bool EventManager::cancelTimedEvent(TimerHandle handle) {
+    return scheduler.cancel(handle);
+}
+
+void EventManager::removeListeners(StringId key) {
+    auto it = listeners.find(key);
+    if (it == listeners.end()) return;
+    it->second->clear();
+    eraseIfEmpty(key);
 }
 
 void EventManager::clearAll() {
-    listeners.clear();
-    delayedEvents.clear();
+    for (auto it = listeners.begin(); it != listeners.end(); ) {
+        it->second->clear();
+        if (it->second->isDispatching()) ++it;
+        else it = listeners.erase(it);
+    }
+    for (auto& typedChannel : channels) {
+        if (typedChannel) typedChannel->clear();
+    }
+    scheduler.clear();
     conditionalEvents.clear();
+    pollingConditions = 0;
 }
 
 void EventManager::update(float deltaTime) {
-    for (auto it = delayedEvents.begin(); it != delayedEvents.end(); ) {
-        it->timeRemaining -= deltaTime;
-        if (it->timeRemaining <= 0.0f) {
-            if (it->callback) {
-                it->callback();
-            }
-            pushEvent(it->key, it->value);
-            it = delayedEvents.erase(it);
+    PROFILE_ZONE("events");
+    scheduler.update(deltaTime, [this](Scheduler::Timer& timer) {
+        if (timer.callback) {
+            timer.callback();
         }
-        else {
-            ++it;
-        }
-    }
+        pushEvent(timer.key, timer.value);
+        });
 
+    // conditions are only checked when something they depend on has changed
+    uint32_t signals = pendingSignals;
+    pendingSignals = 0;
+    if (signals == 0 && pollingConditions == 0 && !newConditions) {
+        conditionStats.skipped += conditionalEvents.size();
+        return;
+    }
+    newConditions = false;
     for (auto it = conditionalEvents.begin(); it != conditionalEvents.end(); ) {
+        bool check = it->dirty || it->signals == SIGNAL_EVERY_FRAME || (it->signals & signals) != 0;
+        it->dirty = false;
+        if (!check) {
+            conditionStats.skipped++;
+            ++it;
+            continue;
+        }
+        conditionStats.evaluated++;
         if (it->condition()) {
+            if (it->signals == SIGNAL_EVERY_FRAME) pollingConditions--;
             it->callback();
             it = conditionalEvents.erase(it);
         }
@@ -78,25 +163,4 @@ void EventManager::update(float deltaTime) {
             ++it;
         }
     }
-
-    for (auto it = repeatedEvents.begin(); it != repeatedEvents.end(); ) {
-        it->timeRemaining -= deltaTime;
-        if (it->timeRemaining <= 0.0f) {
-            // repeated callback
-            if (it->callback) {
-                it->callback();
-            }
-            pushEvent(it->key, it->value);
-            it->timeRemaining += it->interval;
-            if (--it->repeatsLeft <= 0) {
-                // callback on completion
-                if (it->onComplete) {
-                    it->onComplete();
-                }
-                it = repeatedEvents.erase(it);
-                continue;
-            }
-        }
-        ++it;
-    }
 }
@@ -6,69 +6,128 @@
 #include <any>
 #include <string>
 #include <optional>
+#include <string_view>
+#include <memory>
+#include "StringId.h"
+#include "EventChannel.h"
+#include "Scheduler.h"
+#include "Subscription.h"
+#include "Profiler.h"
+
+// what the condition of a conditional event depends on, raised with EventManager::raiseSignal
+// conditions are only checked again after one of their signals was raised
+enum EventSignal : uint32_t {
+    SIGNAL_ROOM_CHANGED = 1 << 0,
+    SIGNAL_INVENTORY_CHANGED = 1 << 1,
+    SIGNAL_SPRITE_DEFEATED = 1 << 2, // a defeated sprite was removed from the game
+    SIGNAL_ROOM_STATE_CHANGED = 1 << 3,
+    SIGNAL_EVERY_FRAME = 0xFFFFFFFF // depends on something else, checked every frame
+};
+
+struct ConditionStats {
+    // totals since the start
+    size_t evaluated = 0;
+    size_t skipped = 0; // conditions that weren't checked because none of their signals was raised
+};
 
 
 class EventManager {
 private:
-    // store a list of events (key : data), data can be of any type or NULL
-    std::unordered_map<std::string, std::any> events;
     // store a list of event listeners (callbacks that are triggered by an event with that key)
-    std::unordered_map<std::string, std::vector<std::function<void(std::any)>>> listeners;
+    // keys without listeners are erased, so one-off keys like "killSprite_<address>" don't pile up
+    std::unordered_map<StringId, std::unique_ptr<EventChannel<std::any>>> listeners;
+    void eraseIfEmpty(StringId key);
 
-    // callbacks that fire after a given amount of time
-    struct TimedEvent {
-        std::string key;
-        float timeRemaining;
-        std::any value;
-        std::function<void()> callback;
-    };
-    std::vector<TimedEvent> delayedEvents;
+    // typed events (emit/subscribe), one channel per event struct, indexed by detail::eventIndex<E>()
+    std::vector<std::unique_ptr<EventChannelBase>> channels;
+    std::unordered_map<StringId, EventChannelBase*> typedKeys; // E::id -> channel, so pushEvent reaches typed listeners
+    uint32_t nextHandle = 1;
+
+    template <typename E>
+    EventChannel<E>& channel() {
+        size_t index = detail::eventIndex<E>();
+        if (index >= channels.size()) channels.resize(index + 1);
+        if (!channels[index]) {
+            channels[index] = std::make_unique<EventChannel<E>>();
+            typedKeys[StringId::intern(E::name)] = channels[index].get();
+        }
+        return static_cast<EventChannel<E>&>(*channels[index]);
+    }
+
+    // delayed and repeated events (callbacks that fire after a given amount of time)
+    Scheduler scheduler;
 
     // events that allow for arbitrary conditions to be checked
     struct ConditionalEvent {
         std::function<bool()> condition;
         std::function<void()> callback;
+        uint32_t signals;
+        bool dirty = true; // checked once after it was added
     };
     std::vector<ConditionalEvent> conditionalEvents;
+    uint32_t pendingSignals = 0;
+    size_t pollingConditions = 0; // SIGNAL_EVERY_FRAME
+    bool newConditions = false;
+    ConditionStats conditionStats;
 
-    // events that repeat
-    struct RepeatedEvent {
-        std::string key;
-        float interval;
-        float timeRemaining;
-        std::any value;
-        std::function<void()> callback;
-        int repeatsLeft;
-        std::function<void()> onComplete;
-    };
-    std::vector<RepeatedEvent> repeatedEvents;
 
 public:
     EventManager();
-    void pushEvent(const std::string& key, std::any value = std::any{});
-    void pushDelayedEvent(const std::string& key, float delay, std::any value, std::function<void()> callback = nullptr);
-    void pushRepeatedEvent(const std::string& key, float interval, std::any value, std::function<void()> callback, int numRepeats, std::function<void()> onComplete = nullptr);
-    void addListener(const std::string& key, std::function<void(std::any)> callback);
-    void removeListeners(const std::string& key);
-    void cancelRepeatedEvent(const std::string& key);
+    // keys can be strings or "literal"_id, only addListener needs the name (it interns it for the logs)
+    void pushEvent(StringId key, std::any value = std::any{});
+    // the handle can be used to cancel the event before it fires
+    TimerHandle pushDelayedEvent(StringId key, float delay, std::any value, std::function<void()> callback = nullptr);
+    TimerHandle pushRepeatedEvent(StringId key, float interval, std::any value, std::function<void()> callback, int numRepeats, std::function<void()> onComplete = nullptr);
+    // a once listener is removed after the first event, the handle can be passed to removeListener
+    uint32_t addListener(std::string_view key, std::function<void(std::any)> callback, bool once = false);
+    // like addListener, but the listener is removed when the Subscription is destroyed
+    // keep it in the subscriptions of the sprite or scene that the callback uses
+    [[nodiscard]] Subscription listen(std::string_view key, std::function<void(std::any)> callback, bool once = false);
+    bool removeListener(StringId key, uint32_t handle); // string or typed listener
+    void removeListeners(StringId key);
+    void logListenerCounts() const; // debug: live listeners per key
+    bool cancelTimedEvent(TimerHandle handle); // delayed or repeated, false if it already fired
     void update(float deltaTime); // used to advance timers
 
-    void pushConditionalEvent(std::function<bool()> condition, std::function<void()> callback);
+    void pushConditionalEvent(std::function<bool()> condition, std::function<void()> callback, uint32_t signals = SIGNAL_EVERY_FRAME);
+    void raiseSignal(uint32_t signals) { pendingSignals |= signals; } // the conditions are checked in the next update
+    const ConditionStats& getConditionStats() const { return conditionStats; }
 
     void clearAll();
 
-    // Get all events (for direct iteration in the scene)
-    const std::unordered_map<std::string, std::any>& peekEvents() const {
-        return events;
+    // typed events: E is a struct with a static constexpr StringId id (see GameEvents.h)
+    // emit builds the event on the stack and calls the listeners directly, nothing is allocated
+    // (callbacks with captures up to 48 bytes are stored inline)
+    // returns a handle for unsubscribe
+    template <typename E, typename F>
+    uint32_t subscribe(F&& callback, bool once = false) {
+        uint32_t handle = nextHandle++;
+        channel<E>().subscribe(handle, typename EventChannel<E>::Callback(std::forward<F>(callback)), once);
+        return handle;
+    }
+
+    template <typename E, typename F>
+    [[nodiscard]] Subscription listen(F&& callback, bool once = false) {
+        return Subscription(this, E::id, subscribe<E>(std::forward<F>(callback), once));
     }
 
-    std::unordered_map<std::string, std::any> popEvents() {
-        std::unordered_map<std::string, std::any> popped = std::move(events);
-        events.clear();
-        return popped;
+    template <typename E>
+    bool unsubscribe(uint32_t handle) {
+        return channel<E>().unsubscribe(handle);
     }
 
-    void clearEvent(const std::string& key) {
-        events.erase(key);
+    template <typename E, typename... Args>
+    void emit(Args&&... args) {
+        PROFILE_ZONE("dispatch");
+        const E event{ std::forward<Args>(args)... };
+        channel<E>().dispatch(event);
+        // migration shim: listeners that were added with the string key still get the event (as std::any)
+        if (!listeners.empty()) {
+            auto it = listeners.find(E::id);
+            if (it != listeners.end()) {
+                it->second->dispatch(std::any(event));
+                eraseIfEmpty(E::id);
+            }
+        }
     }
 };
\ No newline at end of file
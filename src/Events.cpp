@@ -6,6 +6,7 @@
 
 // any InGame events (like cutscenes) that are triggered by some condition
 // once triggered, they never trigger again
+// the signals say what a condition depends on, it is only checked again when one of them was raised
 
 void setupConditionalEvents(InGame& inGame) {
     auto& game = inGame.getGame();
@@ -19,7 +20,8 @@ void setupConditionalEvents(InGame& inGame) {
         },
         [&]() {
             game.currentDungeon->advanceRoomState(14);
-        }
+        },
+        SIGNAL_ROOM_CHANGED | SIGNAL_INVENTORY_CHANGED
     );
 
     game.eventManager.pushConditionalEvent(
@@ -31,9 +33,9 @@ void setupConditionalEvents(InGame& inGame) {
         [&]() {
             if (inGame.spriteMap.find("elfCompanion2") == inGame.spriteMap.end())
                 return;
-            game.eventManager.pushDelayedEvent("dungeon001HasSword", 0.1f, nullptr, [&]() {
+            game.eventManager.pushDelayedEvent("dungeon001HasSword"_id, 0.1f, nullptr, [&]() {
                 Sprite& npcRef = *inGame.spriteMap["elfCompanion2"];               
-                game.eventManager.pushEvent("hideHUD");
+                game.eventManager.pushEvent("hideHUD"_id);
                 game.cutsceneManager.queueCommand(new Command_Letterbox(float(game.gameScreenWidth), float(game.gameScreenHeight), 1.0f), false);
                 float npcX = 12.0f * static_cast<float>(inGame.tileSize);
                 float npcY = 8.0f * static_cast<float>(inGame.tileSize);
@@ -42,7 +44,7 @@ void setupConditionalEvents(InGame& inGame) {
                 game.cutsceneManager.queueCommand(new Command_Wait(0.5f));
                 game.cutsceneManager.queueCommand(new Command_Textbox(game, "Is that a sword? Great! I'll follow you, now we can fight our way out of here.", "powerUp4", true)); // TODO pass a key to a text in texts.json instead of the actual dialogue string... 
                 game.cutsceneManager.queueCommand(new Command_Callback([&]() {
-                    game.eventManager.pushEvent("showHUD");
+                    game.eventManager.pushEvent("showHUD"_id);
                     game.currentDungeon->advanceRoomState();
                     if (!npcRef.persistent) {
                         npcRef.persistent = true;
@@ -52,7 +54,8 @@ void setupConditionalEvents(InGame& inGame) {
                     }
                     }));
                 });
-        }
+        },
+        SIGNAL_ROOM_CHANGED | SIGNAL_INVENTORY_CHANGED
     );
 
     game.eventManager.pushConditionalEvent(
@@ -68,21 +71,22 @@ void setupConditionalEvents(InGame& inGame) {
         },
         [&]() {
             TraceLog(LOG_INFO, "enemies defeated");
-            game.eventManager.pushDelayedEvent("defeatDialog", 0.1f, nullptr, [&]() {
-                game.eventManager.pushEvent("hideHUD");
+            game.eventManager.pushDelayedEvent("defeatDialog"_id, 0.1f, nullptr, [&]() {
+                game.eventManager.pushEvent("hideHUD"_id);
                 game.cutsceneManager.queueCommand(new Command_CameraPan(game, 110.0f, 20.0f, 2.0f));
                 game.cutsceneManager.queueCommand(new Command_Wait(0.5f));
                 game.cutsceneManager.queueCommand(new Command_Callback([&]() {
-                    game.eventManager.pushEvent("door004open");
-                    game.playSound("doorOpen_2");
+                    game.eventManager.pushEvent("door004open"_id);
+                    game.playSound("doorOpen_2"_id);
                     }));
                 game.cutsceneManager.queueCommand(new Command_Wait(1.5f));
                 game.cutsceneManager.queueCommand(new Command_Callback([&]() {
-                    game.eventManager.pushEvent("showHUD");
+                    game.eventManager.pushEvent("showHUD"_id);
                     game.cutsceneManager.setCameraControl(false);
                     game.currentDungeon->advanceRoomState();
                     }));
                 });      
-        }
+        },
+        SIGNAL_ROOM_CHANGED | SIGNAL_SPRITE_DEFEATED | SIGNAL_ROOM_STATE_CHANGED
     );
 }
@@ -11,21 +11,47 @@
 #include "MapUI.h"
 #include "GameOver.h"
 #include "Utils.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#ifdef GAME_HEADLESS
+#include "platform/NullRaylib.h"
+#endif
 #include <sstream>
 #include <fstream>
-
-
-Game::Game() : buttonsDown{}, buttonsPressed{}, inventory(*this) {
+#include <random>
+#include <cstdlib>
+#include <future>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+
+
+Game::Game(const LaunchOptions& options) : launchOptions(options), buttonsDown{}, buttonsPressed{}, inventory(*this) {
+#ifdef GAME_HEADLESS
+    launchOptions.headless = true; // there's nothing else in this build
+#endif
+    // packed assets, built with the pack_assets target (loose files from ./resources are used if it's missing)
+    loader.mountArchive("./resources.pak");
     loader.loadSettings("./resources/settings.json");
     settings = &loader.getSettings();
     TraceLog(LOG_INFO, settings->dump(2).c_str());
-    // Enable config flags for resizable window and vsync
-    SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT);
+    if (launchOptions.headless) {
+        // raylib still needs a window for the GL context, it just isn't shown (and doesn't wait for vsync)
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    }
+    else {
+        // Enable config flags for resizable window and vsync
+        SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT);
+    }
     InitWindow(getSetting("windowWidth"), getSetting("windowHeight"), "My first game");
     SetWindowMinSize(320, 240);
-    InitAudioDevice();
+    if (!launchOptions.headless) InitAudioDevice();
 
-    soundOn = getSetting("soundOn");
+    soundOn = getSetting("soundOn") && !launchOptions.headless;
+    int jobThreads = getSetting("jobThreads");
+    jobs = std::make_unique<JobSystem>(jobThreads < 0 ? ThreadPool::defaultThreadCount() : static_cast<size_t>(jobThreads));
+    particles.setGlobalBudget(getSetting("maxParticles"));
+    Profiler::get().setTraceFrames(getSetting("profilerTraceFrames"));
 
     // Render texture initialization, used to hold the rendering result so we can easily resize it
     // see https://github.com/raysan5/raylib/blob/master/examples/core/core_window_letterbox.c
@@ -33,7 +59,7 @@ Game::Game() : buttonsDown{}, buttonsPressed{}, inventory(*this) {
     gameScreenHeight = getSetting("gameScreenHeight");
     target = LoadRenderTexture(gameScreenWidth, gameScreenHeight);
 
-    SetTargetFPS(getSetting("targetFPS"));
+    SetTargetFPS(launchOptions.headless ? 0 : getSetting("targetFPS").get<int>());
 
     // define all Scenes as factory functions
     // the second argument is priority for the drawing order
@@ -61,6 +87,9 @@ const nlohmann::json& Game::getSetting(const std::string& key) const {
 
 void Game::startScene(const std::string& name) {
     if (sceneRegistry.count(name)) {
+        // the old one could still be drawn on the main thread right now
+        auto old = scenes.find(name);
+        if (old != scenes.end()) replacedScenes.push_back(std::move(old->second));
         scenes[name] = sceneRegistry[name](name);
 
         if (scenePriorities.count(name))
@@ -102,7 +131,14 @@ void Game::resetScenes() {
     }
 }
 
+void Game::startInGame() {
+    startScene("InGame");
+    startScene("HUD");
+}
+
 void Game::processMarkedScenes() {
+    PROFILE_ZONE("marked scenes");
+    replacedScenes.clear();
     for (auto it = scenes.begin(); it != scenes.end(); ) {
         if (it->second->ismarkedForStarting()) {
             TraceLog(LOG_INFO, "starting scene %s", it->second->getName().c_str());
@@ -163,7 +199,7 @@ void Game::load()
         TraceLog(LOG_INFO, jsonData.dump(2).c_str());
 
         savegame = std::make_shared<SaveGame>(readSaveDataFromJSON(jsonData));
-        eventManager.pushEvent("loadingSavegameSuccess");
+        eventManager.pushEvent("loadingSavegameSuccess"_id);
     }
 }
 
@@ -229,6 +265,7 @@ void Game::createDungeon(size_t roomsW, size_t roomsH)
 #endif // TEST_ROOM
 
     currentDungeon->makeMinimapTextures();
+    currentDungeon->logMemoryUsage();
 
     // TODO
     // set the player's starting position correctly
@@ -255,10 +292,15 @@ void Game::clearSprites(bool clearPersistent) {
 }
 
 void Game::processMarkedSprites() {
+    PROFILE_ZONE("marked sprites");
+    bool defeated = false;
     sprites.erase(std::remove_if(sprites.begin(), sprites.end(),
-        [](auto sprite) {
-            return sprite->isMarkedForDeletion();
+        [&defeated](auto sprite) {
+            if (!sprite->isMarkedForDeletion()) return false;
+            defeated = defeated || sprite->dying;
+            return true;
         }), sprites.end());
+    if (defeated) eventManager.raiseSignal(SIGNAL_SPRITE_DEFEATED);
 
     // add any new sprites to the vector
     // TODO: just doing this here, no need for a seperate function I guess
@@ -268,6 +310,42 @@ void Game::processMarkedSprites() {
     spritesToAdd.clear();
 }
 
+bool Game::recordInput(const std::string& path) {
+    return recorder.startRecording(path, std::random_device{}(), getSetting("replayChecksumInterval"));
+}
+
+bool Game::replayInput(const std::string& path) {
+    if (!recorder.startReplay(path)) return false;
+    // the delta times come from the recording, so the frame rate doesn't matter
+    SetTargetFPS(0);
+    ClearWindowState(FLAG_VSYNC_HINT);
+    return true;
+}
+
+uint32_t Game::worldChecksum() const {
+    // FNV-1a over the state the gameplay depends on
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        };
+    uint32_t count = static_cast<uint32_t>(sprites.size());
+    mix(&count, sizeof(count));
+    for (const auto& sprite : sprites) {
+        mix(&sprite->position, sizeof(Vector2));
+        mix(&sprite->vel, sizeof(Vector2));
+        mix(&sprite->health, sizeof(uint32_t));
+    }
+    if (currentDungeon) {
+        uint32_t room = static_cast<uint32_t>(currentDungeon->getCurrentRoomIndex());
+        mix(&room, sizeof(room));
+    }
+    return hash;
+}
+
 Sprite* Game::getPlayer() {
     InGame* inGame = dynamic_cast<InGame*>(getScene("InGame"));
     if (!inGame) return nullptr;
@@ -276,21 +354,54 @@ Sprite* Game::getPlayer() {
     return nullptr;
 }
 
-void Game::playSound(const std::string& key){
+void Game::playSound(StringId key){
     if (!soundOn || !sfxOn) return;
     PlaySound(loader.getSound(key));
 }
 
 void Game::update(float deltaTime) {
+    PROFILE_ZONE("update");
     eventManager.update(deltaTime);
 
     for (auto& [name, scene] : scenes) {
         if (scene && scene->isActive() && !scene->isPaused()) {
+            PROFILE_ZONE(Profiler::name(name));
             scene->update(deltaTime);
         }
     }
 }
 
+void Game::lateUpdate() {
+    PROFILE_ZONE("lateUpdate");
+    for (auto& [name, scene] : scenes) {
+        if (scene && scene->isActive() && !scene->isPaused()) {
+            PROFILE_ZONE(Profiler::name(name));
+            scene->lateUpdate();
+        }
+    }
+}
+
+bool Game::captureScenes() {
+    PROFILE_ZONE("capture");
+    drawOrder.clear();
+    for (auto& [name, scene] : scenes) {
+        if (scene && scene->isActive()) {
+            drawOrder.push_back(scene.get());
+        }
+    }
+    // Sort active scenes by draw priority
+    std::sort(drawOrder.begin(), drawOrder.end(),
+        [](Scene* a, Scene* b) {
+            return a->getDrawPriority() < b->getDrawPriority();
+        });
+    bool complete = true;
+    for (Scene* scene : drawOrder) {
+        PROFILE_ZONE(Profiler::name(scene->getName()));
+        complete = scene->capture() && complete;
+    }
+    return complete;
+}
+
 void Game::playMusic() {
     if (!soundOn || !musicOn) return;
     for (auto& [name, scene] : scenes) {
@@ -304,24 +415,15 @@ void Game::playMusic() {
 }
 
 void Game::draw() {
+    PROFILE_ZONE("draw");
     // Compute required framebuffer scaling
     float scale = std::min((float)GetScreenWidth() / gameScreenWidth, (float)GetScreenHeight() / gameScreenHeight);
     
     // Draw everything in the render texture, note this will not be rendered on screen, yet
     // All the actual drawing logic is handled by each scene
     BeginTextureMode(target);
-        std::vector<Scene*> activeScenes;
-        for (auto& [name, scene] : scenes) {
-            if (scene && scene->isActive()) {
-                activeScenes.push_back(scene.get());
-            }
-        }
-        // Sort active scenes by draw priority
-        std::sort(activeScenes.begin(), activeScenes.end(),
-            [](Scene* a, Scene* b) {
-                return a->getDrawPriority() < b->getDrawPriority();
-            });
-        for (Scene* scene : activeScenes) {
+        for (Scene* scene : drawOrder) {
+            PROFILE_ZONE(Profiler::name(scene->getName()));
             scene->draw();
         }
     EndTextureMode();
@@ -366,7 +468,7 @@ void Game::draw() {
                     s_inactiveScenes += scene->getName() + stateInfo + "\n";
                 }
             }
-            for (Scene* scene : activeScenes) {
+            for (Scene* scene : drawOrder) {
                 s_drawOrder += scene->getName() + " (Priority: " + std::to_string(scene->getDrawPriority()) + ")\n";
             }
 
@@ -388,7 +490,11 @@ void Game::draw() {
             else {
                 DrawText("invalid room index", 4, int(GetScreenHeight() * 0.8f), fontSize, WHITE);
             }
+
+            // zone timings, KP 3 writes them to a trace file (see run)
+            Profiler::get().drawOverlay(int(GetScreenWidth() * 0.45f), int(GetScreenHeight() * 0.3f), 16);
         }
+    PROFILE_ZONE("EndDrawing"); // includes the wait for vsync
     EndDrawing();
 }
 
@@ -401,7 +507,7 @@ void Game::run() {
     // enable saving the game state from any scene
     eventManager.addListener("saveGame", [&](const std::any& data) {
         save();
-        playSound("Rise02");
+        playSound("Rise02"_id);
         });
     // loading a saved game
     // TODO: use data for the file index
@@ -409,13 +515,46 @@ void Game::run() {
         load();
         });
     
+    double replayStart = 0.0;
+    // pipelined frames: the main thread draws the frame that was captured at the end of the last loop
+    // while the simulation thread updates the next one, this only happens if every scene that is drawn
+    // could capture itself (in menus, cutscenes and in debug mode the frame is drawn after the update)
+    pipelinedFrames = getSetting("pipelinedFrames");
+    if (pipelinedFrames) simThread = std::make_unique<ThreadPool>(1);
+    bool captured = false; // all scenes of the last frame are in their snapshots
+    // headless: every update gets the same delta time, as if the game ran at its target frame rate
+    float fixedDeltaTime = 1.0f / getSetting("targetFPS").get<float>();
+    // --ticks counts the frames after loading, like the recordings
+    uint32_t ticks = 0;
+    auto ticksStart = std::chrono::steady_clock::now();
+    PROFILE_THREAD("main");
+
     while (running && !WindowShouldClose()) {
+        // hands the zones of the last loop to the overlay and the trace
+        Profiler::get().endFrame();
+        PROFILE_ZONE("frame");
         // show FPS in title
         snprintf(title, sizeof(title), "My Game - FPS: %d", GetFPS());
         SetWindowTitle(title);
+        float currentTime = float(GetTime());
+        float deltaTime = launchOptions.headless ? fixedDeltaTime : currentTime - lastTime;
+        lastTime = currentTime;
         // get the recently pressed/held down buttons
-        buttonsPressed = GetControlsPressed();
-        buttonsDown = GetControlsDown();
+        InputFrame input{ GetControlsPressed(), GetControlsDown(), deltaTime };
+        // recordings start after the Preload scene, loading takes a different number of frames every time
+        bool recordedFrame = (recorder.isRecording() || recorder.isReplaying()) && !getScene("Preload");
+        if (recordedFrame) {
+            if (recorder.getFrame() == 0) replayStart = GetTime();
+            if (!recorder.beginFrame(input)) {
+                TraceLog(LOG_INFO, "REPLAY: finished after %u frames in %.2f s", recorder.getFrame(), GetTime() - replayStart);
+                recorder.stop();
+                end();
+                break;
+            }
+        }
+        buttonsPressed = input.pressed;
+        buttonsDown = input.down;
+        deltaTime = input.deltaTime;
    
         if (buttonsPressed & CONTROL_DEBUG) debug = !debug; // debug mode toggle
         // specific debug functions
@@ -423,24 +562,70 @@ void Game::run() {
             if (buttonsPressed & CONTROL_DEBUG_K2) {
                 soundOn = !soundOn;
             }
+            if (buttonsPressed & CONTROL_DEBUG_K1) {
+                eventManager.logListenerCounts();
+            }
+            if (buttonsPressed & CONTROL_DEBUG_K3) {
+                std::filesystem::create_directories("./profiles");
+                Profiler::get().dumpTrace("./profiles/trace_" + std::to_string(std::time(nullptr)) + ".json");
+            }
         }
 
-        float currentTime = float(GetTime());
-        float deltaTime = currentTime - lastTime;
-        lastTime = currentTime;
-        update(deltaTime);
-        playMusic();
-        draw();
+        auto simulate = [this, recordedFrame, seed = input.seed, deltaTime]() {
+            if (recordedFrame) {
+                // everything that draws random numbers starts from the same seed in every frame
+                // (on the thread that runs the update, the C runtime of MSVC keeps one rand() state per thread)
+                SetRandomSeed(seed);
+                srand(seed);
+                particles.setSeed(seed);
+            }
+            update(deltaTime);
+            };
+        // one draw per loop, EndDrawing polls the input for the next one
+        bool drawn = pipelinedFrames && captured && !debug;
+        if (drawn) {
+            auto task = std::make_shared<std::packaged_task<void()>>(simulate);
+            std::future<void> updated = task->get_future();
+            simThread->enqueue([task]() {
+                PROFILE_THREAD("simulation");
+                (*task)();
+                });
+            draw(); // the last frame
+            updated.get(); // rethrows what went wrong in the update
+        }
+        else {
+            simulate();
+        }
+        lateUpdate();
 
         // restarting the game (debugging)
-        if (IsKeyPressed(KEY_F5)) {
+        if (IsKeyPressed(KEY_F5) && !recorder.isReplaying()) {
             restart();
         }
         processMarkedSprites();
         processMarkedScenes();
+        captured = captureScenes();
+        playMusic();
+        // (the first frame after a pipelined one that isn't pipelined anymore is skipped)
+        if (!drawn) draw();
+        if (recordedFrame) recorder.endFrame(recorder.wantsChecksum() ? worldChecksum() : 0);
+        if (!getScene("Preload")) {
+            if (ticks == 0) ticksStart = std::chrono::steady_clock::now();
+            if (++ticks == launchOptions.ticks) end();
+        }
+    }
+    if (launchOptions.ticks > 0) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - ticksStart).count();
+        TraceLog(LOG_INFO, "TICKS: %u in %.2f s (%.0f per second)", ticks, seconds, ticks / std::max(seconds, 1e-9));
+#ifdef GAME_HEADLESS
+        const HeadlessStats& stats = GetHeadlessStats();
+        TraceLog(LOG_INFO, "HEADLESS: %llu draw calls, %llu of %llu textures unloaded", (unsigned long long)stats.drawCalls,
+            (unsigned long long)stats.texturesUnloaded, (unsigned long long)stats.texturesLoaded);
+#endif
     }
+    recorder.stop();
     // cleanup after the game loop
     UnloadRenderTexture(target);
-    CloseAudioDevice();
+    if (!launchOptions.headless) CloseAudioDevice();
     CloseWindow();
 }
@@ -1,17 +1,23 @@
 #pragma once
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 #include "Scene.h"
 #include "raylib.h"
 #include "AssetLoader.h"
 #include "Sprite.h"
 #include "EventManager.h"
+#include "GameEvents.h"
 #include "CutsceneManager.h"
 #include "InventoryManager.h"
-#include "Emitter.h"
+#include "ParticleSystem.h"
+#include "TextLayout.h"
 #include "Dungeon.h"
 #include "Savegame.h"
+#include "InputRecorder.h"
+#include "JobSystem.h"
+#include "ThreadPool.h"
 #include "json.hpp"
 #include <stdexcept>
 
@@ -25,12 +31,21 @@
 
 class Command;
 
+// command line options, see Main.cpp
+struct LaunchOptions {
+    bool headless = false; // no window or audio, fixed time step, no frame cap (always on in GAME_HEADLESS builds)
+    uint32_t ticks = 0; // ends the game after this many frames, 0 runs until the window is closed
+    bool newGame = false; // starts a new game after loading, without the title screen and menu
+    std::optional<int> loaderThreads; // instead of "loaderThreads" in settings.json, 0 loads sequentially
+};
+
 class Game {
 private:
     const nlohmann::json* settings = nullptr;
 
 public:
-    Game();
+    Game(const LaunchOptions& options = LaunchOptions{});
+    LaunchOptions launchOptions;
     // in-game resolution (stays constant, gets scaled up to window size)
     uint32_t gameScreenWidth = 256;
     uint32_t gameScreenHeight = 192;
@@ -39,9 +54,12 @@ public:
 
     AssetLoader loader;
     const nlohmann::json& getSetting(const std::string& key) const;
+    TextLayoutEngine textLayout; // cached text wrapping and glyph placement
 
     // basic game loop
     void update(float deltaTime);
+    void lateUpdate(); // main thread work after the update (see Scene::lateUpdate)
+    bool captureScenes(); // Scene::capture for the scenes that are drawn, true if all of them could
     void playMusic();
     void draw();
     void run();
@@ -55,6 +73,7 @@ public:
     void resumeScene(const std::string& name); // unpauses a pause scene
     void processMarkedScenes();
     void resetScenes();
+    void startInGame(); // InGame and the HUD, for a new game or one that was just loaded
 
     template <typename T>
     void registerScene(const std::string& name, int priority = 0) {
@@ -88,11 +107,18 @@ public:
     // input management
     uint32_t buttonsPressed;
     uint32_t buttonsDown;
+    // recording and replaying the input (command line flags, see Main.cpp)
+    bool recordInput(const std::string& path);
+    bool replayInput(const std::string& path); // runs uncapped, the game ends with the replay
+    uint32_t worldChecksum() const; // compared every few frames of a replay
+
+    // workers for the parallel update passes, "jobThreads" 0 runs them on the main thread (same results)
+    std::unique_ptr<JobSystem> jobs;
 
     // game objects
+    ParticleSystem particles; // owns all particle emitters (declared before the sprites, their behaviors release emitters on destruction)
     std::vector<std::unique_ptr<Rectangle>> walls; // everything with static collision
     std::vector<std::shared_ptr<Sprite>> sprites; // dynamic objects
-    std::vector<Emitter> emitters; // particle emitters
     std::shared_ptr<Sprite> createSprite(std::string spriteName, Rectangle& rect); // TODO: or return a reference to the sprite?
 
     // Dungeon management
@@ -105,7 +131,7 @@ public:
 
     Sprite* getPlayer(); // store a reference to the player sprite in case a scene other than InGame needs it
 
-    void playSound(const std::string& key);
+    void playSound(StringId key); // "name"_id where the name is known
 
     bool soundOn = true; // all sound, overwrites the other two
     bool musicOn = true;
@@ -120,6 +146,12 @@ private:
     std::unordered_map<std::string, std::function<std::unique_ptr<Scene>(const std::string&)>> sceneRegistry; // stores scene constructors
     std::unordered_map<std::string, int> scenePriorities; // stores the drawing order (TODO: also control the update order?)
     void setSceneState(const std::string& name, bool active, bool paused);
+    std::vector<Scene*> drawOrder; // active scenes by draw priority, set by captureScenes (draw() doesn't look at the scene map)
+    std::vector<std::unique_ptr<Scene>> replacedScenes; // startScene with a running name, deleted in processMarkedScenes
+    // pipelined frames: the next update runs on simThread while the main thread draws the last captured frame
+    bool pipelinedFrames = false;
+    std::unique_ptr<ThreadPool> simThread;
     std::vector<std::shared_ptr<Sprite>> spritesToAdd; // stores the sprites that are later added to the actual sprites vector (prevents changing the vector during the update loop)
     std::shared_ptr<SaveGame> savegame = nullptr; // store save data
+    InputRecorder recorder;
 };
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include <string_view>
+#include "StringId.h"
+
+// payloads of the typed events (EventManager::emit/subscribe)
+// id is the old string key, so listeners that still use addListener("screenShake", ...) keep working
+// (name is interned when the channel is created, for the logs)
+
+struct ScreenShake {
+    static constexpr std::string_view name = "screenShake";
+    static constexpr StringId id{ name };
+    float duration;
+    float xMagnitude;
+    float yMagnitude;
+};
+
+struct MoveCamera {
+    // cutscene camera control, clamped to the map by InGame
+    static constexpr std::string_view name = "moveCamera";
+    static constexpr StringId id{ name };
+    float x;
+    float y;
+};
+
+struct MusicVolume {
+    static constexpr std::string_view name = "setMusicVolume";
+    static constexpr StringId id{ name };
+    float volume;
+};
+
+struct ShowHelpText {
+    static constexpr std::string_view name = "showHelpText";
+    static constexpr StringId id{ name };
+    const char* label; // string literal
+    char key; // keyboard key shown next to the label
+    int buttonIndex; // gamepad button icon
+};
+
+struct HideHelpText {
+    static constexpr std::string_view name = "hideHelpText";
+    static constexpr StringId id{ name };
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// like std::function, but callables up to Capacity bytes (a lambda capturing a few pointers) are stored
+// inside the object instead of on the heap, bigger ones still work but are allocated
+// move-only, so it can hold lambdas that capture unique_ptrs
+
+template <typename Signature, size_t Capacity = 32>
+class InplaceFunction;
+
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+    InplaceFunction() = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceFunction>>>
+    InplaceFunction(F&& f) {
+        using Callable = std::decay_t<F>;
+        if constexpr (fitsInline<Callable>()) {
+            new (buffer) Callable(std::forward<F>(f));
+            invoker = [](void* storage, Args... args) -> R {
+                return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+            };
+            manager = [](Operation op, void* self, void* other) {
+                Callable* callable = static_cast<Callable*>(self);
+                if (op == Operation::Move) new (other) Callable(std::move(*callable));
+                callable->~Callable();
+            };
+        }
+        else {
+            *reinterpret_cast<Callable**>(buffer) = new Callable(std::forward<F>(f));
+            invoker = [](void* storage, Args... args) -> R {
+                return (**static_cast<Callable**>(storage))(std::forward<Args>(args)...);
+            };
+            manager = [](Operation op, void* self, void* other) {
+                Callable** callable = static_cast<Callable**>(self);
+                if (op == Operation::Move) *static_cast<Callable**>(other) = *callable;
+                else delete *callable;
+            };
+        }
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept { moveFrom(other); }
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+    ~InplaceFunction() { reset(); }
+
+    R operator()(Args... args) const { return invoker(const_cast<unsigned char*>(buffer), std::forward<Args>(args)...); }
+    explicit operator bool() const { return invoker != nullptr; }
+
+    void reset() {
+        if (manager) manager(Operation::Destroy, buffer, nullptr);
+        invoker = nullptr;
+        manager = nullptr;
+    }
+
+    template <typename F>
+    static constexpr bool fitsInline() {
+        return sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+    }
+
+private:
+    enum class Operation { Move, Destroy }; // Move also destroys the source
+    alignas(std::max_align_t) unsigned char buffer[Capacity];
+    R (*invoker)(void*, Args...) = nullptr;
+    void (*manager)(Operation, void*, void*) = nullptr;
+
+    void moveFrom(InplaceFunction& other) {
+        if (!other.manager) return;
+        other.manager(Operation::Move, other.buffer, buffer);
+        invoker = other.invoker;
+        manager = other.manager;
+        other.invoker = nullptr;
+        other.manager = nullptr;
+    }
+};
@@ -0,0 +1,143 @@
+#include "InputRecorder.h"
+#include "raylib.h"
+#include <cstring>
+#include <iterator>
+
+namespace {
+    uint32_t frameSeed(uint32_t seed, uint32_t frame) {
+        // murmur3 finalizer, so neighbouring frames get unrelated seeds
+        uint32_t x = seed + frame * 0x9E3779B9u;
+        x ^= x >> 16;
+        x *= 0x85EBCA6Bu;
+        x ^= x >> 13;
+        x *= 0xC2B2AE35u;
+        x ^= x >> 16;
+        return x ? x : 1; // FastRandom doesn't like 0
+    }
+
+    bool sameBits(float a, float b) {
+        return std::memcmp(&a, &b, sizeof(float)) == 0;
+    }
+}
+
+InputRecorder::~InputRecorder() {
+    stop();
+}
+
+bool InputRecorder::startRecording(const std::string& filePath, uint32_t seed, uint32_t checksumInterval) {
+    stop();
+    out.open(filePath, std::ios::binary);
+    if (!out) {
+        TraceLog(LOG_ERROR, "REPLAY: can't write %s", filePath.c_str());
+        return false;
+    }
+    std::memcpy(header.magic, GIR_MAGIC, 4);
+    header.version = GIR_VERSION;
+    header.seed = seed;
+    header.checksumInterval = checksumInterval;
+    write(header);
+    path = filePath;
+    recording = true;
+    frame = 0;
+    last = InputFrame{};
+    TraceLog(LOG_INFO, "REPLAY: recording to %s (seed %08x, checksum every %u frames)", path.c_str(), seed, checksumInterval);
+    return true;
+}
+
+bool InputRecorder::startReplay(const std::string& filePath) {
+    stop();
+    std::ifstream in(filePath, std::ios::binary);
+    if (!in) {
+        TraceLog(LOG_ERROR, "REPLAY: can't read %s", filePath.c_str());
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    offset = 0;
+    if (!read(header) || std::memcmp(header.magic, GIR_MAGIC, 4) != 0 || header.version != GIR_VERSION) {
+        TraceLog(LOG_ERROR, "REPLAY: %s is not an input recording (or an old version)", filePath.c_str());
+        data.clear();
+        return false;
+    }
+    path = filePath;
+    replaying = true;
+    frame = 0;
+    desyncs = 0;
+    last = InputFrame{};
+    TraceLog(LOG_INFO, "REPLAY: playing %s (%zu bytes, seed %08x)", path.c_str(), data.size(), header.seed);
+    return true;
+}
+
+void InputRecorder::stop() {
+    if (recording) {
+        out.close();
+        TraceLog(LOG_INFO, "REPLAY: recorded %u frames to %s", frame, path.c_str());
+    }
+    if (replaying) {
+        TraceLog(LOG_INFO, "REPLAY: played %u frames of %s, %zu desyncs", frame, path.c_str(), desyncs);
+        data.clear();
+        data.shrink_to_fit();
+    }
+    recording = false;
+    replaying = false;
+}
+
+template <typename T>
+bool InputRecorder::read(T& value) {
+    if (offset + sizeof(T) > data.size()) return false;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+bool InputRecorder::beginFrame(InputFrame& input) {
+    if (recording) {
+        current = input;
+    }
+    else if (replaying) {
+        uint8_t flags = 0;
+        if (!read(flags)) return false;
+        input.pressed = 0;
+        input.down = last.down;
+        input.deltaTime = last.deltaTime;
+        bool complete = (!(flags & FRAME_PRESSED) || read(input.pressed)) &&
+            (!(flags & FRAME_DOWN) || read(input.down)) &&
+            (!(flags & FRAME_DELTA) || read(input.deltaTime));
+        hasChecksum = (flags & FRAME_CHECKSUM) != 0;
+        if (!complete || (hasChecksum && !read(recordedChecksum))) {
+            TraceLog(LOG_WARNING, "REPLAY: %s ends in the middle of frame %u", path.c_str(), frame);
+            return false;
+        }
+        last = input;
+    }
+    input.seed = frameSeed(header.seed, frame);
+    return true;
+}
+
+bool InputRecorder::wantsChecksum() const {
+    if (replaying) return hasChecksum;
+    return recording && header.checksumInterval > 0 && (frame + 1) % header.checksumInterval == 0;
+}
+
+void InputRecorder::endFrame(uint32_t checksum) {
+    if (recording) {
+        uint8_t flags = 0;
+        if (current.pressed != 0) flags |= FRAME_PRESSED;
+        if (current.down != last.down) flags |= FRAME_DOWN;
+        if (!sameBits(current.deltaTime, last.deltaTime)) flags |= FRAME_DELTA;
+        if (wantsChecksum()) flags |= FRAME_CHECKSUM;
+        write(flags);
+        if (flags & FRAME_PRESSED) write(current.pressed);
+        if (flags & FRAME_DOWN) write(current.down);
+        if (flags & FRAME_DELTA) write(current.deltaTime);
+        if (flags & FRAME_CHECKSUM) write(checksum);
+        last = current;
+    }
+    else if (replaying && hasChecksum && checksum != recordedChecksum) {
+        // only the first one is logged, everything after it is likely off as well
+        if (desyncs == 0) {
+            TraceLog(LOG_WARNING, "REPLAY: out of sync at frame %u (checksum %08x, recorded %08x)", frame, checksum, recordedChecksum);
+        }
+        desyncs++;
+    }
+    if (recording || replaying) frame++;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+Records the input of a playthrough and plays it back (main.exe --record file / --replay file)
+every frame gets the same controls, delta time and RNG seed as in the recording, so the game
+runs the same way again (a heavy fight can be replayed as often as needed for profiling)
+
+.gir layout (little endian):
+    GirHeader
+    frames      one flags byte per frame, followed by the fields it has set (in this order):
+                FRAME_PRESSED   uint32_t controls pressed (left out when nothing was pressed)
+                FRAME_DOWN      uint32_t controls held down (left out when it didn't change)
+                FRAME_DELTA     float delta time (left out when it's the same as the last frame's)
+                FRAME_CHECKSUM  uint32_t world checksum after the frame, every checksumInterval frames
+
+the seed of each frame is mixed from the header seed and the frame number, so it isn't stored
+a replay is out of sync if the game state checksum doesn't match the recorded one
+*/
+
+constexpr char GIR_MAGIC[4] = { 'G', 'T', 'I', 'R' };
+constexpr uint32_t GIR_VERSION = 1;
+
+struct GirHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t seed;
+    uint32_t checksumInterval;
+};
+
+enum GirFrameFlags : uint8_t {
+    FRAME_PRESSED = 1 << 0,
+    FRAME_DOWN = 1 << 1,
+    FRAME_DELTA = 1 << 2,
+    FRAME_CHECKSUM = 1 << 3
+};
+
+struct InputFrame {
+    uint32_t pressed = 0;
+    uint32_t down = 0;
+    float deltaTime = 0.0f;
+    uint32_t seed = 0; // for the random number generators, set by beginFrame
+};
+
+class InputRecorder {
+public:
+    ~InputRecorder();
+
+    bool startRecording(const std::string& path, uint32_t seed, uint32_t checksumInterval);
+    bool startReplay(const std::string& path);
+    void stop();
+
+    bool isRecording() const { return recording; }
+    bool isReplaying() const { return replaying; }
+
+    // recording: stores the frame's input, replay: replaces it with the recorded one
+    // returns false when the replay has no frames left
+    bool beginFrame(InputFrame& frame);
+    bool wantsChecksum() const; // the current frame is one of the checked ones
+    void endFrame(uint32_t checksum = 0); // checksum is only used if wantsChecksum()
+
+    uint32_t getFrame() const { return frame; }
+    size_t getDesyncs() const { return desyncs; }
+
+private:
+    bool recording = false;
+    bool replaying = false;
+    std::string path;
+    GirHeader header{};
+    uint32_t frame = 0; // frames since the start
+    size_t desyncs = 0;
+
+    // recording
+    std::ofstream out;
+    InputFrame current;
+    InputFrame last;
+
+    // replay (the whole file is read at the start)
+    std::vector<uint8_t> data;
+    size_t offset = 0;
+    uint32_t recordedChecksum = 0;
+    bool hasChecksum = false;
+
+    template <typename T>
+    bool read(T& value);
+    template <typename T>
+    void write(const T& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+};
@@ -16,9 +16,9 @@ InventoryManager::InventoryManager(Game& game) : game(game) {
 
         int repeats = player->maxHealth - player->health;
         isRefilling = true;
-        this->game.eventManager.pushRepeatedEvent("refill_health", 0.2f, {}, [=]() {
+        this->game.eventManager.pushRepeatedEvent("refill_health"_id, 0.2f, {}, [=]() {
             player->health += 1;
-            this->game.playSound("heart");
+            this->game.playSound("heart"_id);
             }, repeats, [&]() {
                 isRefilling = false;
                 });
@@ -33,9 +33,9 @@ InventoryManager::InventoryManager(Game& game) : game(game) {
         player->maxHealth += 2;
         int repeats = player->maxHealth - player->health;
         isRefilling = true;
-        this->game.eventManager.pushRepeatedEvent("refill_health", 0.2f, {}, [=]() {
+        this->game.eventManager.pushRepeatedEvent("refill_health"_id, 0.2f, {}, [=]() {
             player->health += 1;
-            this->game.playSound("heart");
+            this->game.playSound("heart"_id);
             }, repeats, [&]() {
                 isRefilling = false;
                 });
@@ -64,6 +64,7 @@ InventoryManager::InventoryManager(Game& game) : game(game) {
                     if (it->second.second == 0) {
                         items[CONSUMABLE].erase(it);
                     }
+                    this->game.eventManager.raiseSignal(SIGNAL_INVENTORY_CHANGED);
                     break;
                 }
             }
@@ -84,6 +85,7 @@ void InventoryManager::addItem(const std::string& key, uint32_t amount) {
     auto& item = bucket[key];
     if (!item.first) item.first = data;
     item.second += amount;
+    game.eventManager.raiseSignal(SIGNAL_INVENTORY_CHANGED);
 }
 
 void InventoryManager::removeItem(const std::string& key, uint32_t amount) {
@@ -102,4 +104,5 @@ void InventoryManager::removeItem(const std::string& key, uint32_t amount) {
     else {
         itemIt->second.second -= amount;
     }
+    game.eventManager.raiseSignal(SIGNAL_INVENTORY_CHANGED);
 }
@@ -0,0 +1,109 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <string>
+#include "Profiler.h"
+
+
+JobSystem::JobSystem(size_t workerCount) {
+    queues.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::run(size_t count, size_t grain, void* context, RangeFn fn) {
+    // about 4 chunks per thread, so the stealing can even out chunks that take longer
+    size_t threads = workers.size() + 1;
+    size_t chunkSize = std::max(std::max<size_t>(grain, 1), (count + threads * 4 - 1) / (threads * 4));
+    size_t chunks = (count + chunkSize - 1) / chunkSize;
+
+    Batch batch{ fn, context, {} };
+    batch.remaining.store(chunks);
+    // counted before they are pushed, a worker that finds the queues still empty just looks again
+    queued.fetch_add(chunks);
+    for (size_t q = 0; q < queues.size(); ++q) {
+        Queue& queue = *queues[q];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.empty()) {
+            queue.tasks.clear();
+            queue.front = 0;
+        }
+        for (size_t chunk = q; chunk < chunks; chunk += queues.size()) {
+            size_t begin = chunk * chunkSize;
+            queue.tasks.push_back(Task{ &batch, begin, std::min(count, begin + chunkSize) });
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_all();
+
+    // help out until every chunk is done (the batch lives on this stack frame)
+    Task task;
+    while (batch.remaining.load(std::memory_order_acquire) > 0) {
+        if (steal(queues.size(), task)) execute(task);
+        else std::this_thread::yield();
+    }
+}
+
+bool JobSystem::popOwn(size_t index, Task& task) {
+    Queue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.empty()) return false;
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool JobSystem::steal(size_t thief, Task& task) {
+    for (size_t i = 1; i <= queues.size(); ++i) {
+        size_t victim = (thief + i) % queues.size();
+        if (victim == thief) continue;
+        Queue& queue = *queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.empty()) continue;
+        task = queue.tasks[queue.front++];
+        queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(const Task& task) {
+    {
+        PROFILE_ZONE("job");
+        task.batch->fn(task.batch->context, task.begin, task.end);
+    }
+    // last access to the batch, the caller returns once this reaches 0
+    task.batch->remaining.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerLoop(size_t index) {
+    PROFILE_THREAD("job worker " + std::to_string(index));
+    while (true) {
+        Task task;
+        if (popOwn(index, task) || steal(index, task)) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+Fixed number of workers for the per-frame update passes (the ThreadPool is for loading files)
+parallelFor splits an index range into chunks that are spread over the workers' deques,
+a worker takes chunks from the back of its own deque and steals from the front of the others
+when it runs out, the calling thread steals chunks too until the whole range is done
+
+the passes only write to the elements of their own range, so the results don't depend on
+how the chunks were distributed (and are the same with 0 workers, where everything runs inline)
+*/
+
+class JobSystem {
+public:
+    explicit JobSystem(size_t workerCount); // 0 = single-threaded
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // calls fn(begin, end) for chunks of [0, count) that have at least grain elements and returns when all are done
+    template <typename F>
+    void parallelFor(size_t count, size_t grain, F&& fn) {
+        if (count == 0) return;
+        if (workers.empty() || count <= grain) {
+            fn(size_t(0), count);
+            return;
+        }
+        using Fn = std::remove_reference_t<F>;
+        void* context = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+        run(count, grain, context, [](void* context, size_t begin, size_t end) {
+            (*static_cast<Fn*>(context))(begin, end);
+            });
+    }
+
+private:
+    using RangeFn = void (*)(void* context, size_t begin, size_t end);
+    struct Batch {
+        RangeFn fn;
+        void* context;
+        std::atomic<size_t> remaining; // chunks that haven't finished yet
+    };
+    struct Task {
+        Batch* batch;
+        size_t begin;
+        size_t end;
+    };
+    struct Queue {
+        std::mutex mutex;
+        // a vector and the index of its front instead of a std::deque, that one allocates a new block
+        // every few tasks as they move through it, this one keeps its capacity
+        std::vector<Task> tasks;
+        size_t front = 0; // the tasks before it were stolen
+        bool empty() const { return front == tasks.size(); }
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues; // one per worker
+    std::atomic<size_t> queued{ 0 }; // tasks in all the queues, workers sleep while it's 0
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void run(size_t count, size_t grain, void* context, RangeFn fn);
+    bool popOwn(size_t index, Task& task);
+    bool steal(size_t thief, Task& task);
+    void execute(const Task& task);
+    void workerLoop(size_t index);
+};
@@ -1,11 +1,36 @@
 ﻿#include "Game.h"
+#include <string>
+#include <cstdlib>
 
-int main() {
+int main(int argc, char** argv) {
     //SetTraceLogLevel(LOG_WARNING);
     SetTraceLogLevel(LOG_INFO);
 
+    // --record file writes the input of this session, --replay file plays it back
+    // --headless runs without window and sound as fast as possible, --ticks n ends the game after n frames,
+    // --new-game skips the title screen (e.g. --headless --new-game --ticks 10000 times the simulation)
+    // --loader-threads n overrides the setting (0 loads everything on the main thread, for comparing)
+    std::string recordPath;
+    std::string replayPath;
+    LaunchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--record" && hasValue) recordPath = argv[++i];
+        else if (arg == "--replay" && hasValue) replayPath = argv[++i];
+        else if (arg == "--ticks" && hasValue) options.ticks = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--headless") options.headless = true;
+        else if (arg == "--new-game") options.newGame = true;
+        else if (arg == "--loader-threads" && hasValue) options.loaderThreads = std::atoi(argv[++i]);
+    }
+
+    bool firstRun = true;
     while (true) {
-        Game game;
+        Game game(options);
+        // only the first game, a restart ends the recording
+        if (firstRun && !replayPath.empty()) game.replayInput(replayPath);
+        else if (firstRun && !recordPath.empty()) game.recordInput(recordPath);
+        firstRun = false;
         game.run();
         if (!game.isRestartRequested()) 
             break;
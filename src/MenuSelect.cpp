@@ -21,11 +21,11 @@ void MenuSelect::update()
     // move the cursor
     if (game.buttonsPressed & CONTROL_DOWN) {
         menuIndex = (menuIndex + 1) % menuItems.size();
-        game.playSound("menuCursor");
+        game.playSound("menuCursor"_id);
     }
     if (game.buttonsPressed & CONTROL_UP) {
         menuIndex = (menuIndex + menuItems.size() - 1) % menuItems.size();
-        game.playSound("menuCursor");
+        game.playSound("menuCursor"_id);
     }
     // button activates the callback
     if (game.buttonsPressed & (CONTROL_CONFIRM | CONTROL_ACTION1)) {
@@ -59,14 +59,15 @@ void MenuSelect::draw() {
         }
     }
 
+    const Font& font = game.loader.getFont("slkscr");
     for (size_t i = 0; i < menuItems.size(); i++) {
-        std::string item = menuItems[i].displayName;
         Color color = DARKGRAY;
         if (i == menuIndex) {
             color = LIGHTGRAY;
         }
-        int textWidth = MeasureText(item.c_str(), static_cast<int>(fontsize));
-        int x = (width - textWidth) / 2;
-        DrawText(item.c_str(), x, static_cast<int>(startY + i * rowHeight), static_cast<int>(fontsize), color);
+        // the layouts are cached, so this doesn't measure the text again every frame
+        auto layout = game.textLayout.layout(menuItems[i].displayName, font, static_cast<float>(fontsize));
+        float x = (width - layout->size.x) / 2.0f;
+        game.textLayout.draw(*layout, { x, static_cast<float>(startY + i * rowHeight) }, color);
     }
 }
\ No newline at end of file
@@ -3,60 +3,50 @@
 #include <cmath>
 #include <string>
 
-Emitter::Emitter(size_t maxParticles)
-    : maxParticles(maxParticles), rng(std::random_device{}()) {
-    particles.resize(maxParticles);
-}
+bool Emitter::emit(FastRandom& rng) {
+    for (auto& p : particles) {
+        if (!p.active) {
+            p = prototype;
 
-void Emitter::update(float deltaTime) {
-    age += deltaTime;
-    if (emitterLifetime > 0 && age >= emitterLifetime) return;
+            float angle = rng.range(0.0f, 2.0f * PI);
+            float radius = spawnRadius + rng.range(-spawnRadiusVariance, spawnRadiusVariance);
+            Vector2 offset = { std::cos(angle) * radius, std::sin(angle) * radius };
+            p.position = Vector2Add(location, offset);
 
-    timeSinceLastSpawn += deltaTime;
-    while (timeSinceLastSpawn >= spawnInterval) {
-        emit();
-        timeSinceLastSpawn -= spawnInterval;
-    }
+            p.velocity.x += rng.range(-velocityVariance.x, velocityVariance.x);
+            p.velocity.y += rng.range(-velocityVariance.y, velocityVariance.y);
+            p.lifetime += rng.range(-lifetimeVariance, lifetimeVariance);
+            p.alpha += rng.range(-alphaVariance, alphaVariance);
 
-    for (auto& p : particles) {
-        if (p.active) {
-            p.update(deltaTime);
+            p.reset();
+            activeParticles++;
+            return true;
         }
     }
+    return false;
 }
 
-void Emitter::draw() {
+size_t Emitter::updateParticles(float deltaTime) {
+    // particles keep updating after the emitter stopped emitting,
+    // so they can fade out properly
+    if (activeParticles == 0) return 0;
+
+    size_t died = 0;
     for (auto& p : particles) {
         if (p.active) {
-            p.draw();
+            p.update(deltaTime);
+            if (!p.active) died++;
         }
     }
+    activeParticles -= died;
+    return died;
 }
 
-void Emitter::emit() {
-    for (auto& p : particles) {
-        if (!p.active) {
-            p = prototype;
-
-            std::uniform_real_distribution<float> angleDist(0.0f, 2.0f * PI);
-            std::uniform_real_distribution<float> radiusOffset(-spawnRadiusVariance, spawnRadiusVariance);
-            std::uniform_real_distribution<float> vxOffset(-velocityVariance.x, velocityVariance.x);
-            std::uniform_real_distribution<float> vyOffset(-velocityVariance.y, velocityVariance.y);
-            std::uniform_real_distribution<float> lifetimeOffset(-lifetimeVariance, lifetimeVariance);
-            std::uniform_real_distribution<float> alphaOffset(-alphaVariance, alphaVariance);
-
-            float angle = angleDist(rng);
-            float radius = spawnRadius + radiusOffset(rng);
-            Vector2 offset = { std::cos(angle) * radius, std::sin(angle) * radius };
-            p.position = Vector2Add(location, offset);
-
-            p.velocity.x += vxOffset(rng);
-            p.velocity.y += vyOffset(rng);
-            p.lifetime += lifetimeOffset(rng);
-            p.alpha += alphaOffset(rng);
-
-            p.reset();
-            return;
+void Emitter::draw(RenderSnapshot& out) const {
+    if (activeParticles == 0) return;
+    for (const auto& p : particles) {
+        if (p.active) {
+            p.draw(out);
         }
     }
 }
@@ -82,30 +72,29 @@ void Particle::update(float deltaTime) {
 
     size = startSize + (endSize - startSize) * (age / lifetime);
 
-    if (!animationFrames.empty()) {
+    if (animationFrames && !animationFrames->empty()) {
         animationTimer += deltaTime;
         if (animationTimer >= animationSpeed) {
             animationTimer = 0.0f;
-            currentFrame = (currentFrame + 1) % animationFrames.size();
+            currentFrame = (currentFrame + 1) % animationFrames->size();
         }
     }
 }
 
-void Particle::draw() {
-    if (!active || animationFrames.empty()) return;
+void Particle::draw(RenderSnapshot& out) const {
+    if (!active || !animationFrames || animationFrames->empty()) return;
 
-    Texture2D* tex = animationFrames[currentFrame];
-    if (!tex) return;
+    const Texture2D& tex = (*animationFrames)[currentFrame];
 
     Color finalColor = tint;
-    finalColor.a = static_cast<unsigned char>(alpha * 255.0f);
+    finalColor.a = static_cast<unsigned char>(Clamp(alpha, 0.0f, 1.0f) * 255.0f);
 
-    Vector2 origin = { tex->width / 2.0f, tex->height / 2.0f };
+    Vector2 origin = { tex.width / 2.0f, tex.height / 2.0f };
 
-    Rectangle source = { 0, 0, static_cast<float>(tex->width), static_cast<float>(tex->height) };
-    Rectangle dest = { position.x, position.y, static_cast<float>(tex->width) * size, static_cast<float>(tex->height) * size };
+    Rectangle source = { 0, 0, static_cast<float>(tex.width), static_cast<float>(tex.height) };
+    Rectangle dest = { position.x, position.y, static_cast<float>(tex.width) * size, static_cast<float>(tex.height) * size };
 
-    DrawTexturePro(*tex, source, dest, origin, 0.0f, finalColor);
+    out.drawTexturePro(tex, source, dest, origin, 0.0f, finalColor);
 }
 
 void Particle::reset() {
@@ -116,11 +105,12 @@ void Particle::reset() {
     active = true;
 }
 
-void Particle::fromData(nlohmann::json& data)
+void Particle::fromData(const nlohmann::json& data)
 {
     // set the values from JSON data
     velocity = { data.at("velocityX").get<float>(), data.at("velocityY").get<float>() };
     startAlpha = data.at("startAlpha").get<float>();
+    alpha = startAlpha; // reset() copies alpha into startAlpha
     endAlpha = data.at("endAlpha").get<float>();
     auto tintVec = data.at("tint");
     tint = Color{
@@ -132,11 +122,10 @@ void Particle::fromData(nlohmann::json& data)
     lifetime = data.at("lifetime").get<float>();
     startSize = data.at("startSize").get<float>();
     endSize = data.at("endSize").get<float>();
+    size = startSize;
+    animationSpeed = data.value("animationSpeed", animationSpeed);
 }
 
 void Particle::setAnimationFrames(const std::vector<Texture2D>& textures) {
-    animationFrames.clear();
-    for (const auto& tex : textures) {
-        animationFrames.push_back(const_cast<Texture2D*>(&tex));
-    }
+    animationFrames = &textures;
 }
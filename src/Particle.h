@@ -2,6 +2,7 @@
 #include "raylib.h"
 #include <vector>
 #include "json.hpp"
+#include "RenderSnapshot.h"
 
 struct Particle {
     Vector2 position = { 0.0f, 0.0f };
@@ -16,7 +17,8 @@ struct Particle {
     float endSize = 1.0f;
     float size = 1.0f;
 
-    std::vector<Texture2D*> animationFrames;
+    // points to the texture group in the AssetLoader, so copying the prototype doesn't allocate
+    const std::vector<Texture2D>* animationFrames = nullptr;
     void setAnimationFrames(const std::vector<Texture2D>& textures);
     int currentFrame = 0;
     float animationSpeed = 0.1f;
@@ -26,7 +28,7 @@ struct Particle {
 
     Particle();
     void update(float deltaTime);
-    void draw();
+    void draw(RenderSnapshot& out) const;
     void reset();
-    void fromData(nlohmann::json& data);
+    void fromData(const nlohmann::json& data);
 };
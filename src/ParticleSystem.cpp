@@ -0,0 +1,232 @@
+#include "ParticleSystem.h"
+#include "AssetLoader.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <random>
+#include <algorithm>
+
+
+ParticleSystem::ParticleSystem() : rng{ std::random_device{}() }
+{
+}
+
+void ParticleSystem::loadPresets(const std::string& filename, AssetLoader& loader) {
+    nlohmann::json data = loader.decodeJson(filename); // from the archive if there is one
+    if (data.is_null()) return;
+    addPresets(data, loader);
+}
+
+void ParticleSystem::addPresets(const nlohmann::json& data, AssetLoader& loader) {
+    // emitters and particles can "inherit" from other entries, same as the sprite data
+    std::unordered_map<std::string, nlohmann::json> rawData;
+    for (auto& [key, value] : data.items()) {
+        rawData[key] = value;
+    }
+
+    for (const auto& [key, value] : rawData) {
+        if (value.value("type", "") != "emitter") continue;
+
+        std::unordered_map<std::string, bool> visited;
+        nlohmann::json emitterData = resolveInheritance(rawData, key, visited);
+        std::string particleKey = emitterData.value("particleKey", "defaultParticle");
+        if (rawData.find(particleKey) == rawData.end()) {
+            TraceLog(LOG_WARNING, "Particle preset %s: particle '%s' not found, skipping", key.c_str(), particleKey.c_str());
+            continue;
+        }
+        visited.clear();
+        nlohmann::json particleData = resolveInheritance(rawData, particleKey, visited);
+
+        ParticlePreset preset;
+        preset.name = key;
+        Emitter& e = preset.emitterTemplate;
+        e.spawnInterval = std::max(emitterData.value("spawnInterval", 1.0f), 0.001f); // 0 would spawn forever
+        e.emitterLifetime = emitterData.value("emitterLifetime", -1.0f);
+        e.spawnRadius = emitterData.value("spawnRadius", 0.0f);
+        e.spawnRadiusVariance = emitterData.value("spawnRadiusVariance", 0.0f);
+        e.velocityVariance = { emitterData.value("velocityVarianceX", 0.0f), emitterData.value("velocityVarianceY", 0.0f) };
+        e.lifetimeVariance = emitterData.value("lifetimeVariance", 0.0f);
+        e.alphaVariance = emitterData.value("alphaVariance", 0.0f);
+        e.maxParticles = emitterData.value("maxParticles", (size_t)16);
+        preset.budget = emitterData.value("budget", e.maxParticles * 16);
+
+        e.prototype.fromData(particleData);
+        std::string textureKey = particleData.value("textureKey", "sprite_default");
+        const auto& frames = loader.getTextures(textureKey);
+        if (frames.empty()) {
+            TraceLog(LOG_WARNING, "Particle preset %s: no textures for key '%s'", key.c_str(), textureKey.c_str());
+        }
+        e.prototype.setAnimationFrames(frames);
+
+        auto [index, added] = presetIndices.try_emplace(key, static_cast<uint32_t>(presets.size()));
+        if (added) {
+            presets.push_back(std::move(preset));
+        }
+        else {
+            // the emitters that are alive still count against the budget
+            preset.liveParticles = presets[index->second].liveParticles;
+            presets[index->second] = std::move(preset);
+        }
+        TraceLog(LOG_INFO, "Particle preset %s: %zu particles per emitter, budget %zu", key.c_str(), presets[index->second].emitterTemplate.maxParticles, presets[index->second].budget);
+    }
+}
+
+EmitterHandle ParticleSystem::spawn(const std::string& presetName, Vector2 location, const std::vector<Texture2D>* textureOverride) {
+    auto it = presetIndices.find(presetName);
+    if (it == presetIndices.end()) {
+        TraceLog(LOG_WARNING, "Particle preset %s not found", presetName.c_str());
+        return {};
+    }
+    const Emitter& t = presets[it->second].emitterTemplate;
+
+    uint32_t index;
+    if (!freeList.empty()) {
+        index = freeList.back();
+        freeList.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(emitters.size());
+        emitters.emplace_back();
+    }
+
+    // copy the settings field by field, so the recycled particle vector keeps its capacity
+    Emitter& e = emitters[index];
+    e.location = location;
+    e.spawnInterval = t.spawnInterval;
+    e.timeSinceLastSpawn = 0.0f;
+    e.emitterLifetime = t.emitterLifetime;
+    e.age = 0.0f;
+    e.spawnRadius = t.spawnRadius;
+    e.spawnRadiusVariance = t.spawnRadiusVariance;
+    e.velocityVariance = t.velocityVariance;
+    e.lifetimeVariance = t.lifetimeVariance;
+    e.alphaVariance = t.alphaVariance;
+    e.maxParticles = t.maxParticles;
+    e.particles.assign(t.maxParticles, Particle{});
+    e.activeParticles = 0;
+    e.prototype = t.prototype;
+    if (textureOverride) e.prototype.setAnimationFrames(*textureOverride);
+    e.presetIndex = it->second;
+    e.alive = true;
+    e.released = false;
+    stats.liveEmitters++;
+    stats.pooledEmitters = freeList.size();
+
+    return { index, e.generation };
+}
+
+Emitter* ParticleSystem::resolve(EmitterHandle handle) {
+    if (!handle.valid() || handle.index >= emitters.size()) return nullptr;
+    Emitter& e = emitters[handle.index];
+    if (!e.alive || e.generation != handle.generation) return nullptr;
+    return &e;
+}
+
+bool ParticleSystem::isAlive(EmitterHandle handle) const {
+    if (!handle.valid() || handle.index >= emitters.size()) return false;
+    const Emitter& e = emitters[handle.index];
+    return e.alive && e.generation == handle.generation;
+}
+
+void ParticleSystem::setLocation(EmitterHandle handle, Vector2 location) {
+    if (Emitter* e = resolve(handle)) e->location = location;
+}
+
+void ParticleSystem::release(EmitterHandle& handle) {
+    if (Emitter* e = resolve(handle)) e->released = true;
+    handle = {};
+}
+
+bool ParticleSystem::allowEmit(ParticlePreset& preset) {
+    // hard limits first
+    if (stats.liveParticles >= globalBudget || preset.liveParticles >= preset.budget) {
+        stats.dropped++;
+        return false;
+    }
+    // above 75% of the global budget, emit fewer particles the fuller it gets
+    // instead of cutting off completely at 100%
+    float load = static_cast<float>(stats.liveParticles) / static_cast<float>(globalBudget);
+    if (load > 0.75f && rng.nextFloat() < (load - 0.75f) * 4.0f) {
+        stats.thinned++;
+        return false;
+    }
+    return true;
+}
+
+void ParticleSystem::update(float deltaTime, JobSystem* jobs) {
+    PROFILE_ZONE("particles");
+    stats.thinned = 0;
+    stats.dropped = 0;
+
+    // moving the particles only touches the emitter's own particles, so that part can run in parallel
+    diedCounts.assign(emitters.size(), 0);
+    auto updateParticles = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (emitters[i].alive) diedCounts[i] = static_cast<uint32_t>(emitters[i].updateParticles(deltaTime));
+        }
+        };
+    if (jobs) jobs->parallelFor(emitters.size(), EMITTERS_PER_JOB, updateParticles);
+    else updateParticles(0, emitters.size());
+
+    // the budgets and the shared random numbers are used in emitter order, like before
+    for (uint32_t i = 0; i < emitters.size(); i++) {
+        Emitter& e = emitters[i];
+        if (!e.alive) continue;
+        ParticlePreset& preset = presets[e.presetIndex];
+
+        size_t died = diedCounts[i];
+        preset.liveParticles -= died;
+        stats.liveParticles -= died;
+
+        e.age += deltaTime;
+        if (e.isEmitting()) {
+            e.timeSinceLastSpawn += deltaTime;
+            while (e.timeSinceLastSpawn >= e.spawnInterval) {
+                e.timeSinceLastSpawn -= e.spawnInterval;
+                if (allowEmit(preset) && e.emit(rng)) {
+                    preset.liveParticles++;
+                    stats.liveParticles++;
+                }
+            }
+        }
+
+        if (e.isFinished()) {
+            retire(i);
+        }
+    }
+}
+
+void ParticleSystem::draw(RenderSnapshot& out) const {
+    for (const auto& e : emitters) {
+        if (e.alive) e.draw(out);
+    }
+}
+
+void ParticleSystem::retire(uint32_t index) {
+    Emitter& e = emitters[index];
+    presets[e.presetIndex].liveParticles -= e.activeParticles;
+    stats.liveParticles -= e.activeParticles;
+    e.activeParticles = 0;
+    e.alive = false;
+    e.generation++; // invalidates all handles to this emitter
+    freeList.push_back(index);
+    stats.liveEmitters--;
+    stats.pooledEmitters = freeList.size();
+}
+
+void ParticleSystem::killParticles() {
+    for (uint32_t i = 0; i < emitters.size(); i++) {
+        Emitter& e = emitters[i];
+        if (!e.alive) continue;
+        for (auto& p : e.particles) p.active = false;
+        presets[e.presetIndex].liveParticles -= e.activeParticles;
+        stats.liveParticles -= e.activeParticles;
+        e.activeParticles = 0;
+        if (e.isFinished()) retire(i);
+    }
+}
+
+void ParticleSystem::clear() {
+    for (uint32_t i = 0; i < emitters.size(); i++) {
+        if (emitters[i].alive) retire(i);
+    }
+}
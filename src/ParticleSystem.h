@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include "raylib.h"
+#include "Emitter.h"
+#include "Utils.h"
+#include "json.hpp"
+
+class AssetLoader;
+class JobSystem;
+
+struct EmitterHandle {
+    // refers to an emitter in the ParticleSystem's pool
+    // the generation makes sure that a stale handle doesn't touch a recycled emitter
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+    bool valid() const { return index != UINT32_MAX; }
+};
+
+struct ParticlePreset {
+    // compiled from an "emitter" entry in particles.json (plus its "particleKey" entry)
+    std::string name;
+    Emitter emitterTemplate; // only the settings are used, particles stays empty
+    size_t budget = 0; // max. live particles across all emitters of this preset
+    size_t liveParticles = 0;
+};
+
+struct ParticleStats {
+    size_t liveEmitters = 0;
+    size_t pooledEmitters = 0; // free emitters waiting to be recycled
+    size_t liveParticles = 0;
+    size_t thinned = 0; // particles skipped because the global budget is getting full (this frame)
+    size_t dropped = 0; // particles refused because a budget is exhausted (this frame)
+};
+
+class ParticleSystem {
+public:
+    ParticleSystem();
+
+    // reads the presets from a JSON file, textures have to be loaded already
+    void loadPresets(const std::string& filename, AssetLoader& loader);
+    // the same from parsed data, a preset that exists already is replaced (live emitters keep their old settings)
+    void addPresets(const nlohmann::json& data, AssetLoader& loader);
+    bool hasPreset(const std::string& name) const { return presetIndices.find(name) != presetIndices.end(); }
+    void setGlobalBudget(size_t maxParticles) { globalBudget = maxParticles; }
+    size_t getGlobalBudget() const { return globalBudget; } // the most particles that can be alive (and drawn) at once
+    void setSeed(uint32_t seed) { rng = FastRandom(seed); } // input replays seed every frame
+
+    // hands out a (recycled) emitter, textureOverride replaces the preset's particle animation
+    EmitterHandle spawn(const std::string& presetName, Vector2 location, const std::vector<Texture2D>* textureOverride = nullptr);
+    void setLocation(EmitterHandle handle, Vector2 location);
+    void release(EmitterHandle& handle); // emitter stops emitting and retires once its particles are gone
+    bool isAlive(EmitterHandle handle) const;
+
+    void update(float deltaTime, JobSystem* jobs = nullptr); // moves the particles in parallel if there's a JobSystem
+    void draw(RenderSnapshot& out) const;
+    void killParticles(); // removes all particles (room transitions), emitters keep running
+    void clear(); // retires everything, all handles become stale
+
+    const ParticleStats& getStats() const { return stats; }
+
+private:
+    std::vector<ParticlePreset> presets;
+    std::unordered_map<std::string, uint32_t> presetIndices;
+    std::vector<Emitter> emitters; // pool, indices are stable
+    std::vector<uint32_t> freeList;
+    FastRandom rng; // shared by all emitters
+    std::vector<uint32_t> diedCounts; // per emitter, from the parallel part of update()
+    static const size_t EMITTERS_PER_JOB = 8;
+    size_t globalBudget = 2000;
+    ParticleStats stats;
+
+    Emitter* resolve(EmitterHandle handle);
+    bool allowEmit(ParticlePreset& preset);
+    void retire(uint32_t index);
+};
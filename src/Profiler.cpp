@@ -0,0 +1,334 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include "raylib.h"
+#include "StringId.h"
+
+
+struct Profiler::ThreadLog {
+    struct Open {
+        const char* name;
+        uint32_t key;
+        int64_t start;
+        AllocCounts allocStart;
+    };
+    std::mutex mutex; // events, endFrame takes them from the main thread
+    std::vector<Event> events; // finished zones since the last endFrame
+    std::vector<Open> stack; // only used by its own thread
+    uint32_t thread = 0;
+    bool retired = false; // the thread has exited, freed in endFrame
+};
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    int64_t now() {
+        static const Clock::time_point epoch = Clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+    }
+
+    // the same name under different parents is a different node
+    uint32_t zoneKey(uint32_t parent, const char* name) {
+        uint32_t key = fnv1a(name) ^ (parent * 0x9E3779B1u);
+        return key ? key : 1; // 0 means "no parent"
+    }
+
+    void writeEscaped(std::ofstream& out, const char* text) {
+        for (; *text; ++text) {
+            if (*text == '"' || *text == '\\') out << '\\';
+            out << *text;
+        }
+    }
+}
+
+Profiler::Profiler() {
+    now(); // starts the clock
+}
+
+Profiler& Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::ThreadLog& Profiler::threadLog() {
+    // hands the log back to the profiler when the thread exits, the events in it are still collected
+    struct Owner {
+        ThreadLog* log = nullptr;
+        ~Owner() { if (log) Profiler::get().retire(log); }
+    };
+    thread_local Owner owner;
+    if (!owner.log) {
+        Profiler& profiler = get();
+        std::lock_guard<std::mutex> lock(profiler.logsMutex);
+        profiler.logs.push_back(std::make_unique<ThreadLog>());
+        owner.log = profiler.logs.back().get();
+        owner.log->thread = profiler.nextThread++;
+        profiler.threadNames.emplace(owner.log->thread, "thread " + std::to_string(owner.log->thread));
+    }
+    return *owner.log;
+}
+
+void Profiler::begin(const char* name) {
+    ThreadLog& log = threadLog();
+    uint32_t parent = log.stack.empty() ? 0 : log.stack.back().key;
+    log.stack.push_back({ name, zoneKey(parent, name), now() });
+    log.stack.back().allocStart = AllocTracker::thread(); // after the push_back, that's the profiler's
+}
+
+void Profiler::end() {
+    int64_t end = now();
+    AllocCounts allocEnd = AllocTracker::thread();
+    ThreadLog& log = threadLog();
+    if (log.stack.empty()) return;
+    ThreadLog::Open open = log.stack.back();
+    log.stack.pop_back();
+    uint32_t parent = log.stack.empty() ? 0 : log.stack.back().key;
+    std::lock_guard<std::mutex> lock(log.mutex);
+    log.events.push_back({ open.name, open.key, parent, (uint32_t)log.stack.size(), log.thread, open.start, end, allocEnd - open.allocStart });
+}
+
+const char* Profiler::name(std::string_view text) {
+    return StringId::intern(text).str();
+}
+
+void Profiler::setThreadName(const std::string& threadName) {
+    uint32_t thread = threadLog().thread;
+    std::lock_guard<std::mutex> lock(logsMutex);
+    threadNames[thread] = threadName;
+}
+
+void Profiler::retire(ThreadLog* log) {
+    std::lock_guard<std::mutex> lock(logsMutex);
+    std::lock_guard<std::mutex> logLock(log->mutex);
+    log->retired = true;
+}
+
+void Profiler::endFrame() {
+    // zones that are still open (the frame zone of the main thread, a worker in the middle of
+    // a job) show up in the frame they end in
+    collected.clear();
+    {
+        std::lock_guard<std::mutex> lock(logsMutex);
+        for (auto it = logs.begin(); it != logs.end();) {
+            bool retired;
+            {
+                std::lock_guard<std::mutex> logLock((*it)->mutex);
+                collected.insert(collected.end(), (*it)->events.begin(), (*it)->events.end());
+                (*it)->events.clear();
+                retired = (*it)->retired;
+            }
+            if (retired) it = logs.erase(it);
+            else ++it;
+        }
+    }
+
+    for (const Event& event : collected) {
+        auto [it, inserted] = nodeIndex.try_emplace(event.key, nodes.size());
+        if (inserted) nodes.push_back(Node{ event.name, event.parent, event.depth });
+        Node& node = nodes[it->second];
+        node.frameNs += event.end - event.start;
+        node.frameAllocs.allocations += event.allocs.allocations;
+        node.frameAllocs.bytes += event.allocs.bytes;
+        node.ran = true;
+    }
+    size_t slot = frame % STATS_FRAMES;
+    for (Node& node : nodes) {
+        node.history[slot] = node.frameNs / 1.0e6f;
+        node.allocHistory[slot] = node.frameAllocs;
+        node.frameAllocs = {};
+        node.idleFrames = node.ran ? 0 : node.idleFrames + 1;
+        node.frameNs = 0;
+        node.ran = false;
+    }
+    AllocCounts total = AllocTracker::total();
+    totalHistory[slot] = total - lastTotal;
+    lastTotal = total;
+    frame++;
+    removeIdleNodes();
+
+    if (traceFrames == 0) {
+        trace.clear();
+        return;
+    }
+    if (trace.size() != traceFrames) {
+        trace.clear();
+        trace.resize(traceFrames);
+        traceNext = 0;
+    }
+    // the oldest frame's vector is cleared and reused as collected next time
+    trace[traceNext].swap(collected);
+    traceNext = (traceNext + 1) % traceFrames;
+}
+
+void Profiler::removeIdleNodes() {
+    auto idle = [](const Node& node) { return node.idleFrames >= STATS_FRAMES; };
+    if (std::none_of(nodes.begin(), nodes.end(), idle)) return;
+    // zones of a scene that was closed, a room that was left etc.
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), idle), nodes.end());
+    nodeIndex.clear();
+    // the key isn't stored in the node, but parent and name give it back
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodeIndex[zoneKey(nodes[i].parent, nodes[i].name)] = i;
+    }
+}
+
+std::vector<size_t> Profiler::treeOrder() const {
+    // children after their parent, in the order they first ran
+    std::vector<size_t> order;
+    order.reserve(nodes.size());
+    std::vector<size_t> stack;
+    for (size_t i = nodes.size(); i-- > 0;) {
+        if (nodes[i].parent == 0 || nodeIndex.find(nodes[i].parent) == nodeIndex.end()) stack.push_back(i);
+    }
+    while (!stack.empty()) {
+        size_t i = stack.back();
+        stack.pop_back();
+        order.push_back(i);
+        uint32_t key = zoneKey(nodes[i].parent, nodes[i].name);
+        for (size_t child = nodes.size(); child-- > 0;) {
+            if (nodes[child].parent == key && child != i) stack.push_back(child);
+        }
+    }
+    return order;
+}
+
+std::vector<Profiler::ZoneTime> Profiler::lastFrame() const {
+    std::vector<ZoneTime> zones;
+    if (frame == 0) return zones;
+    size_t slot = (frame - 1) % STATS_FRAMES;
+    std::vector<std::string> parents; // path of the last zone at each depth
+    for (size_t i : treeOrder()) {
+        const Node& node = nodes[i];
+        // zones whose parent was dropped start a new path
+        size_t depth = std::min<size_t>(node.depth, parents.size());
+        if (node.parent == 0 || nodeIndex.find(node.parent) == nodeIndex.end()) depth = 0;
+        parents.resize(depth);
+        std::string path = depth ? parents.back() + "/" + node.name : std::string(node.name);
+        if (node.idleFrames == 0) { // only the zones that ran
+            zones.push_back({ path, node.history[slot], node.allocHistory[slot].allocations, node.allocHistory[slot].bytes });
+        }
+        parents.push_back(std::move(path));
+    }
+    return zones;
+}
+
+bool Profiler::dumpTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        TraceLog(LOG_ERROR, "PROFILER: Can't write the trace to %s", path.c_str());
+        return false;
+    }
+    // timestamps and durations are microseconds
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(logsMutex);
+        for (const auto& [thread, threadName] : threadNames) {
+            if (!first) out << ",\n";
+            first = false;
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"name\":\"";
+            writeEscaped(out, threadName.c_str());
+            out << "\"}}";
+        }
+    }
+    size_t zones = 0;
+    size_t frames = 0;
+    for (size_t i = 0; i < trace.size(); ++i) {
+        // oldest frame first
+        const std::vector<Event>& events = trace[(traceNext + i) % trace.size()];
+        if (!events.empty()) frames++;
+        for (const Event& event : events) {
+            if (!first) out << ",\n";
+            first = false;
+            out << "{\"name\":\"";
+            writeEscaped(out, event.name);
+            out << "\",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+                << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0;
+            if (AllocTracker::enabled) {
+                out << ",\"args\":{\"allocations\":" << event.allocs.allocations << ",\"bytes\":" << event.allocs.bytes << "}";
+            }
+            out << "}";
+            zones++;
+        }
+    }
+    out << "\n]}\n";
+    if (!out) {
+        TraceLog(LOG_ERROR, "PROFILER: Writing the trace to %s failed", path.c_str());
+        return false;
+    }
+    TraceLog(LOG_INFO, "PROFILER: Wrote %zu zones of the last %zu frames to %s", zones, frames, path.c_str());
+    return true;
+}
+
+void Profiler::drawOverlay(int x, int y, int fontSize) {
+    int lineHeight = fontSize + 2;
+    int nameWidth = fontSize * 12;
+    int columnWidth = fontSize * 4;
+    size_t frames = std::min(frame, STATS_FRAMES);
+    // allocations and kilobytes per frame (average) after the times
+    int columns = AllocTracker::enabled ? 5 : 3;
+
+    std::vector<size_t> order = treeOrder();
+    int lines = (int)order.size() + (AllocTracker::enabled ? 2 : 1);
+    int height = lineHeight * lines + 8;
+    DrawRectangle(x - 4, y - 4, nameWidth + columnWidth * columns + 8, std::max(height, lineHeight * 2 + 8), Fade(BLACK, 0.6f));
+    char text[64];
+    std::snprintf(text, sizeof(text), "ms (%zu frames)", frames);
+    DrawText(text, x, y, fontSize, LIGHTGRAY);
+    const char* headers[] = { "avg", "p95", "max", "allocs", "KB" };
+    for (int c = 0; c < columns; ++c) {
+        DrawText(headers[c], x + nameWidth + columnWidth * c, y, fontSize, LIGHTGRAY);
+    }
+    y += lineHeight;
+    auto average = [frames](const AllocCounts* history) {
+        AllocCounts sum;
+        for (size_t f = 0; f < frames; ++f) {
+            sum.allocations += history[f].allocations;
+            sum.bytes += history[f].bytes;
+        }
+        double n = frames ? double(frames) : 1.0;
+        return std::make_pair(sum.allocations / n, sum.bytes / n / 1024.0);
+    };
+    if (AllocTracker::enabled) {
+        auto [allocs, kb] = average(totalHistory);
+        std::snprintf(text, sizeof(text), "heap, all threads: %.1f allocs %.1f KB", allocs, kb);
+        DrawText(text, x, y, fontSize, LIGHTGRAY);
+        y += lineHeight;
+    }
+    if (order.empty()) {
+        DrawText("no zones (built without GAME_PROFILER?)", x, y, fontSize, LIGHTGRAY);
+        return;
+    }
+
+    float values[STATS_FRAMES];
+    for (size_t i : order) {
+        const Node& node = nodes[i];
+        std::copy(node.history, node.history + frames, values);
+        float sum = 0.0f;
+        for (size_t f = 0; f < frames; ++f) sum += values[f];
+        float avg = frames ? sum / frames : 0.0f;
+        float max = frames ? *std::max_element(values, values + frames) : 0.0f;
+        float p95 = 0.0f;
+        if (frames) {
+            size_t rank = (size_t)std::ceil(frames * 0.95) - 1;
+            std::nth_element(values, values + rank, values + frames);
+            p95 = values[rank];
+        }
+        auto [allocs, kb] = average(node.allocHistory);
+
+        DrawText(node.name, x + (int)node.depth * fontSize, y, fontSize, WHITE);
+        double stats[] = { avg, p95, max, allocs, kb };
+        for (int c = 0; c < columns; ++c) {
+            std::snprintf(text, sizeof(text), c == 3 ? "%.1f" : "%.2f", stats[c]);
+            // a zone that allocates every frame stands out
+            Color color = (c == 3 && allocs > 0.0) ? ORANGE : WHITE;
+            DrawText(text, x + nameWidth + columnWidth * c, y, fontSize, color);
+        }
+        y += lineHeight;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "AllocTracker.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+Scoped zone timers: PROFILE_ZONE("name") measures the rest of the enclosing block, zones can be nested
+the debug overlay (F1, see Game::draw) shows the zone tree with the average, 95th percentile and maximum
+milliseconds per frame over the last STATS_FRAMES frames, dumpTrace writes every zone of the last
+frames as a Chrome trace_event file (open it in chrome://tracing or ui.perfetto.dev)
+with GAME_ALLOC_TRACKING the zones also count the heap allocations of their thread (see AllocTracker.h),
+the overlay gets the allocations and kilobytes per frame of every zone and of the whole program
+
+zones work on any thread, each thread records into its own buffer and endFrame collects them
+names have to stay valid (string literals, or Profiler::name for strings that are put together)
+without GAME_PROFILER (CMake option) the macros compile to nothing and the overlay stays empty
+*/
+
+#ifdef GAME_PROFILER
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::get().setThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+class Profiler {
+public:
+    static Profiler& get();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    static void begin(const char* name);
+    static void end();
+    static const char* name(std::string_view text); // a copy that stays valid, for zones named at runtime
+    void setThreadName(const std::string& threadName); // shown in the trace
+
+    void endFrame(); // main thread, once per game loop
+    void setTraceFrames(size_t frames) { traceFrames = frames; }
+    bool dumpTrace(const std::string& path); // the last traceFrames frames
+    void drawOverlay(int x, int y, int fontSize); // raylib text, inside BeginDrawing
+
+    struct ZoneTime {
+        std::string path; // the zone and its parents, "frame/update InGame/integrate"
+        float ms;
+        uint64_t allocations = 0; // 0 without GAME_ALLOC_TRACKING
+        uint64_t bytes = 0;
+    };
+    std::vector<ZoneTime> lastFrame() const; // the frame endFrame just finished, children after their parent
+
+    static constexpr size_t STATS_FRAMES = 120;
+
+private:
+    Profiler();
+
+    struct Event {
+        const char* name;
+        uint32_t key; // the zone and all of its parents, see begin
+        uint32_t parent;
+        uint32_t depth;
+        uint32_t thread;
+        int64_t start; // ns since the profiler was created
+        int64_t end;
+        AllocCounts allocs; // made on this thread while the zone was open
+    };
+    struct ThreadLog;
+    struct Node {
+        const char* name;
+        uint32_t parent;
+        uint32_t depth;
+        int64_t frameNs = 0; // this frame, summed over all calls and threads
+        AllocCounts frameAllocs;
+        bool ran = false; // this frame
+        float history[STATS_FRAMES] = {}; // ms per frame
+        AllocCounts allocHistory[STATS_FRAMES] = {};
+        size_t idleFrames = 0; // dropped once it hasn't run for STATS_FRAMES frames
+    };
+
+    std::mutex logsMutex;
+    std::vector<std::unique_ptr<ThreadLog>> logs;
+    uint32_t nextThread = 0;
+    std::unordered_map<uint32_t, std::string> threadNames; // kept after the thread exits, for the trace
+
+    std::unordered_map<uint32_t, size_t> nodeIndex; // key -> nodes
+    std::vector<Node> nodes; // in the order they first ran
+    size_t frame = 0;
+    AllocCounts lastTotal; // AllocTracker::total at the last endFrame
+    AllocCounts totalHistory[STATS_FRAMES] = {}; // all threads, in zones or not
+
+    size_t traceFrames = 300;
+    std::vector<std::vector<Event>> trace; // ring of the last traceFrames frames
+    size_t traceNext = 0;
+    std::vector<Event> collected;
+
+    static ThreadLog& threadLog();
+    void retire(ThreadLog* log);
+    void removeIdleNodes();
+    std::vector<size_t> treeOrder() const; // node indices, children after their parent
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) { Profiler::begin(name); }
+    ~ProfileZone() { Profiler::end(); }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+};
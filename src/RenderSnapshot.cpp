@@ -0,0 +1,113 @@
+#include "RenderSnapshot.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // the same thing std::visit needs for a bunch of lambdas
+    template <typename... Ts> struct Overloaded : Ts... { using Ts::operator()...; };
+    template <typename... Ts> Overloaded(Ts...) -> Overloaded<Ts...>;
+}
+
+void RenderSnapshot::clear() {
+    // keeps the capacity, a snapshot is filled again every frame
+    commands.clear();
+    text.clear();
+    lights.clear();
+}
+
+void RenderSnapshot::reserve(size_t commandCount) {
+    // doubles like push_back would, a count that creeps up by one every frame doesn't reallocate every frame
+    if (commandCount > commands.capacity()) commands.reserve(std::max(commandCount, commands.capacity() * 2));
+}
+
+void RenderSnapshot::clearBackground(Color color) {
+    commands.push_back(Clear{ color });
+}
+
+void RenderSnapshot::beginMode2D(const Camera2D& camera) {
+    commands.push_back(Mode2D{ camera, true });
+}
+
+void RenderSnapshot::endMode2D() {
+    commands.push_back(Mode2D{ Camera2D{}, false });
+}
+
+void RenderSnapshot::drawTexturePro(const Texture2D& texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint, const ShaderState* shader) {
+    commands.push_back(TexturePro{ texture, source, dest, origin, rotation, tint, shader ? *shader : ShaderState{} });
+}
+
+void RenderSnapshot::drawTexture(const Texture2D& texture, int x, int y, Color tint) {
+    // raylib does the same, DrawTexture ends up in DrawTexturePro
+    Rectangle source = { 0.0f, 0.0f, (float)texture.width, (float)texture.height };
+    Rectangle dest = { (float)x, (float)y, (float)texture.width, (float)texture.height };
+    drawTexturePro(texture, source, dest, { 0.0f, 0.0f }, 0.0f, tint);
+}
+
+void RenderSnapshot::drawTextureRec(const Texture2D& texture, Rectangle source, Vector2 position, Color tint) {
+    Rectangle dest = { position.x, position.y, std::fabs(source.width), std::fabs(source.height) };
+    drawTexturePro(texture, source, dest, { 0.0f, 0.0f }, 0.0f, tint);
+}
+
+void RenderSnapshot::drawRectangle(int x, int y, int width, int height, Color color) {
+    commands.push_back(Rect{ { (float)x, (float)y, (float)width, (float)height }, color, false });
+}
+
+void RenderSnapshot::drawRectangleRec(Rectangle rect, Color color) {
+    commands.push_back(Rect{ rect, color, false });
+}
+
+void RenderSnapshot::drawRectangleLines(int x, int y, int width, int height, Color color) {
+    commands.push_back(Rect{ { (float)x, (float)y, (float)width, (float)height }, color, true });
+}
+
+void RenderSnapshot::drawCircle(int x, int y, float radius, Color color) {
+    commands.push_back(Circle{ x, y, radius, color });
+}
+
+void RenderSnapshot::drawText(const std::string& str, int x, int y, int fontSize, Color color) {
+    commands.push_back(Text{ text.size(), x, y, fontSize, color });
+    text.append(str);
+    text.push_back('\0');
+}
+
+void RenderSnapshot::drawLightOverlay(const Texture2D& texture, const Shader& shader, const Light* first, int lightCount, float screenW, float screenH) {
+    lightCount = std::min(lightCount, MAX_LIGHTS);
+    commands.push_back(LightOverlay{ texture, &shader, lights.size(), lightCount, screenW, screenH });
+    lights.insert(lights.end(), first, first + lightCount);
+}
+
+void RenderSnapshot::draw() const {
+    for (const Command& command : commands) {
+        std::visit(Overloaded{
+            [](const Clear& c) { ClearBackground(c.color); },
+            [](const Mode2D& c) {
+                if (c.begin) BeginMode2D(c.camera);
+                else EndMode2D();
+            },
+            [](const TexturePro& c) {
+                const Shader* shader = c.shader.shader;
+                if (shader) {
+                    SetShaderValue(*shader, GetShaderLocation(*shader, "time"), &c.shader.time, SHADER_UNIFORM_FLOAT);
+                    SetShaderValue(*shader, GetShaderLocation(*shader, "flipX"), &c.shader.flipX, SHADER_UNIFORM_INT);
+                    SetShaderValue(*shader, GetShaderLocation(*shader, "duration"), &c.shader.duration, SHADER_UNIFORM_FLOAT);
+                    BeginShaderMode(*shader);
+                }
+                DrawTexturePro(c.texture, c.source, c.dest, c.origin, c.rotation, c.tint);
+                if (shader) EndShaderMode();
+            },
+            [](const Rect& c) {
+                if (c.lines) DrawRectangleLines((int)c.rect.x, (int)c.rect.y, (int)c.rect.width, (int)c.rect.height, c.color);
+                else DrawRectangleRec(c.rect, c.color);
+            },
+            [](const Circle& c) { DrawCircle(c.x, c.y, c.radius, c.color); },
+            [this](const Text& c) { DrawText(text.c_str() + c.offset, c.x, c.y, c.fontSize, c.color); },
+            [this](const LightOverlay& c) {
+                // DrawLightOverlay wants mutable arguments
+                Texture2D texture = c.texture;
+                Light copy[MAX_LIGHTS];
+                std::copy(lights.begin() + c.firstLight, lights.begin() + c.firstLight + c.lightCount, copy);
+                DrawLightOverlay(texture, *c.shader, copy, c.lightCount, c.screenW, c.screenH);
+            }
+            }, command);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <variant>
+#include <vector>
+#include "raylib.h"
+#include "CircleOverlay.h"
+
+/*
+Copy of what a scene draws in a frame: the draw calls with all their values (textures, rectangles,
+tints, shader uniforms, strings, camera, lights), recorded by Scene::capture() and played back by draw()
+nothing in here points into the game state, so the main thread can draw it while the simulation
+thread already runs the next update (pipelined frames, see Game::run)
+
+the recording methods take the same arguments as the raylib functions they stand for
+*/
+
+struct ShaderState {
+    const Shader* shader = nullptr;
+    float time = 0.0f;
+    float duration = 2.0f;
+    int flipX = 0;
+};
+
+class RenderSnapshot {
+public:
+    void clear();
+    void reserve(size_t commandCount); // grows ahead of time, so recording a frame with that many commands doesn't allocate
+    size_t size() const { return commands.size(); }
+
+    void clearBackground(Color color);
+    void beginMode2D(const Camera2D& camera);
+    void endMode2D();
+    // shader: sets the uniforms of the sprite shaders (time, flipX, duration) and draws with it
+    void drawTexturePro(const Texture2D& texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint, const ShaderState* shader = nullptr);
+    void drawTexture(const Texture2D& texture, int x, int y, Color tint);
+    void drawTextureRec(const Texture2D& texture, Rectangle source, Vector2 position, Color tint);
+    void drawRectangle(int x, int y, int width, int height, Color color);
+    void drawRectangleRec(Rectangle rect, Color color);
+    void drawRectangleLines(int x, int y, int width, int height, Color color);
+    void drawCircle(int x, int y, float radius, Color color);
+    void drawText(const std::string& text, int x, int y, int fontSize, Color color);
+    void drawLightOverlay(const Texture2D& texture, const Shader& shader, const Light* lights, int lightCount, float screenW, float screenH);
+
+    void draw() const; // main thread
+
+private:
+    struct Clear { Color color; };
+    struct Mode2D { Camera2D camera; bool begin; };
+    struct TexturePro { Texture2D texture; Rectangle source; Rectangle dest; Vector2 origin; float rotation; Color tint; ShaderState shader; };
+    struct Rect { Rectangle rect; Color color; bool lines; };
+    struct Circle { int x, y; float radius; Color color; };
+    struct Text { size_t offset; int x, y, fontSize; Color color; }; // offset into text
+    struct LightOverlay { Texture2D texture; const Shader* shader; size_t firstLight; int lightCount; float screenW, screenH; };
+    using Command = std::variant<Clear, Mode2D, TexturePro, Rect, Circle, Text, LightOverlay>;
+
+    std::vector<Command> commands;
+    std::string text; // the strings of all Text commands, each one ends with '\0'
+    std::vector<Light> lights; // for the LightOverlay commands
+};
@@ -30,6 +30,10 @@ nlohmann::json writeDataToJSON(const SaveGame& saveGame)
             const ObjectState& objectState = objectEntry.second;
             roomJson["objectStates"][std::to_string(objectId)] = objectState;
         }
+        // setTile keeps one edit per cell, so a cell that is listed twice (older saves) ends up with the last id
+        for (const TileEdit& edit : roomData.tileEdits) {
+            roomJson["tileEdits"].push_back({ edit.layer, edit.x, edit.y, edit.id });
+        }
 
         jsonOutput["DungeonRooms"][std::to_string(roomHash)] = roomJson;
     }
@@ -77,6 +81,13 @@ SaveGame readSaveDataFromJSON(const nlohmann::json& jsonInput)
                     roomData.objectStates[objectId] = objectEntry.value().get<ObjectState>();
                 }
             }
+            if (roomJson.contains("tileEdits")) {
+                for (const auto& editJson : roomJson.at("tileEdits")) {
+                    roomData.tileEdits.push_back(TileEdit{
+                        editJson.at(0).get<uint32_t>(), editJson.at(1).get<uint16_t>(),
+                        editJson.at(2).get<uint16_t>(), editJson.at(3).get<uint16_t>() });
+                }
+            }
             saveGame.DungeonRooms[roomHash] = roomData;
         }
     }
@@ -99,7 +110,8 @@ void saveDungeon(SaveGame& saveGame, Dungeon& dungeon)
             rd.doors = rooms[i]->doors;
             rd.state = rooms[i]->state;
             rd.objectStates = rooms[i]->objectStates;
-            rd.tilemapKey = rooms[i]->tilemap.getName();
+            rd.tilemapKey = rooms[i]->getTemplate().getName();
+            rd.tileEdits = rooms[i]->getTileEdits();
             rd.visited = rooms[i]->visited;
             saveGame.DungeonRooms[i] = rd;
         }
@@ -124,6 +136,10 @@ std::unique_ptr<Dungeon> loadDungeon(SaveGame& saveGame, Game& game)
         for (auto& [objID, state] : roomData.objectStates) {
             room.objectStates[objID] = state;
         }
+        // setTile keeps one edit per cell, so a cell that is listed twice (older saves) ends up with the last id
+        for (const TileEdit& edit : roomData.tileEdits) {
+            room.setTile(edit.layer, edit.x, edit.y, edit.id);
+        }
         uint32_t row = index / saveGame.dungeonWidth;
         uint32_t col = index % saveGame.dungeonWidth;
         dungeon->insertRoom(row, col, std::move(room));
@@ -131,6 +147,7 @@ std::unique_ptr<Dungeon> loadDungeon(SaveGame& saveGame, Game& game)
 
     dungeon->setStartingRoomIndex(saveGame.startingRoomIndex);
     dungeon->makeMinimapTextures();
+    dungeon->logMemoryUsage();
 
     return dungeon;
 }
@@ -15,6 +15,7 @@ struct RoomData {
     uint8_t state = 1;
     std::unordered_map< uint32_t, ObjectState> objectStates;
     std::string tilemapKey;
+    std::vector<TileEdit> tileEdits; // changes to the template map, see Room::setTile
 };
 
 struct SaveGame {
@@ -3,6 +3,8 @@
 #include <string>
 #include <any>
 #include <unordered_map>
+#include <vector>
+#include "Subscription.h"
 
 class Game;
 
@@ -24,6 +26,12 @@ public:
     virtual void update(float deltaTime) {}
     virtual void draw() {}
     virtual void end() {}
+    // in pipelined frames (see Game::run) update() runs on the simulation thread while the main thread draws,
+    // so update() can't touch the GPU, that goes into lateUpdate() (main thread, after all updates)
+    virtual void lateUpdate() {}
+    // copies everything draw() needs into a RenderSnapshot (main thread, after lateUpdate)
+    // false if draw() still reads the live game state, the next frame is then drawn after the update instead of next to it
+    virtual bool capture() { return false; }
 
     std::string getName() const { return name; }
     bool isActive() const { return active; }
@@ -49,6 +57,8 @@ public:
     Music* music = nullptr;
     std::string currentMusicKey;
 
+    std::vector<Subscription> subscriptions; // event listeners that are removed with the scene
+
 private:
     std::string name;
     int drawPriority = 0;
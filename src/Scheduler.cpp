@@ -0,0 +1,109 @@
+#include "Scheduler.h"
+#include <algorithm>
+
+
+namespace {
+    // std heap functions build a max-heap, so the comparison is reversed
+    struct Later {
+        template <typename E>
+        bool operator()(const E& a, const E& b) const {
+            if (a.due != b.due) return a.due > b.due;
+            return a.sequence > b.sequence;
+        }
+    };
+}
+
+TimerHandle Scheduler::add(float delay, Timer timer) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+    Slot& s = slots[slot];
+    s.timer = std::move(timer);
+    s.used = true;
+    s.cancelled = false;
+    active++;
+    push(Entry{ now + delay, nextSequence++, slot, s.generation });
+    return TimerHandle{ slot, s.generation };
+}
+
+void Scheduler::push(Entry entry) {
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end(), Later());
+}
+
+void Scheduler::release(uint32_t slot) {
+    Slot& s = slots[slot];
+    s.timer = Timer();
+    s.used = false;
+    s.cancelled = false;
+    s.generation++;
+    freeSlots.push_back(slot);
+    active--;
+}
+
+bool Scheduler::isPending(TimerHandle handle) const {
+    if (handle.slot >= slots.size()) return false;
+    const Slot& s = slots[handle.slot];
+    return s.used && !s.cancelled && s.generation == handle.generation;
+}
+
+bool Scheduler::cancel(TimerHandle handle) {
+    if (!isPending(handle)) return false;
+    if (handle.slot == firing) {
+        // the callback is running right now (a timer cancelling itself)
+        slots[handle.slot].cancelled = true;
+        return true;
+    }
+    release(handle.slot); // the heap entry has the old generation now and is skipped
+    return true;
+}
+
+void Scheduler::update(float deltaTime, const FireFn& fire) {
+    now += deltaTime;
+    while (!heap.empty() && heap.front().due <= now) {
+        std::pop_heap(heap.begin(), heap.end(), Later());
+        Entry entry = heap.back();
+        heap.pop_back();
+        Slot& s = slots[entry.slot];
+        if (!s.used || s.generation != entry.generation)
+            continue; // cancelled
+
+        firing = entry.slot;
+        fire(s.timer);
+        firing = UINT32_MAX;
+
+        Timer& timer = s.timer;
+        bool repeats = timer.interval > 0.0f;
+        if (s.cancelled || !repeats) {
+            release(entry.slot);
+            continue;
+        }
+        if (--timer.repeatsLeft <= 0) {
+            auto onComplete = std::move(timer.onComplete);
+            release(entry.slot);
+            if (onComplete) onComplete();
+            continue;
+        }
+        rescheduled.push_back(Entry{ entry.due + timer.interval, nextSequence++, entry.slot, entry.generation });
+    }
+    for (const Entry& entry : rescheduled) {
+        // might have been cancelled by a later timer in the same update
+        if (slots[entry.slot].used && slots[entry.slot].generation == entry.generation) push(entry);
+    }
+    rescheduled.clear();
+}
+
+void Scheduler::clear() {
+    for (uint32_t slot = 0; slot < slots.size(); ++slot) {
+        if (!slots[slot].used) continue;
+        if (slot == firing) slots[slot].cancelled = true;
+        else release(slot);
+    }
+    heap.clear();
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <any>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "StringId.h"
+
+// the delayed and repeated events of the EventManager
+// timers are kept in a min-heap by the absolute game time they are due, so update() only
+// looks at the timers that fire (plus the cancelled ones that come up on top of the heap)
+// cancelling through a handle is O(1), the heap entry is just skipped when it comes up
+
+struct TimerHandle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0; // slots are reused, old handles don't match anymore
+    bool valid() const { return slot != UINT32_MAX; }
+};
+
+class Scheduler {
+public:
+    struct Timer {
+        StringId key; // pushed as an event every time the timer fires
+        std::any value;
+        std::function<void()> callback;
+        float interval = 0.0f; // 0 for a delayed event
+        int repeatsLeft = 1;
+        std::function<void()> onComplete; // after the last repeat
+    };
+    using FireFn = std::function<void(Timer&)>;
+
+    TimerHandle add(float delay, Timer timer);
+    bool cancel(TimerHandle handle);
+    bool isPending(TimerHandle handle) const;
+    // advances the game time, calls fire for every timer that is due (earliest first)
+    // a repeated timer fires at most once per update, like it did when every timer counted down each frame
+    void update(float deltaTime, const FireFn& fire);
+    void clear();
+
+    size_t size() const { return active; }
+    double getTime() const { return now; }
+
+private:
+    struct Slot {
+        Timer timer;
+        uint32_t generation = 0;
+        bool used = false;
+        bool cancelled = false; // cancelled while it was firing, freed afterwards
+    };
+    struct Entry {
+        double due;
+        uint64_t sequence; // timers that are due at the same time fire in the order they were added
+        uint32_t slot;
+        uint32_t generation;
+    };
+    std::deque<Slot> slots; // a deque, so firing timers can add new ones without moving the one that's running
+    std::vector<uint32_t> freeSlots;
+    std::vector<Entry> heap;
+    std::vector<Entry> rescheduled; // repeats that fired in this update, pushed back afterwards
+    double now = 0.0;
+    uint64_t nextSequence = 0;
+    size_t active = 0;
+    uint32_t firing = UINT32_MAX;
+
+    void push(Entry entry);
+    void release(uint32_t slot);
+};
@@ -0,0 +1,80 @@
+#include "SpawnList.h"
+
+
+namespace {
+    SpawnKind spriteKind(const std::string& name) {
+        // the object name picks the spawn code in InGame::spawnObject
+        if (name == "teleport") return SpawnKind::Teleport;
+        if (name == "npc") return SpawnKind::Npc;
+        if (name == "tradeItem") return SpawnKind::TradeItem;
+        if (name == "enemy") return SpawnKind::Enemy;
+        if (name == "door") return SpawnKind::Door;
+        if (name == "hurt") return SpawnKind::Hurt;
+        if (name == "chest") return SpawnKind::Chest;
+        return SpawnKind::Sprite;
+    }
+
+    bool hasNumber(const TileProperties& properties, const char* key) {
+        // value() ignores properties with the wrong type, so they don't count as overrides
+        const TileProperty* property = properties.find(key);
+        return property && property->type != TileProperty::STRING;
+    }
+}
+
+SpawnList::SpawnList(const TileMap& map, const std::unordered_map<std::string, uint32_t>& archetypeIds, uint32_t fallback) {
+    entries.reserve(map.objects.size());
+    for (size_t i = 0; i < map.objects.size(); ++i) {
+        const TileObject& obj = map.objects[i];
+        if (!obj.visible)
+            continue;
+        SpawnEntry entry;
+        if (obj.type == "wall") {
+            entry.kind = SpawnKind::Wall;
+        }
+        else if (obj.type == "sprite") {
+            entry.kind = spriteKind(obj.name);
+        }
+        else {
+            continue; // nothing spawns for other object types
+        }
+        entry.roomState = obj.properties.value("roomState", static_cast<uint8_t>(0));
+        entry.object = static_cast<uint32_t>(i);
+        entry.id = obj.id;
+        entry.bounds = Rectangle{ obj.x, obj.y, obj.width, obj.height };
+
+        if (entry.kind != SpawnKind::Wall) {
+            std::string spriteName = obj.properties.value("spriteName", "sprite_default");
+            auto it = archetypeIds.find(spriteName);
+            if (it != archetypeIds.end()) {
+                entry.archetype = it->second;
+            }
+            else {
+                TraceLog(LOG_WARNING, "%s: missing sprite data for %s (object %u), falling back to sprite_default",
+                    map.getName().c_str(), spriteName.c_str(), obj.id);
+                entry.archetype = fallback;
+            }
+
+            SpawnOverrides& o = entry.overrides;
+            if (hasNumber(obj.properties, "speed")) {
+                o.set |= SpawnOverrides::SPEED;
+                o.speed = obj.properties.value("speed", 0.0f);
+            }
+            if (hasNumber(obj.properties, "damage")) {
+                o.set |= SpawnOverrides::DAMAGE;
+                o.damage = obj.properties.value("damage", 0);
+            }
+            if (hasNumber(obj.properties, "knockback")) {
+                o.set |= SpawnOverrides::KNOCKBACK;
+                o.knockback = obj.properties.value("knockback", 0.0f);
+            }
+            float hurtboxW = obj.properties.value("hurtboxW", 0.0f);
+            float hurtboxH = obj.properties.value("hurtboxH", 0.0f);
+            if (hurtboxW != 0.0f && hurtboxH != 0.0f) {
+                o.set |= SpawnOverrides::HURTBOX;
+                o.hurtbox = Vector2{ hurtboxW, hurtboxH };
+            }
+            o.drawLayer = obj.properties.value("drawLayer", 0);
+        }
+        entries.push_back(entry);
+    }
+}
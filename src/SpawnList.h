@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "raylib.h"
+#include "TileMap.h"
+
+// the objects of a tile map, compiled into what InGame needs to spawn them
+// this is done once per map (the first time a room with it is entered), after that entering a room
+// only filters the list by room state and object states instead of looking at every TileObject again
+
+enum class SpawnKind : uint8_t {
+    Wall,
+    Teleport,
+    Npc,
+    TradeItem,
+    Enemy,
+    Door,
+    Hurt,
+    Chest,
+    Sprite // any other sprite object, only archetype data
+};
+
+struct SpawnOverrides {
+    // instance-specific values from the Tiled properties, they replace the archetype's
+    enum : uint8_t {
+        SPEED = 1 << 0,
+        DAMAGE = 1 << 1,
+        KNOCKBACK = 1 << 2,
+        HURTBOX = 1 << 3
+    };
+    uint8_t set = 0; // which of the values below came from Tiled
+    int damage = 0;
+    float speed = 0.0f;
+    float knockback = 0.0f;
+    Vector2 hurtbox = { 0.0f, 0.0f };
+    int drawLayer = 0;
+};
+
+struct SpawnEntry {
+    SpawnKind kind = SpawnKind::Sprite;
+    uint8_t roomState = 0; // room states the object exists in, 0 = all of them
+    uint32_t archetype = 0; // SpriteArchetype::id, unused for walls
+    uint32_t object = 0; // index into TileMap::objects, for the properties only a few kinds have
+    uint32_t id = 0; // Tiled object id, the key of the room's object states
+    Rectangle bounds = { 0.0f, 0.0f, 0.0f, 0.0f };
+    SpawnOverrides overrides;
+
+    bool existsIn(uint8_t currentState) const { return roomState == 0 || (roomState & currentState) != 0; }
+};
+
+class SpawnList {
+public:
+    SpawnList() = default;
+    // archetypeIds maps sprite names to archetype ids (AssetLoader), unknown names get the fallback id
+    SpawnList(const TileMap& map, const std::unordered_map<std::string, uint32_t>& archetypeIds, uint32_t fallback);
+
+    const std::vector<SpawnEntry>& getEntries() const { return entries; }
+    size_t size() const { return entries.size(); }
+    const SpawnEntry& operator[](size_t index) const { return entries[index]; }
+
+private:
+    std::vector<SpawnEntry> entries; // in the order of the map objects, invisible objects are left out
+};
@@ -93,14 +93,33 @@ void Sprite::executeBehavior(float deltaTime) {
     // TODO: behavior priority system?
     if (behaviors.empty()) return;
     for (auto& behavior : behaviors) {
-        behavior->update(deltaTime);
+        if (!behavior->isSteering()) behavior->update(deltaTime);
     }
 }
 
-void Sprite::drawBehavior() {
+bool Sprite::hasSteering() const {
+    for (const auto& behavior : behaviors) {
+        if (behavior->isSteering()) return true;
+    }
+    return false;
+}
+
+void Sprite::steer(float deltaTime, Steering& out) {
+    for (auto& behavior : behaviors) {
+        if (behavior->isSteering()) behavior->steer(deltaTime, out);
+    }
+}
+
+void Sprite::applySteering(const Steering& steering) {
+    if (steering.hasAcc) acc = steering.acc;
+    if (steering.stop) vel = { 0.0f, 0.0f };
+    if (steering.lastDirection >= 0) lastDirection = static_cast<direction>(steering.lastDirection);
+}
+
+void Sprite::drawBehavior(RenderSnapshot& out) {
     if (behaviors.empty()) return;
     for (auto& behavior : behaviors) {
-        behavior->draw();
+        behavior->draw(out);
     }
 }
 
@@ -175,12 +194,12 @@ void Sprite::update(float deltaTime) {
     }
 }
 
-void Sprite::draw() {
+void Sprite::draw(RenderSnapshot& out) {
     if (!visible || markedForDeletion) return;
     auto& textures = frames[currentAnimState];
     if (currentFrame >= textures.size()) {
         // show that something went wrong
-        DrawRectangleRec(rect, BLUE);
+        out.drawRectangleRec(rect, BLUE);
         return;
     }
     Texture2D& texture = textures[currentFrame];
@@ -201,7 +220,7 @@ void Sprite::draw() {
             dest.width, 
             dest.height 
         };
-        DrawRectangleRec(debugRect, BLUE);
+        out.drawRectangleRec(debugRect, BLUE);
     }
 
     // Flip horizontally if lastDirection is LEFT
@@ -215,17 +234,7 @@ void Sprite::draw() {
     }
     // draw the texture (change the tint if the sprite has been hit)
     // also rotate around the bottom center
-    // and apply a shader, if set
-    if (activeShader) {
-        int timeLoc = GetShaderLocation(*activeShader->shader, "time");
-        int flipXLoc = GetShaderLocation(*activeShader->shader, "flipX");
-        int durationLoc = GetShaderLocation(*activeShader->shader, "duration");
-        SetShaderValue(*activeShader->shader, timeLoc, &activeShader->time, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(*activeShader->shader, flipXLoc, &activeShader->flipX, SHADER_UNIFORM_INT);
-        SetShaderValue(*activeShader->shader, durationLoc, &activeShader->duration, SHADER_UNIFORM_FLOAT);
-        BeginShaderMode(*activeShader->shader);
-    }
-    DrawTexturePro(texture, source, dest, origin, rotationAngle, currentTint);
-    if (activeShader) EndShaderMode();
+    // and apply a shader, if set (the snapshot sets its uniforms)
+    out.drawTexturePro(texture, source, dest, origin, rotationAngle, currentTint, activeShader ? &*activeShader : nullptr);
 }
 
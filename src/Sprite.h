@@ -7,17 +7,12 @@
 #include <memory>
 #include <optional>
 #include "Behavior.h"
+#include "Subscription.h"
+#include "RenderSnapshot.h"
 #include <cstdint>
 
 class Game;
 
-struct ShaderState {
-    const Shader* shader = nullptr;
-    float time = 0.0f;
-    float duration = 2.0f;
-    int flipX = 0;
-};
-
 enum AnimState {
     IDLE,
     RUN,
@@ -78,6 +73,7 @@ public:
     uint32_t damage = 0;
     float knockback = 10.0f;
     bool dying = false; // flag for the death animation
+    std::vector<Subscription> subscriptions; // event listeners that are removed with the sprite
     
     Sprite(Game& game, float x, float y, float w, float h, const std::string& spriteName);
     ~Sprite();
@@ -86,7 +82,7 @@ public:
     void setHurtbox(float x = -1.0f, float y = -1.0f, float width = -1.0f, float height = -1.0f, bool center = false);
     void getControls();
     void update(float deltaTime);
-    void draw();
+    void draw(RenderSnapshot& out); // records the draw calls, see RenderSnapshot
     void moveTo(float x, float y);
 
     bool isMarkedForDeletion() const { return markedForDeletion; }
@@ -99,8 +95,11 @@ public:
     void removeAllBehaviors() {
         behaviors.clear();
     }
-    void executeBehavior(float deltaTime);
-    void drawBehavior(); // TODO: good or bad design?
+    void executeBehavior(float deltaTime); // all but the steering behaviors
+    bool hasSteering() const;
+    void steer(float deltaTime, Steering& out); // the steering behaviors, in order (runs on a worker thread)
+    void applySteering(const Steering& steering);
+    void drawBehavior(RenderSnapshot& out); // TODO: good or bad design?
 
 private:
     std::vector<std::unique_ptr<Behavior>> behaviors;
@@ -0,0 +1,72 @@
+#include "SpriteArchetype.h"
+
+
+namespace {
+    // field from data, or from the defaults if data doesn't have it
+    template <typename T>
+    T field(const nlohmann::json& data, const nlohmann::json& defaults, const char* key, T fallback) {
+        if (data.contains(key)) return data.at(key).get<T>();
+        if (defaults.is_object() && defaults.contains(key)) return defaults.at(key).get<T>();
+        return fallback;
+    }
+
+    Vector2 pair(const nlohmann::json& value) {
+        return Vector2{ value[0].get<float>(), value[1].get<float>() };
+    }
+}
+
+SpriteArchetype SpriteArchetype::fromData(const std::string& name, const nlohmann::json& data,
+    const nlohmann::json& spriteDefaults, const nlohmann::json& weaponDefaults) {
+    SpriteArchetype a;
+    a.name = name;
+
+    a.textureKeys = field(data, spriteDefaults, "textures", std::vector<std::string>());
+    a.health = field(data, spriteDefaults, "health", a.health);
+    a.damage = field(data, spriteDefaults, "damage", a.damage);
+    a.speed = field(data, spriteDefaults, "speed", a.speed);
+    a.knockback = field(data, spriteDefaults, "knockback", a.knockback);
+    if (data.contains("hitbox")) {
+        a.hasHitbox = true;
+        a.hitbox = pair(data.at("hitbox"));
+    }
+    if (data.contains("hitboxOffset")) a.hitboxOffset = pair(data.at("hitboxOffset"));
+    if (data.contains("collides")) {
+        a.hasCollides = true;
+        a.collides = data.at("collides").get<int>() != 0;
+    }
+
+    for (const auto& key : data.value("behaviors", nlohmann::json::array())) {
+        std::string behavior = key.get<std::string>();
+        if (behavior == "RandomWalk") a.behaviors.push_back(BehaviorKind::RandomWalk);
+        else if (behavior == "Watch") a.behaviors.push_back(BehaviorKind::Watch);
+        else if (behavior == "Chase") a.behaviors.push_back(BehaviorKind::Chase);
+        else if (behavior == "Dialogue") a.behaviors.push_back(BehaviorKind::Dialogue);
+        else if (behavior == "Shoot") a.behaviors.push_back(BehaviorKind::Shoot);
+        else if (behavior == "Emitter") a.behaviors.push_back(BehaviorKind::Emitter);
+        else TraceLog(LOG_WARNING, "Sprite data %s: unknown behavior %s", name.c_str(), behavior.c_str());
+    }
+    if (data.contains("behaviorData")) {
+        const auto& b = data.at("behaviorData");
+        BehaviorParams& p = a.behaviorParams;
+        p.watchTarget = b.value("watchTarget", p.watchTarget);
+        p.chaseTarget = b.value("chaseTarget", p.chaseTarget);
+        p.shootTarget = b.value("shootTarget", p.shootTarget);
+        p.dialogue = b.value("dialogue", p.dialogue);
+        p.voice = b.value("voice", p.voice);
+        p.emitterPreset = b.value("emitterPreset", p.emitterPreset);
+        p.particle = b.value("particle", p.particle);
+    }
+    if (data.contains("itemDrops")) {
+        for (const auto& drop : data.at("itemDrops")) {
+            a.itemDrops.push_back(ItemDrop{ drop.at(0).get<std::string>(), drop.at(1).get<float>() });
+        }
+    }
+
+    WeaponStats& w = a.weapon;
+    w.hurtboxOffset = { field(data, weaponDefaults, "HurtboxOffsetX", w.hurtboxOffset.x), field(data, weaponDefaults, "HurtboxOffsetY", w.hurtboxOffset.y) };
+    w.hurtboxSize = { field(data, weaponDefaults, "HurtboxWidth", w.hurtboxSize.x), field(data, weaponDefaults, "HurtboxHeight", w.hurtboxSize.y) };
+    w.damage = field(data, weaponDefaults, "damage", w.damage);
+    w.lifetime = field(data, weaponDefaults, "lifetime", w.lifetime);
+    w.type = field(data, weaponDefaults, "type", w.type);
+    return a;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "raylib.h"
+#include "json.hpp"
+
+// the sprite data from enemies.json, npcs.json and weapons.json, compiled once after loading
+// (see AssetLoader::postprocessSpriteData) so spawning a sprite doesn't have to look anything up in the JSON
+
+enum class BehaviorKind : uint8_t {
+    RandomWalk,
+    Watch,
+    Chase,
+    Dialogue,
+    Shoot,
+    Emitter
+};
+
+struct BehaviorParams {
+    // "behaviorData" in the JSON, empty strings if not given
+    std::string watchTarget;
+    std::string chaseTarget;
+    std::string shootTarget;
+    std::string dialogue; // text key
+    std::string voice = "tone";
+    std::string emitterPreset = "smoke";
+    std::string particle; // replaces the emitter preset's texture
+};
+
+struct ItemDrop {
+    std::string itemId;
+    float chance; // the chances of all drops add up, one roll per death
+};
+
+struct WeaponStats {
+    // only used for entries in weapons.json
+    Vector2 hurtboxOffset = { 0.0f, 0.0f };
+    Vector2 hurtboxSize = { 16.0f, 16.0f };
+    int damage = 1;
+    float lifetime = 0.4f;
+    int type = 0; // weaponType
+    std::vector<Texture2D> frames; // the texture with the same key as the weapon
+};
+
+struct SpriteArchetype {
+    std::string name;
+    uint32_t id = 0; // index in the loader's table
+    bool isAbstract = false; // only inherited from or used for defaults (sprite_default, weapon_default)
+
+    std::vector<std::string> textureKeys;
+    std::vector<std::vector<Texture2D>> frames; // textureKeys resolved, copied into the sprite
+
+    int health = 10;
+    int damage = 0;
+    float speed = 10.0f;
+    float knockback = 0.0f;
+    bool hasHitbox = false; // otherwise the size of the Tiled object is used
+    Vector2 hitbox = { 16.0f, 16.0f };
+    Vector2 hitboxOffset = { 0.0f, 0.0f };
+    bool hasCollides = false;
+    bool collides = true;
+
+    std::vector<BehaviorKind> behaviors;
+    BehaviorParams behaviorParams;
+    std::vector<ItemDrop> itemDrops;
+    WeaponStats weapon;
+
+    // data has the inheritance resolved already, missing fields come from the defaults
+    // (sprite_default and weapon_default, like the old lookups in InGame did)
+    static SpriteArchetype fromData(const std::string& name, const nlohmann::json& data,
+        const nlohmann::json& spriteDefaults, const nlohmann::json& weaponDefaults);
+};
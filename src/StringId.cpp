@@ -0,0 +1,49 @@
+#include "StringId.h"
+#include "raylib.h"
+#include <unordered_map>
+#include <mutex>
+#include <cstdio>
+#include <exception>
+
+
+namespace {
+    // the interned names, only read for logs (the AsyncLoader adds assets from the main thread,
+    // but the lock keeps interning safe from anywhere)
+    struct NameTable {
+        std::mutex mutex;
+        std::unordered_map<uint32_t, std::string> names;
+    };
+
+    NameTable& nameTable() {
+        static NameTable table;
+        return table;
+    }
+}
+
+StringId StringId::intern(std::string_view text) {
+    StringId id(text);
+    NameTable& table = nameTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto [it, inserted] = table.names.try_emplace(id.value, text);
+    if (!inserted && it->second != text) {
+        // two names would share one map entry and silently replace each other's assets,
+        // one of them has to be renamed before the game can run
+        TraceLog(LOG_ERROR, "STRINGID: \"%.*s\" and \"%s\" have the same hash %08x",
+            static_cast<int>(text.size()), text.data(), it->second.c_str(), id.value);
+        std::terminate();
+    }
+    return id;
+}
+
+const char* StringId::str() const {
+    NameTable& table = nameTable();
+    {
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto it = table.names.find(value);
+        // the strings of an unordered_map don't move, so the pointer stays valid
+        if (it != table.names.end()) return it->second.c_str();
+    }
+    thread_local char unknown[16];
+    std::snprintf(unknown, sizeof(unknown), "#%08x", value);
+    return unknown;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstdint>
+
+// 32 bit FNV-1a hash of a name, used as the key of the asset and event maps instead of the string
+// "hurt1"_id is hashed at compile time, a std::string is hashed where it is converted (no allocation)
+// names are registered with StringId::intern when an asset is loaded or a listener is added,
+// that's where collisions are detected, and it's what str() uses to print the name in logs
+
+constexpr uint32_t fnv1a(std::string_view text) {
+    uint32_t hash = 2166136261u;
+    for (char c : text) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+struct StringId {
+    uint32_t value = 0;
+
+    constexpr StringId() = default;
+    constexpr explicit StringId(uint32_t hash) : value(hash) {}
+    // implicit, so functions that take a StringId still accept strings
+    constexpr StringId(std::string_view text) : value(fnv1a(text)) {}
+    constexpr StringId(const char* text) : value(fnv1a(text)) {}
+    StringId(const std::string& text) : value(fnv1a(text)) {}
+
+    static StringId intern(std::string_view text); // hashes and registers the name, terminates on a collision
+    const char* str() const; // the registered name, or "#" and the hash in hex if it was never interned
+
+    constexpr bool operator==(StringId other) const { return value == other.value; }
+    constexpr bool operator!=(StringId other) const { return value != other.value; }
+    constexpr bool operator<(StringId other) const { return value < other.value; }
+};
+
+constexpr StringId operator""_id(const char* text, size_t length) {
+    return StringId(std::string_view(text, length));
+}
+
+namespace std {
+    template <>
+    struct hash<StringId> {
+        size_t operator()(StringId id) const noexcept { return id.value; } // already a hash
+    };
+}
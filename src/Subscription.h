@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include "StringId.h"
+
+class EventManager;
+
+// owns an event listener (see EventManager::listen), the listener is removed when this is destroyed
+// sprites and scenes keep theirs in a std::vector<Subscription> subscriptions, so the listeners
+// go away with them (and don't call into a deleted sprite or scene)
+
+class Subscription {
+public:
+    Subscription() = default;
+    Subscription(EventManager* manager, StringId key, uint32_t handle) : manager(manager), key(key), handle(handle) {}
+    ~Subscription() { reset(); }
+
+    Subscription(Subscription&& other) noexcept
+        : manager(std::exchange(other.manager, nullptr)), key(other.key), handle(std::exchange(other.handle, 0)) {}
+    Subscription& operator=(Subscription&& other) noexcept {
+        if (this != &other) {
+            reset();
+            manager = std::exchange(other.manager, nullptr);
+            key = other.key;
+            handle = std::exchange(other.handle, 0);
+        }
+        return *this;
+    }
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    void reset(); // removes the listener now (nothing happens if a once listener already fired)
+    uint32_t getHandle() const { return handle; }
+
+private:
+    EventManager* manager = nullptr;
+    StringId key;
+    uint32_t handle = 0;
+};
@@ -20,59 +20,22 @@ TextBox::TextBox(Game& game, float x, float y, float width, float height, int fo
 void TextBox::endPage(size_t index) { 
     pageDone = true;
     currentPageStartIndex += index;
-    currentLine = 0;
 } // helper function
 
 void TextBox::formatText() {
-    formattedtext.clear();
     std::string_view text = textContent.substr(currentPageStartIndex);
     // Handle forced page break
     size_t ffPos = text.find('\f');
     if (ffPos != std::string_view::npos) {
         text = text.substr(0, ffPos);  // only process text up to \f
     }
-    size_t start = 0;
-    size_t spacePos = 0; // position of the next space
-    std::string line;
-    // find the next space
-    while ((spacePos = text.find(' ', start)) != std::string_view::npos) {
-        std::string_view word = text.substr(start, spacePos - start);
-        std::string testLine = line.empty() ? std::string(word) : line + " " + std::string(word);
-        if (MeasureText(testLine.c_str(), fontSize) > int(width) - 10) {
-            formattedtext += line + "\n";
-            currentLine++;
-            Vector2 size = MeasureTextEx(GetFontDefault(), formattedtext.c_str(), float(fontSize), 2.0f);
-            float lineHeight = size.y / (currentLine + 1);
-            if (lineHeight * (currentLine + 1) + lineHeight > height) {
-                endPage(start);
-                return;
-            }
-            line = std::string(word);
-        }
-        else {
-            line = testLine;
-        }
-        start = spacePos + 1;
-    }
-    if (start < text.size()) {
-        std::string_view word = text.substr(start);
-        std::string testLine = line.empty() ? std::string(word) : line + " " + std::string(word);
-        if (MeasureText(testLine.c_str(), fontSize) > int(width) - 10) {
-            formattedtext += line + "\n";
-            currentLine++;
-            Vector2 size = MeasureTextEx(GetFontDefault(), formattedtext.c_str(), float(fontSize), 2.0f);
-            float lineHeight = size.y / (currentLine + 1);
-            if (lineHeight * (currentLine + 1) + lineHeight > height) {
-                endPage(start);
-                return;
-            }
-            line = std::string(word);
-        }
-        else {
-            line = testLine;
-        }
+    // wrapping and paging is done by the layout engine (5 px margin on each side)
+    const Font& font = game.loader.getFont("slkscr");
+    page = game.textLayout.layout(text, font, float(fontSize), width - 10.0f, height - 10.0f);
+    if (page->overflow) {
+        endPage(page->consumed);
+        return;
     }
-    formattedtext += line;
     // End page if form feed was in original string
     if (ffPos != std::string_view::npos) {
         endPage(ffPos + 1);
@@ -85,6 +48,7 @@ void TextBox::setTextContent(std::string_view text) {
 }
 
 void TextBox::update(float deltaTime) {
+    const std::string& formattedtext = page->text;
     // show more than one character if text speed is faster than the frame rate
     size_t charAtATime = 1;
     if (textSpeed < deltaTime) {
@@ -151,6 +115,6 @@ void TextBox::update(float deltaTime) {
 
 void TextBox::draw() {
     DrawRectangle(int(x), int(y), int(width), int(height), BLACK);
-    DrawText(formattedtext.substr(0, currentStrIndex).data(), int(x) + 5, int(y) + 5, fontSize, WHITE);
+    game.textLayout.draw(*page, { x + 5.0f, y + 5.0f }, WHITE, currentStrIndex);
 }
 
@@ -2,6 +2,8 @@
 #include "raylib.h"
 #include <string>
 #include <vector>
+#include <memory>
+#include "TextLayout.h"
 
 class Game;
 
@@ -21,11 +23,10 @@ public:
 private:
     float x, y, width, height;
     std::string_view textContent;
-    std::string formattedtext;  // Stores text with line breaks
+    std::shared_ptr<const TextLayout> page; // the current page, page->text stores the text with line breaks
     int fontSize;
 
     size_t currentStrIndex = 0;
-    int currentLine = 0;
     size_t currentPageStartIndex = 0;
     bool pageDone = false;
     bool finished = false;
@@ -0,0 +1,202 @@
+#include "TextLayout.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cmath>
+
+static uint64_t hashText(std::string_view text) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+const TextLayoutEngine::FontMetrics& TextLayoutEngine::getMetrics(const Font& font) {
+    auto it = metrics.find(font.texture.id);
+    if (it != metrics.end()) return it->second;
+
+    FontMetrics m;
+    m.baseSize = static_cast<float>(std::max(font.baseSize, 1));
+    m.padding = static_cast<float>(font.glyphPadding);
+    for (int c = 32; c < 127; c++) {
+        int glyph = GetGlyphIndex(font, c);
+        const Rectangle& rec = font.recs[glyph];
+        const GlyphInfo& info = font.glyphs[glyph];
+        m.advance[c - 32] = info.advanceX ? static_cast<float>(info.advanceX) : rec.width;
+        m.src[c - 32] = { rec.x - m.padding, rec.y - m.padding, rec.width + 2.0f * m.padding, rec.height + 2.0f * m.padding };
+        m.offset[c - 32] = { static_cast<float>(info.offsetX), static_cast<float>(info.offsetY) };
+    }
+    m.fallback = '?' - 32;
+    return metrics.emplace(font.texture.id, m).first->second;
+}
+
+TextLayout TextLayoutEngine::build(std::string_view text, const Font& font, float fontSize, float maxWidth, float maxHeight) {
+    const FontMetrics& m = getMetrics(font);
+    const float scale = fontSize / m.baseSize;
+    const float lineHeight = fontSize + lineSpacing;
+    const size_t maxLines = (maxHeight > 0.0f) ? std::max<size_t>(1, static_cast<size_t>((maxHeight + lineSpacing) / lineHeight)) : 0;
+    const float spaceAdvance = m.advance[0] * scale + spacing;
+
+    TextLayout out;
+    out.textureId = font.texture.id;
+    out.textureWidth = static_cast<float>(std::max(font.texture.width, 1));
+    out.textureHeight = static_cast<float>(std::max(font.texture.height, 1));
+    out.text.reserve(text.size());
+    out.glyphs.reserve(text.size());
+
+    auto glyphIndex = [&](unsigned char c) {
+        return (c >= 32 && c < 127) ? c - 32 : m.fallback;
+    };
+
+    float penX = 0.0f;
+    float penY = 0.0f;
+    bool lineHasContent = false;
+
+    auto finishLine = [&]() {
+        out.size.x = std::max(out.size.x, penX > 0.0f ? penX - spacing : 0.0f);
+        out.lineCount++;
+    };
+    // ends the current line, returns false if the page is full
+    auto breakLine = [&]() {
+        finishLine();
+        if (maxLines && out.lineCount >= maxLines) return false;
+        out.text += '\n';
+        penX = 0.0f;
+        penY += lineHeight;
+        lineHasContent = false;
+        return true;
+    };
+
+    size_t i = 0;
+    const size_t n = text.size();
+    bool pageFull = false;
+    while (i < n) {
+        if (text[i] == '\n') {
+            if (!breakLine()) {
+                out.consumed = i + 1;
+                pageFull = true;
+                break;
+            }
+            i++;
+            continue;
+        }
+        // a word and the spaces in front of it
+        size_t spaces = 0;
+        while (i < n && text[i] == ' ') {
+            spaces++;
+            i++;
+        }
+        size_t wordStart = i;
+        float wordAdvance = 0.0f;
+        while (i < n && text[i] != ' ' && text[i] != '\n') {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if ((c & 0xC0) != 0x80) wordAdvance += m.advance[glyphIndex(c)] * scale + spacing; // skip UTF-8 continuation bytes
+            i++;
+        }
+        size_t wordEnd = i;
+        if (wordStart == wordEnd && spaces == 0) continue;
+
+        if (lineHasContent) {
+            float spaceWidth = spaces * spaceAdvance;
+            if (maxWidth > 0.0f && penX + spaceWidth + wordAdvance - spacing > maxWidth && wordStart != wordEnd) {
+                if (!breakLine()) {
+                    out.consumed = wordStart;
+                    pageFull = true;
+                    break;
+                }
+            }
+            else {
+                out.text.append(spaces, ' ');
+                penX += spaceWidth;
+            }
+        }
+        // words that are wider than maxWidth get their own line and are not split
+        for (size_t k = wordStart; k < wordEnd; k++) {
+            unsigned char c = static_cast<unsigned char>(text[k]);
+            uint32_t index = static_cast<uint32_t>(out.text.size());
+            out.text += static_cast<char>(c);
+            if ((c & 0xC0) == 0x80) continue;
+            int g = glyphIndex(c);
+            const Rectangle& src = m.src[g];
+            out.glyphs.push_back({
+                src,
+                Rectangle{
+                    penX + (m.offset[g].x - m.padding) * scale,
+                    penY + (m.offset[g].y - m.padding) * scale,
+                    src.width * scale,
+                    src.height * scale
+                },
+                index
+            });
+            penX += m.advance[g] * scale + spacing;
+        }
+        if (wordStart != wordEnd) lineHasContent = true;
+    }
+
+    if (pageFull) {
+        out.overflow = true;
+    }
+    else {
+        finishLine();
+        out.consumed = n;
+    }
+    out.size.y = out.lineCount * lineHeight - lineSpacing;
+    return out;
+}
+
+std::shared_ptr<const TextLayout> TextLayoutEngine::layout(std::string_view text, const Font& font, float fontSize, float maxWidth, float maxHeight) {
+    Key key{ hashText(text), font.texture.id, fontSize, maxWidth, maxHeight };
+    auto it = cache.find(key);
+    if (it != cache.end() && it->second.source == text) {
+        cacheHits++;
+        return it->second.layout;
+    }
+    cacheMisses++;
+    if (cache.size() >= maxCacheEntries) cache.clear(); // layouts still in use are kept alive by their shared_ptr
+    auto result = std::make_shared<const TextLayout>(build(text, font, fontSize, maxWidth, maxHeight));
+    cache[key] = Entry{ std::string(text), result };
+    return result;
+}
+
+float TextLayoutEngine::measure(std::string_view text, const Font& font, float fontSize) {
+    return layout(text, font, fontSize)->size.x;
+}
+
+void TextLayoutEngine::draw(const TextLayout& layout, Vector2 position, Color tint, size_t maxChars) const {
+    if (layout.glyphs.empty()) return;
+
+    // one quad per glyph, all from the same texture, so they end up in the same draw call
+    // (split into chunks so a long text can't overflow raylib's vertex buffer)
+    constexpr size_t chunkSize = 512;
+    const float tw = layout.textureWidth;
+    const float th = layout.textureHeight;
+    size_t g = 0;
+    const size_t count = layout.glyphs.size();
+    while (g < count && layout.glyphs[g].index < maxChars) {
+        size_t end = std::min(g + chunkSize, count);
+        rlCheckRenderBatchLimit(static_cast<int>(4 * (end - g)));
+        rlSetTexture(layout.textureId);
+        rlBegin(RL_QUADS);
+        rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        for (; g < end; g++) {
+            const PlacedGlyph& glyph = layout.glyphs[g];
+            if (glyph.index >= maxChars) break;
+            // snap to whole pixels, otherwise the pixel font gets blurry
+            float x = std::floor(position.x + glyph.dst.x);
+            float y = std::floor(position.y + glyph.dst.y);
+            float u0 = glyph.src.x / tw;
+            float v0 = glyph.src.y / th;
+            float u1 = (glyph.src.x + glyph.src.width) / tw;
+            float v1 = (glyph.src.y + glyph.src.height) / th;
+            rlTexCoord2f(u0, v0); rlVertex2f(x, y);
+            rlTexCoord2f(u0, v1); rlVertex2f(x, y + glyph.dst.height);
+            rlTexCoord2f(u1, v1); rlVertex2f(x + glyph.dst.width, y + glyph.dst.height);
+            rlTexCoord2f(u1, v0); rlVertex2f(x + glyph.dst.width, y);
+        }
+        rlEnd();
+    }
+    rlSetTexture(0);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "raylib.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+// word wrapping and glyph placement for bitmap text
+// layouts are cached, so text that doesn't change is only measured once
+// and gets drawn in a single batch (one texture bind, one quad per visible glyph)
+
+struct PlacedGlyph {
+    Rectangle src; // rect in the font texture (including padding)
+    Rectangle dst; // relative to the layout origin
+    uint32_t index; // position in TextLayout::text, used for the typewriter effect
+};
+
+struct TextLayout {
+    std::string text; // the wrapped text, with '\n' at the line breaks
+    std::vector<PlacedGlyph> glyphs; // visible glyphs only (no spaces), in text order
+    Vector2 size = { 0.0f, 0.0f };
+    size_t lineCount = 0;
+    size_t consumed = 0; // how many chars of the source text fit (everything, unless maxHeight was hit)
+    bool overflow = false; // true if the text didn't fit into maxHeight
+    unsigned int textureId = 0;
+    float textureWidth = 1.0f;
+    float textureHeight = 1.0f;
+};
+
+class TextLayoutEngine {
+public:
+    // maxWidth <= 0: no wrapping, maxHeight <= 0: no paging
+    std::shared_ptr<const TextLayout> layout(std::string_view text, const Font& font, float fontSize, float maxWidth = 0.0f, float maxHeight = 0.0f);
+    // lays out without touching the cache (used by the benchmark)
+    TextLayout build(std::string_view text, const Font& font, float fontSize, float maxWidth, float maxHeight);
+    float measure(std::string_view text, const Font& font, float fontSize); // width of a single line (cached)
+
+    // draws at most maxChars characters of the layout (counted in TextLayout::text)
+    void draw(const TextLayout& layout, Vector2 position, Color tint, size_t maxChars = SIZE_MAX) const;
+
+    void clear() { cache.clear(); }
+    float spacing = 1.0f; // extra space between characters, in pixels
+    float lineSpacing = 2.0f; // extra space between lines, in pixels
+    size_t cacheHits = 0;
+    size_t cacheMisses = 0;
+
+private:
+    struct FontMetrics {
+        // precomputed from the font once, for the printable ASCII range
+        std::array<float, 95> advance{};
+        std::array<Rectangle, 95> src{};
+        std::array<Vector2, 95> offset{};
+        int fallback = 0; // '?'
+        float baseSize = 1.0f;
+        float padding = 0.0f;
+    };
+    std::unordered_map<unsigned int, FontMetrics> metrics; // keyed by the font's texture id
+    const FontMetrics& getMetrics(const Font& font);
+
+    struct Key {
+        uint64_t textHash;
+        unsigned int fontId;
+        float fontSize, maxWidth, maxHeight;
+        bool operator==(const Key& other) const {
+            return textHash == other.textHash && fontId == other.fontId && fontSize == other.fontSize &&
+                maxWidth == other.maxWidth && maxHeight == other.maxHeight;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            return static_cast<size_t>(k.textHash ^ (uint64_t(k.fontId) << 32) ^
+                (uint64_t(k.fontSize * 16.0f) << 8) ^ uint64_t(k.maxWidth * 4.0f) ^ (uint64_t(k.maxHeight * 4.0f) << 16));
+        }
+    };
+    struct Entry {
+        std::string source; // to rule out hash collisions
+        std::shared_ptr<const TextLayout> layout;
+    };
+    std::unordered_map<Key, Entry, KeyHash> cache;
+    static constexpr size_t maxCacheEntries = 512; // the cache is simply dropped when it gets full
+};
@@ -1,31 +1,231 @@
 #include "TileMap.h"
+#include <algorithm>
 
 
+void Tileset::computeTileColors(const Image& image) {
+    // finds the modal colour of every tile once, so the mini maps
+    // can be built from tile ids without rendering the rooms
+    tileColors.assign(tilecount, BLANK);
+    if (!image.data || columns == 0) return;
+
+    Color* pixels = LoadImageColors(image);
+    std::vector<uint32_t> keys;
+    keys.reserve(static_cast<size_t>(tilewidth) * tileheight);
+
+    for (uint32_t i = 0; i < tilecount; i++) {
+        uint32_t tx = (i % columns) * tilewidth;
+        uint32_t ty = (i / columns) * tileheight;
+        if (tx + tilewidth > (uint32_t)image.width || ty + tileheight > (uint32_t)image.height) break;
+
+        keys.clear();
+        for (uint32_t y = ty; y < ty + tileheight; y++) {
+            for (uint32_t x = tx; x < tx + tilewidth; x++) {
+                const Color& c = pixels[y * image.width + x];
+                if (c.a == 0) continue; // transparent pixels would win on most decoration tiles
+                keys.push_back((uint32_t(c.r) << 24) | (uint32_t(c.g) << 16) | (uint32_t(c.b) << 8) | c.a);
+            }
+        }
+        if (keys.empty()) continue;
+
+        // sorting puts equal colours next to each other, the longest run is the mode
+        std::sort(keys.begin(), keys.end());
+        uint32_t best = keys[0];
+        size_t bestCount = 0;
+        for (size_t start = 0; start < keys.size();) {
+            size_t end = start;
+            while (end < keys.size() && keys[end] == keys[start]) end++;
+            if (end - start > bestCount) {
+                bestCount = end - start;
+                best = keys[start];
+            }
+            start = end;
+        }
+        tileColors[i] = Color{
+            static_cast<unsigned char>(best >> 24),
+            static_cast<unsigned char>(best >> 16),
+            static_cast<unsigned char>(best >> 8),
+            static_cast<unsigned char>(best)
+        };
+    }
+    UnloadImageColors(pixels);
+}
+
+bool TileProperty::operator==(const TileProperty& other) const {
+    if (name != other.name || type != other.type) return false;
+    switch (type) {
+    case FLOAT: return floatValue == other.floatValue;
+    case STRING: return stringValue == other.stringValue;
+    default: return intValue == other.intValue;
+    }
+}
+
+TileProperties::TileProperties(const nlohmann::json& tiledProperties) {
+    // the type is taken from the JSON value, not from Tiled's "type" field
+    // (Tiled writes whole floats as integers, value() converts between numbers anyway)
+    for (const auto& p : tiledProperties) {
+        if (!p.contains("name") || !p.contains("value")) continue;
+        TileProperty property;
+        property.name = p["name"];
+        const auto& v = p["value"];
+        if (v.is_boolean()) {
+            property.type = TileProperty::BOOL;
+            property.intValue = v.get<bool>() ? 1 : 0;
+        }
+        else if (v.is_number_integer()) {
+            property.type = TileProperty::INT;
+            property.intValue = v.get<int64_t>();
+        }
+        else if (v.is_number_float()) {
+            property.type = TileProperty::FLOAT;
+            property.floatValue = v.get<double>();
+        }
+        else {
+            // strings, colors and files; class properties are kept as their JSON text
+            property.type = TileProperty::STRING;
+            property.stringValue = v.is_string() ? v.get<std::string>() : v.dump();
+        }
+        properties.push_back(std::move(property));
+    }
+}
+
+const TileProperty* TileProperties::find(const std::string& key) const {
+    for (const auto& property : properties) {
+        if (property.name == key) return &property;
+    }
+    return nullptr;
+}
+
+std::string TileProperties::value(const std::string& key, const char* defaultValue) const {
+    const TileProperty* property = find(key);
+    if (!property || property->type != TileProperty::STRING) return defaultValue;
+    return property->stringValue;
+}
+
 TileLayer::TileLayer(const nlohmann::json& layerJson) {
     name = layerJson["name"];
     width = layerJson["width"];
     height = layerJson["height"];
     visible = layerJson["visible"];
 
-    // Get the flat 1D array from JSON
-    std::vector<int> flatData = layerJson["data"].get<std::vector<int>>();
-
-    // Resize the 2D vector to fit width x height
-    data.resize(height, std::vector<int>(width));
-
-    // Convert 1D array into 2D
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            data[y][x] = flatData[y * width + x];
+    // the flat array from Tiled is already row major
+    const auto& flatData = layerJson["data"];
+    tiles.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < tiles.size() && i < flatData.size(); ++i) {
+        uint32_t id = flatData[i].get<uint32_t>();
+        if (id > 0xFFFF) {
+            // Tiled keeps the flip flags in the top bits, those aren't supported
+            TraceLog(LOG_WARNING, "Layer %s: tile id %u at %zu is not supported", name.c_str(), id, i);
+            id = 0;
         }
+        tiles[i] = static_cast<uint16_t>(id);
     }
 
     // Handle properties
     if (layerJson.contains("properties")) {
-        for (const auto& prop : layerJson["properties"]) {
-            properties[prop["name"]] = prop["value"].dump();
+        properties = TileProperties(layerJson["properties"]);
+    }
+    compact();
+}
+
+TileLayer::TileLayer(std::string name, int width, int height, std::vector<uint16_t> tiles)
+    : name(std::move(name)), width(width), height(height), tiles(std::move(tiles)) {
+    this->tiles.resize(static_cast<size_t>(width) * height);
+    compact();
+}
+
+uint16_t TileLayer::at(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return 0;
+    if (!sparse) return tiles[static_cast<size_t>(y) * width + x];
+    for (uint32_t i = rowStart[y]; i < rowStart[y + 1]; ++i) {
+        const TileRun& run = runs[i];
+        if (x < run.x) break; // runs are sorted
+        if (x < run.x + run.length) return run.id;
+    }
+    return 0;
+}
+
+void TileLayer::set(int x, int y, uint16_t id) {
+    if (x < 0 || y < 0 || x >= width || y >= height) return;
+    if (sparse) {
+        std::vector<uint16_t> dense(static_cast<size_t>(width) * height);
+        for (int row = 0; row < height; ++row) copyRow(row, dense.data() + static_cast<size_t>(row) * width);
+        tiles = std::move(dense);
+        runs.clear();
+        runs.shrink_to_fit();
+        rowStart.clear();
+        rowStart.shrink_to_fit();
+        sparse = false;
+    }
+    tiles[static_cast<size_t>(y) * width + x] = id;
+}
+
+TileRow TileLayer::row(int y) const {
+    if (sparse || y < 0 || y >= height) return TileRow();
+    return TileRow{ tiles.data() + static_cast<size_t>(y) * width, static_cast<size_t>(width) };
+}
+
+void TileLayer::copyRow(int y, uint16_t* out) const {
+    if (!sparse) {
+        std::copy_n(tiles.data() + static_cast<size_t>(y) * width, width, out);
+        return;
+    }
+    std::fill_n(out, width, uint16_t(0));
+    for (uint32_t i = rowStart[y]; i < rowStart[y + 1]; ++i) {
+        std::fill_n(out + runs[i].x, runs[i].length, runs[i].id);
+    }
+}
+
+void TileLayer::compact() {
+    if (sparse || tiles.empty() || width > 0xFFFF) return;
+
+    std::vector<TileRun> newRuns;
+    std::vector<uint32_t> newRowStart;
+    newRowStart.reserve(static_cast<size_t>(height) + 1);
+    size_t denseBytes = tiles.size() * sizeof(uint16_t);
+    for (int y = 0; y < height; ++y) {
+        newRowStart.push_back(static_cast<uint32_t>(newRuns.size()));
+        const uint16_t* r = tiles.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width;) {
+            if (!r[x]) {
+                x++;
+                continue;
+            }
+            int start = x;
+            while (x < width && r[x] == r[start]) x++;
+            newRuns.push_back(TileRun{ static_cast<uint16_t>(start), static_cast<uint16_t>(x - start), r[start] });
         }
+        // give up early on dense layers like the floor
+        if ((newRuns.size() * sizeof(TileRun) + newRowStart.size() * sizeof(uint32_t)) * 2 > denseBytes) return;
     }
+    newRowStart.push_back(static_cast<uint32_t>(newRuns.size()));
+
+    runs = std::move(newRuns);
+    runs.shrink_to_fit();
+    rowStart = std::move(newRowStart);
+    tiles.clear();
+    tiles.shrink_to_fit();
+    sparse = true;
+}
+
+size_t TileLayer::memoryUsage() const {
+    return tiles.capacity() * sizeof(uint16_t) + runs.capacity() * sizeof(TileRun) + rowStart.capacity() * sizeof(uint32_t);
+}
+
+bool TileLayer::operator==(const TileLayer& other) const {
+    if (width != other.width || height != other.height) return false;
+    std::vector<uint16_t> a(width), b(width);
+    for (int y = 0; y < height; ++y) {
+        copyRow(y, a.data());
+        other.copyRow(y, b.data());
+        if (a != b) return false;
+    }
+    return true;
+}
+
+TileMap::TileMap(std::string mapName, std::string tilesetName, std::string music)
+    : width(0), height(0), tileWidth(0), tileHeight(0),
+    mapName(std::move(mapName)), tilesetName(std::move(tilesetName)), music(std::move(music))
+{
 }
 
 TileMap::TileMap(const nlohmann::json& jsonMap, std::string mapName) 
@@ -63,6 +263,13 @@ TileMap::TileMap(const nlohmann::json& jsonMap, std::string mapName)
     }
 }
 
+size_t TileMap::memoryUsage() const {
+    size_t bytes = sizeof(TileMap) + layers.capacity() * sizeof(TileLayer) + objects.capacity() * sizeof(TileObject);
+    for (const auto& layer : layers) bytes += layer.memoryUsage() + layer.properties.size() * sizeof(TileProperty);
+    for (const auto& obj : objects) bytes += obj.properties.size() * sizeof(TileProperty);
+    return bytes;
+}
+
 const TileLayer& TileMap::getLayer(size_t index) const {
     if (index >= layers.size()) throw std::out_of_range("Layer index out of bounds");
     return layers[index];
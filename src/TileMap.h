@@ -4,12 +4,20 @@
 #include <unordered_map>
 #include <stdexcept>
 #include <filesystem>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include "raylib.h"
 #include "json.hpp"
 
 struct Tileset {
     // used to store the data from *.tsj files
     std::string name, image;
     uint32_t imagewidth, imageheight, tilecount, tileheight, tilewidth, columns;
+    std::vector<Color> tileColors; // most common (non transparent) colour of each tile, used for the mini map
+
+    void computeTileColors(const Image& image); // needs the CPU side image, call this before it gets unloaded
 
     Tileset() = default;
 
@@ -25,23 +33,146 @@ struct Tileset {
     }
 };
 
-struct TileLayer {
+struct TileProperty {
+    // one custom property of a Tiled object or layer, with its value already converted
+    enum Type : uint8_t {
+        BOOL,
+        INT,
+        FLOAT,
+        STRING
+    };
+    std::string name;
+    Type type = INT;
+    int64_t intValue = 0; // also holds BOOL
+    double floatValue = 0.0;
+    std::string stringValue;
+
+    bool operator==(const TileProperty& other) const;
+    bool operator!=(const TileProperty& other) const { return !(*this == other); }
+};
+
+class TileProperties {
+    // replaces the nlohmann::json that used to hold the properties
+    // value() works like nlohmann's, so the spawning code didn't have to change
+public:
+    TileProperties() = default;
+    explicit TileProperties(const nlohmann::json& tiledProperties); // the "properties" array from Tiled
+
+    const TileProperty* find(const std::string& key) const;
+    bool contains(const std::string& key) const { return find(key) != nullptr; }
+    // returns the default if the key is missing or has the wrong type
+    template <typename T>
+    T value(const std::string& key, T defaultValue) const {
+        static_assert(std::is_arithmetic_v<T>, "use the string overload");
+        const TileProperty* property = find(key);
+        if (!property) return defaultValue;
+        switch (property->type) {
+        case TileProperty::BOOL:
+        case TileProperty::INT:
+            return static_cast<T>(property->intValue);
+        case TileProperty::FLOAT:
+            return static_cast<T>(property->floatValue);
+        default:
+            return defaultValue;
+        }
+    }
+    std::string value(const std::string& key, const char* defaultValue) const;
+    std::string value(const std::string& key, const std::string& defaultValue) const { return value(key, defaultValue.c_str()); }
+
+    void add(TileProperty property) { properties.push_back(std::move(property)); }
+    const std::vector<TileProperty>& items() const { return properties; }
+    size_t size() const { return properties.size(); }
+    bool operator==(const TileProperties& other) const { return properties == other.properties; }
+    bool operator!=(const TileProperties& other) const { return !(*this == other); }
+
+private:
+    std::vector<TileProperty> properties; // only a handful per object, a linear search is fine
+};
+
+struct TileRow {
+    // view of one row of tile ids (std::span is C++20)
+    const uint16_t* tiles = nullptr;
+    size_t count = 0;
+
+    const uint16_t* begin() const { return tiles; }
+    const uint16_t* end() const { return tiles + count; }
+    uint16_t operator[](size_t x) const { return tiles[x]; }
+    size_t size() const { return count; }
+};
+
+struct TileRun {
+    // horizontal run of the same tile id in a sparse layer, runs never cross rows
+    uint16_t x;
+    uint16_t length;
+    uint16_t id;
+};
+
+class TileLayer {
+    // tile ids (0 = empty) in one contiguous row major grid
+    // layers that are mostly empty (walls, decoration) are stored as runs of non-empty tiles instead, see compact()
+public:
     std::string name;
-    bool visible;
-    int width, height;
-    std::vector<std::vector<int>> data;
-    std::unordered_map<std::string, std::string> properties;  // TODO parse properties as JSON
+    bool visible = true;
+    int width = 0, height = 0;
+    TileProperties properties;
+
+    TileLayer() = default;
     TileLayer(const nlohmann::json& layerJson);
+    TileLayer(std::string name, int width, int height, std::vector<uint16_t> tiles); // tiles are row major
+
+    uint16_t at(int x, int y) const; // 0 outside of the layer
+    void set(int x, int y, uint16_t id); // turns a sparse layer back into a dense one
+    bool isSparse() const { return sparse; }
+    TileRow row(int y) const; // dense layers only
+    void copyRow(int y, uint16_t* out) const; // works for both, out needs room for width ids
+
+    // calls f(x, y, id) for every non-empty tile in [x0, x1) x [y0, y1), row by row
+    template <typename F>
+    void forEachTile(int x0, int y0, int x1, int y1, F&& f) const {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, width);
+        y1 = std::min(y1, height);
+        for (int y = y0; y < y1; ++y) {
+            if (!sparse) {
+                const uint16_t* r = tiles.data() + static_cast<size_t>(y) * width;
+                for (int x = x0; x < x1; ++x) {
+                    if (r[x]) f(x, y, r[x]);
+                }
+                continue;
+            }
+            for (uint32_t i = rowStart[y]; i < rowStart[y + 1]; ++i) {
+                const TileRun& run = runs[i];
+                int start = std::max<int>(run.x, x0);
+                int end = std::min<int>(run.x + run.length, x1);
+                for (int x = start; x < end; ++x) f(x, y, run.id);
+            }
+        }
+    }
+    template <typename F>
+    void forEachTile(F&& f) const { forEachTile(0, 0, width, height, std::forward<F>(f)); }
+
+    void compact(); // switches to the sparse storage if that saves at least half of the memory
+    size_t memoryUsage() const; // bytes on the heap for the tiles
+    bool operator==(const TileLayer& other) const; // same size and tiles, ignores name and properties
+    bool operator!=(const TileLayer& other) const { return !(*this == other); }
+
+private:
+    std::vector<uint16_t> tiles; // dense storage
+    bool sparse = false;
+    std::vector<TileRun> runs; // sparse storage
+    std::vector<uint32_t> rowStart; // first run of each row, height + 1 entries
 };
 
 struct TileObject {
     // Tiled map objects (sprites etc.)
     std::string type, name;
-    float x, y, width, height;
-    bool visible;
-    uint32_t id;
-    nlohmann::json properties;
+    float x = 0.0f, y = 0.0f, width = 0.0f, height = 0.0f;
+    bool visible = true;
+    uint32_t id = 0;
+    TileProperties properties;
 
+    TileObject() = default;
     TileObject(const nlohmann::json& objJson) :
         type(objJson["type"]),
         visible(objJson["visible"]),
@@ -53,14 +184,7 @@ struct TileObject {
         id(objJson["id"])
     {
         if (objJson.contains("properties") && objJson["properties"].is_array()) {
-            for (const auto& p : objJson["properties"]) {
-                if (p.contains("name") && p.contains("value")) {
-                    properties[p["name"]] = p["value"];
-                }
-            }
-        }
-        else {
-            properties = nlohmann::json::object();
+            properties = TileProperties(objJson["properties"]);
         }
     }
 };
@@ -68,11 +192,13 @@ struct TileObject {
 class TileMap {
 public:
     TileMap(const nlohmann::json& jsonMap, std::string mapName);
+    TileMap(std::string mapName, std::string tilesetName, std::string music); // empty map, filled by the binary loader (TileMapBinary.h)
     const TileLayer& getLayer(size_t index) const;
     const std::vector<TileObject>& getObjects() const;
     const std::string& getName() const { return mapName; }
     const std::string& getTilesetName() const { return tilesetName; }
     const std::string& getMusicKey() const { return music; }
+    size_t memoryUsage() const; // rough number of bytes, for the dungeon's memory report
 
     size_t width, height, tileWidth, tileHeight;
     std::vector<TileLayer> layers;
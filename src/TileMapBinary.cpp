@@ -0,0 +1,320 @@
+#include "TileMapBinary.h"
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <filesystem>
+
+
+namespace {
+
+    // compiling
+
+    class StringTable {
+    public:
+        uint32_t add(const std::string& text) {
+            auto it = ids.find(text);
+            if (it != ids.end()) return it->second;
+            uint32_t id = static_cast<uint32_t>(strings.size());
+            strings.push_back(text);
+            ids.emplace(text, id);
+            return id;
+        }
+        const std::vector<std::string>& all() const { return strings; }
+
+    private:
+        std::vector<std::string> strings;
+        std::unordered_map<std::string, uint32_t> ids;
+    };
+
+    template <typename T>
+    void append(std::vector<unsigned char>& out, const T& value) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void alignTo(std::vector<unsigned char>& out, size_t alignment) {
+        while (out.size() % alignment) out.push_back(0);
+    }
+
+    void addProperties(const TileProperties& properties, StringTable& strings, std::vector<TmbProperty>& out) {
+        for (const auto& property : properties.items()) {
+            TmbProperty record;
+            std::memset(&record, 0, sizeof(record));
+            record.name = strings.add(property.name);
+            record.type = property.type;
+            switch (property.type) {
+            case TileProperty::FLOAT: record.floatValue = property.floatValue; break;
+            case TileProperty::STRING: record.stringValue = strings.add(property.stringValue); break;
+            default: record.intValue = property.intValue; break;
+            }
+            out.push_back(record);
+        }
+    }
+
+    // loading
+
+    struct Reader {
+        const unsigned char* data;
+        size_t size;
+
+        template <typename T>
+        bool read(size_t offset, T& value) const {
+            if (offset > size || size - offset < sizeof(T)) return false;
+            std::memcpy(&value, data + offset, sizeof(T));
+            return true;
+        }
+    };
+
+    bool readProperties(const Reader& reader, const TmbHeader& header, const std::vector<std::string>& strings,
+        uint32_t first, uint32_t count, TileProperties& out) {
+        if (first > header.propertyCount || header.propertyCount - first < count) return false;
+        for (uint32_t i = first; i < first + count; ++i) {
+            TmbProperty record;
+            if (!reader.read(header.propertiesOffset + i * sizeof(TmbProperty), record)) return false;
+            if (record.name >= strings.size()) return false;
+            TileProperty property;
+            property.name = strings[record.name];
+            property.type = static_cast<TileProperty::Type>(record.type);
+            switch (property.type) {
+            case TileProperty::BOOL:
+            case TileProperty::INT:
+                property.intValue = record.intValue;
+                break;
+            case TileProperty::FLOAT:
+                property.floatValue = record.floatValue;
+                break;
+            case TileProperty::STRING:
+                if (record.stringValue >= strings.size()) return false;
+                property.stringValue = strings[record.stringValue];
+                break;
+            default:
+                return false;
+            }
+            out.add(std::move(property));
+        }
+        return true;
+    }
+}
+
+
+std::vector<unsigned char> compileTileMap(const nlohmann::json& jsonMap) {
+    if (!jsonMap.contains("tilesets") || jsonMap["tilesets"].empty()) {
+        throw std::runtime_error("map has no tileset");
+    }
+    // Tiled stores flipped tiles in the top bits, the game doesn't support those
+    // (the JSON loader just warns and clears them, the compiler refuses)
+    for (const auto& layer : jsonMap["layers"]) {
+        if (layer["type"] != "tilelayer") continue;
+        for (const auto& id : layer["data"]) {
+            if (id.get<uint64_t>() > 0xFFFF) {
+                throw std::runtime_error("layer '" + layer["name"].get<std::string>() + "' has tile id " + id.dump() + " (flipped tile or tileset too large)");
+            }
+        }
+    }
+    // same interpretation as the JSON loader, then written out
+    TileMap map(jsonMap, "");
+
+    StringTable strings;
+    TmbHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TMB_MAGIC, 4);
+    header.version = TMB_VERSION;
+    header.width = static_cast<uint32_t>(map.width);
+    header.height = static_cast<uint32_t>(map.height);
+    header.tileWidth = static_cast<uint32_t>(map.tileWidth);
+    header.tileHeight = static_cast<uint32_t>(map.tileHeight);
+    header.tilesetName = strings.add(map.getTilesetName());
+    header.music = strings.add(map.getMusicKey());
+
+    std::vector<TmbProperty> properties;
+    std::vector<TmbLayer> layers;
+    std::vector<std::vector<uint16_t>> tiles;
+    for (const auto& layer : map.layers) {
+        TmbLayer record;
+        std::memset(&record, 0, sizeof(record));
+        record.name = strings.add(layer.name);
+        record.width = static_cast<uint32_t>(layer.width);
+        record.height = static_cast<uint32_t>(layer.height);
+        record.visible = layer.visible ? 1 : 0;
+        record.firstProperty = static_cast<uint32_t>(properties.size());
+        record.propertyCount = static_cast<uint32_t>(layer.properties.size());
+        addProperties(layer.properties, strings, properties);
+
+        // always dense in the file, the loader decides about the storage
+        std::vector<uint16_t> grid(static_cast<size_t>(layer.width) * layer.height);
+        for (int y = 0; y < layer.height; ++y) {
+            layer.copyRow(y, grid.data() + static_cast<size_t>(y) * layer.width);
+        }
+        layers.push_back(record);
+        tiles.push_back(std::move(grid));
+    }
+
+    std::vector<TmbObject> objects;
+    for (const auto& obj : map.objects) {
+        TmbObject record;
+        std::memset(&record, 0, sizeof(record));
+        record.type = strings.add(obj.type);
+        record.name = strings.add(obj.name);
+        record.x = obj.x;
+        record.y = obj.y;
+        record.width = obj.width;
+        record.height = obj.height;
+        record.id = obj.id;
+        record.visible = obj.visible ? 1 : 0;
+        record.firstProperty = static_cast<uint32_t>(properties.size());
+        record.propertyCount = static_cast<uint32_t>(obj.properties.size());
+        addProperties(obj.properties, strings, properties);
+        objects.push_back(record);
+    }
+
+    header.stringCount = static_cast<uint32_t>(strings.all().size());
+    header.layerCount = static_cast<uint32_t>(layers.size());
+    header.objectCount = static_cast<uint32_t>(objects.size());
+    header.propertyCount = static_cast<uint32_t>(properties.size());
+
+    // lay out the sections, fixed size records first and the variable sized data at the end
+    size_t offset = sizeof(TmbHeader);
+    header.stringsOffset = static_cast<uint32_t>(offset);
+    offset += strings.all().size() * sizeof(TmbString);
+    offset = (offset + 7) / 8 * 8;
+    header.layersOffset = static_cast<uint32_t>(offset);
+    offset += layers.size() * sizeof(TmbLayer);
+    header.objectsOffset = static_cast<uint32_t>(offset);
+    offset += objects.size() * sizeof(TmbObject);
+    offset = (offset + 7) / 8 * 8;
+    header.propertiesOffset = static_cast<uint32_t>(offset);
+    offset += properties.size() * sizeof(TmbProperty);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        layers[i].tilesOffset = static_cast<uint32_t>(offset);
+        offset += tiles[i].size() * sizeof(uint16_t);
+        offset = (offset + 3) / 4 * 4;
+    }
+    size_t charactersOffset = offset;
+
+    std::vector<unsigned char> out;
+    append(out, header);
+    size_t characterPosition = charactersOffset;
+    for (const auto& text : strings.all()) {
+        append(out, TmbString{ static_cast<uint32_t>(characterPosition), static_cast<uint32_t>(text.size()) });
+        characterPosition += text.size();
+    }
+    alignTo(out, 8);
+    for (const auto& record : layers) append(out, record);
+    for (const auto& record : objects) append(out, record);
+    alignTo(out, 8);
+    for (const auto& record : properties) append(out, record);
+    for (const auto& grid : tiles) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(grid.data());
+        out.insert(out.end(), bytes, bytes + grid.size() * sizeof(uint16_t));
+        alignTo(out, 4);
+    }
+    for (const auto& text : strings.all()) {
+        out.insert(out.end(), text.begin(), text.end());
+    }
+    return out;
+}
+
+std::unique_ptr<TileMap> loadCompiledTileMap(const unsigned char* data, size_t size, const std::string& mapName) {
+    Reader reader{ data, size };
+    TmbHeader header;
+    if (!reader.read(0, header) || std::memcmp(header.magic, TMB_MAGIC, 4) != 0 || header.version != TMB_VERSION) {
+        return nullptr;
+    }
+
+    std::vector<std::string> strings(header.stringCount);
+    for (uint32_t i = 0; i < header.stringCount; ++i) {
+        TmbString entry;
+        if (!reader.read(header.stringsOffset + i * sizeof(TmbString), entry)) return nullptr;
+        if (entry.offset > size || size - entry.offset < entry.length) return nullptr;
+        strings[i].assign(reinterpret_cast<const char*>(data + entry.offset), entry.length);
+    }
+    auto stringAt = [&](uint32_t id) -> const std::string* {
+        return id < strings.size() ? &strings[id] : nullptr;
+    };
+    if (!stringAt(header.tilesetName) || !stringAt(header.music)) return nullptr;
+
+    auto map = std::make_unique<TileMap>(mapName, strings[header.tilesetName], strings[header.music]);
+    map->width = header.width;
+    map->height = header.height;
+    map->tileWidth = header.tileWidth;
+    map->tileHeight = header.tileHeight;
+
+    map->layers.resize(header.layerCount);
+    for (uint32_t i = 0; i < header.layerCount; ++i) {
+        TmbLayer record;
+        if (!reader.read(header.layersOffset + i * sizeof(TmbLayer), record) || !stringAt(record.name)) return nullptr;
+        size_t tileCount = static_cast<size_t>(record.width) * record.height;
+        if (record.tilesOffset > size || (size - record.tilesOffset) / sizeof(uint16_t) < tileCount) return nullptr;
+
+        // same layout as in memory, one copy
+        std::vector<uint16_t> tiles(tileCount);
+        std::memcpy(tiles.data(), data + record.tilesOffset, tileCount * sizeof(uint16_t));
+        TileLayer& layer = map->layers[i];
+        layer = TileLayer(strings[record.name], static_cast<int>(record.width), static_cast<int>(record.height), std::move(tiles));
+        layer.visible = record.visible != 0;
+        if (!readProperties(reader, header, strings, record.firstProperty, record.propertyCount, layer.properties)) return nullptr;
+    }
+
+    map->objects.resize(header.objectCount);
+    for (uint32_t i = 0; i < header.objectCount; ++i) {
+        TmbObject record;
+        if (!reader.read(header.objectsOffset + i * sizeof(TmbObject), record)) return nullptr;
+        if (!stringAt(record.type) || !stringAt(record.name)) return nullptr;
+        TileObject& obj = map->objects[i];
+        obj.type = strings[record.type];
+        obj.name = strings[record.name];
+        obj.x = record.x;
+        obj.y = record.y;
+        obj.width = record.width;
+        obj.height = record.height;
+        obj.id = record.id;
+        obj.visible = record.visible != 0;
+        if (!readProperties(reader, header, strings, record.firstProperty, record.propertyCount, obj.properties)) return nullptr;
+    }
+    return map;
+}
+
+std::vector<unsigned char> compileTileset(const nlohmann::json& jsonTileset) {
+    Tileset tileset(jsonTileset);
+    std::string imagePath = jsonTileset["image"];
+
+    TsbHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TSB_MAGIC, 4);
+    header.version = TMB_VERSION;
+    header.imagewidth = tileset.imagewidth;
+    header.imageheight = tileset.imageheight;
+    header.tilecount = tileset.tilecount;
+    header.tileheight = tileset.tileheight;
+    header.tilewidth = tileset.tilewidth;
+    header.columns = tileset.columns;
+    header.nameLength = static_cast<uint32_t>(tileset.name.size());
+    header.imageLength = static_cast<uint32_t>(imagePath.size());
+
+    std::vector<unsigned char> out;
+    append(out, header);
+    out.insert(out.end(), tileset.name.begin(), tileset.name.end());
+    out.insert(out.end(), imagePath.begin(), imagePath.end());
+    return out;
+}
+
+bool loadCompiledTileset(const unsigned char* data, size_t size, Tileset& tileset, std::string& imagePath) {
+    Reader reader{ data, size };
+    TsbHeader header;
+    if (!reader.read(0, header) || std::memcmp(header.magic, TSB_MAGIC, 4) != 0 || header.version != TMB_VERSION) {
+        return false;
+    }
+    if (size - sizeof(TsbHeader) < static_cast<size_t>(header.nameLength) + header.imageLength) return false;
+
+    const char* characters = reinterpret_cast<const char*>(data + sizeof(TsbHeader));
+    tileset.name.assign(characters, header.nameLength);
+    imagePath.assign(characters + header.nameLength, header.imageLength);
+    tileset.image = std::filesystem::path(imagePath).filename().string(); // basename, like the JSON constructor
+    tileset.imagewidth = header.imagewidth;
+    tileset.imageheight = header.imageheight;
+    tileset.tilecount = header.tilecount;
+    tileset.tileheight = header.tileheight;
+    tileset.tilewidth = header.tilewidth;
+    tileset.columns = header.columns;
+    return true;
+}
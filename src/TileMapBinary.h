@@ -0,0 +1,81 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "TileMap.h"
+
+/*
+Compiled versions of the Tiled files, made by tools/tilemap_compiler.cpp
+.tmb (maps) and .tsb (tilesets) sit next to the .json/.tsj they were made from
+
+.tmb layout (little endian, all offsets from the start of the file):
+    TmbHeader
+    string table    stringCount x { offset, length }, the characters follow (not terminated)
+    layers          layerCount x TmbLayer, the tiles are uint16_t (row major) at tilesOffset
+    objects         objectCount x TmbObject
+    properties      propertyCount x TmbProperty, layers and objects refer to a range of these
+
+loading is just reading fixed size records, nothing has to be parsed
+*/
+
+constexpr char TMB_MAGIC[4] = { 'G', 'T', 'M', 'B' };
+constexpr char TSB_MAGIC[4] = { 'G', 'T', 'S', 'B' };
+constexpr uint32_t TMB_VERSION = 1;
+constexpr uint32_t TMB_NO_STRING = 0xFFFFFFFF;
+
+struct TmbHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width, height, tileWidth, tileHeight;
+    uint32_t tilesetName, music; // string ids
+    uint32_t stringCount, layerCount, objectCount, propertyCount;
+    uint32_t stringsOffset, layersOffset, objectsOffset, propertiesOffset;
+};
+
+struct TmbString {
+    uint32_t offset, length;
+};
+
+struct TmbLayer {
+    uint32_t name;
+    uint32_t width, height;
+    uint32_t visible;
+    uint32_t firstProperty, propertyCount;
+    uint32_t tilesOffset;
+    uint32_t padding;
+};
+
+struct TmbObject {
+    uint32_t type, name;
+    float x, y, width, height;
+    uint32_t id;
+    uint32_t visible;
+    uint32_t firstProperty, propertyCount;
+};
+
+struct TmbProperty {
+    uint32_t name;
+    uint32_t type; // TileProperty::Type
+    union {
+        int64_t intValue;
+        double floatValue;
+        uint64_t stringValue; // string id
+    };
+};
+
+struct TsbHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t imagewidth, imageheight, tilecount, tileheight, tilewidth, columns;
+    uint32_t nameLength, imageLength; // the characters follow the header
+};
+
+// compiling, throws std::runtime_error if the map can't be stored (e.g. tile ids above 65535 or flipped tiles)
+std::vector<unsigned char> compileTileMap(const nlohmann::json& jsonMap);
+std::vector<unsigned char> compileTileset(const nlohmann::json& jsonTileset);
+
+// loading, return nullptr/false if the data is not a valid compiled file
+std::unique_ptr<TileMap> loadCompiledTileMap(const unsigned char* data, size_t size, const std::string& mapName);
+// imagePath is the image path as written in the .tsj (relative to the tileset file)
+bool loadCompiledTileset(const unsigned char* data, size_t size, Tileset& tileset, std::string& imagePath);
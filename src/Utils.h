@@ -4,6 +4,7 @@
 #include <vector>
 #include <memory>
 #include <cstdarg>
+#include <cstdint>
 #include <filesystem>
 #include "json.hpp"
 
@@ -39,4 +40,25 @@ inline std::string format(const char* fmt, ...) {
     std::vsnprintf(buffer, sizeof(buffer), fmt, args);
     va_end(args);
     return std::string(buffer);
-}
\ No newline at end of file
+}
+struct FastRandom {
+    // small xorshift PRNG (4 bytes of state instead of mt19937's 5 KB)
+    // good enough for visual effects, don't use it for anything gameplay related
+    uint32_t state;
+
+    explicit FastRandom(uint32_t seed = 0x9E3779B9u) : state{ seed ? seed : 0x9E3779B9u } {}
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    float nextFloat() {
+        // [0, 1)
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+    float range(float min, float max) {
+        return min + (max - min) * nextFloat();
+    }
+};
@@ -0,0 +1,348 @@
+#ifdef GAME_HEADLESS
+// only compiled into the headless build, the others link the real raylib (see CMakeLists.txt)
+#include "NullRaylib.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <utility>
+
+namespace {
+    HeadlessStats stats;
+    int logLevel = LOG_INFO;
+    int screenWidth = 0;
+    int screenHeight = 0;
+    unsigned int nextId = 1; // texture ids, 0 means "not loaded" to the game
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    std::mt19937 rng{ 0 };
+
+    bool readPngSize(const unsigned char* data, size_t size, int& width, int& height) {
+        // the IHDR chunk always comes first: 8 bytes signature, 8 bytes chunk header, then width and height
+        static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        if (size < 24 || std::memcmp(data, signature, 8) != 0) return false;
+        width = (data[16] << 24) | (data[17] << 16) | (data[18] << 8) | data[19];
+        height = (data[20] << 24) | (data[21] << 16) | (data[22] << 8) | data[23];
+        return width > 0 && height > 0;
+    }
+
+    Image blankImage(int width, int height) {
+        Image image = { 0 };
+        if (width <= 0 || height <= 0) return image;
+        image.data = std::calloc(static_cast<size_t>(width) * height, sizeof(Color));
+        image.width = width;
+        image.height = height;
+        image.mipmaps = 1;
+        image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        return image;
+    }
+
+    Texture2D stubTexture(int width, int height) {
+        stats.texturesLoaded++;
+        return Texture2D{ nextId++, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    }
+
+    Font stubFont(int size) {
+        // monospaced ASCII, half as wide as it is high
+        const int glyphCount = 95;
+        Font font = { 0 };
+        font.baseSize = size;
+        font.glyphCount = glyphCount;
+        font.texture = stubTexture(size * 16, size * 6);
+        font.recs = static_cast<Rectangle*>(std::calloc(glyphCount, sizeof(Rectangle)));
+        font.glyphs = static_cast<GlyphInfo*>(std::calloc(glyphCount, sizeof(GlyphInfo)));
+        for (int i = 0; i < glyphCount; ++i) {
+            font.glyphs[i].value = 32 + i;
+            font.glyphs[i].advanceX = size / 2;
+            font.recs[i] = { float((i % 16) * size), float((i / 16) * size), size / 2.0f, float(size) };
+        }
+        return font;
+    }
+}
+
+const HeadlessStats& GetHeadlessStats() {
+    return stats;
+}
+
+extern "C" {
+
+// window and frame
+void SetConfigFlags(unsigned int flags) {}
+void ClearWindowState(unsigned int flags) {}
+void InitWindow(int width, int height, const char* title) {
+    screenWidth = width;
+    screenHeight = height;
+    started = std::chrono::steady_clock::now();
+    TraceLog(LOG_INFO, "HEADLESS: null raylib backend, no window, GPU or audio");
+}
+void CloseWindow(void) {}
+bool WindowShouldClose(void) { return false; }
+bool IsWindowReady(void) { return true; }
+void SetWindowTitle(const char* title) {}
+void SetWindowMinSize(int width, int height) {}
+int GetScreenWidth(void) { return screenWidth; }
+int GetScreenHeight(void) { return screenHeight; }
+void SetTargetFPS(int fps) {}
+int GetFPS(void) { return 0; }
+double GetTime(void) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+void WaitTime(double seconds) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+void BeginDrawing(void) {}
+void EndDrawing(void) { stats.frames++; }
+void BeginMode2D(Camera2D camera) {}
+void EndMode2D(void) {}
+void BeginTextureMode(RenderTexture2D target) {}
+void EndTextureMode(void) {}
+void BeginShaderMode(Shader shader) {}
+void EndShaderMode(void) {}
+void BeginScissorMode(int x, int y, int width, int height) {}
+void EndScissorMode(void) {}
+void ClearBackground(Color color) {}
+
+// logging, random numbers, memory
+void SetTraceLogLevel(int level) { logLevel = level; }
+void TraceLog(int level, const char* text, ...) {
+    if (level < logLevel) return;
+    static const char* prefixes[] = { "", "TRACE: ", "DEBUG: ", "INFO: ", "WARNING: ", "ERROR: ", "FATAL: ", "" };
+    std::va_list args;
+    va_start(args, text);
+    std::fputs(prefixes[std::clamp(level, 0, 7)], stdout);
+    std::vprintf(text, args);
+    std::fputc('\n', stdout);
+    va_end(args);
+    if (level == LOG_FATAL) std::exit(EXIT_FAILURE);
+}
+void SetRandomSeed(unsigned int seed) { rng.seed(seed); }
+int GetRandomValue(int min, int max) {
+    if (min > max) std::swap(min, max);
+    return std::uniform_int_distribution<int>(min, max)(rng);
+}
+void* MemAlloc(unsigned int size) { return std::calloc(size, 1); }
+void MemFree(void* ptr) { std::free(ptr); }
+unsigned char* CompressData(const unsigned char* data, int dataSize, int* compDataSize) {
+    TraceLog(LOG_WARNING, "HEADLESS: CompressData isn't available");
+    *compDataSize = 0;
+    return nullptr;
+}
+unsigned char* DecompressData(const unsigned char* compData, int compDataSize, int* dataSize) {
+    TraceLog(LOG_WARNING, "HEADLESS: DecompressData isn't available, run without resources.pak");
+    *dataSize = 0;
+    return nullptr;
+}
+
+// files
+unsigned char* LoadFileData(const char* fileName, int* dataSize) {
+    *dataSize = 0;
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    if (!file) return nullptr;
+    int size = static_cast<int>(file.tellg());
+    unsigned char* data = static_cast<unsigned char*>(std::malloc(std::max(size, 1)));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(data), size);
+    *dataSize = size;
+    return data;
+}
+void UnloadFileData(unsigned char* data) { std::free(data); }
+const char* GetFileExtension(const char* fileName) {
+    const char* dot = std::strrchr(fileName, '.');
+    return (dot && dot != fileName) ? dot : nullptr;
+}
+
+// input, nothing is ever pressed (replays bring their own input, see InputRecorder)
+bool IsKeyPressed(int key) { return false; }
+bool IsKeyDown(int key) { return false; }
+bool IsKeyReleased(int key) { return false; }
+bool IsGamepadAvailable(int gamepad) { return false; }
+bool IsGamepadButtonPressed(int gamepad, int button) { return false; }
+bool IsGamepadButtonDown(int gamepad, int button) { return false; }
+bool IsGamepadButtonReleased(int gamepad, int button) { return false; }
+
+// images, with the right size and zeroed pixels
+Image LoadImageFromMemory(const char* fileType, const unsigned char* fileData, int dataSize) {
+    int width = 0, height = 0;
+    if (!readPngSize(fileData, static_cast<size_t>(std::max(dataSize, 0)), width, height)) {
+        TraceLog(LOG_WARNING, "HEADLESS: only PNG images are supported (%s)", fileType ? fileType : "?");
+        return Image{ 0 };
+    }
+    return blankImage(width, height);
+}
+Image LoadImage(const char* fileName) {
+    int size = 0;
+    unsigned char* data = LoadFileData(fileName, &size);
+    if (!data) return Image{ 0 };
+    Image image = LoadImageFromMemory(GetFileExtension(fileName), data, size);
+    UnloadFileData(data);
+    return image;
+}
+Image GenImageColor(int width, int height, Color color) {
+    Image image = blankImage(width, height);
+    if (image.data) std::fill_n(static_cast<Color*>(image.data), static_cast<size_t>(width) * height, color);
+    return image;
+}
+Image ImageFromImage(Image image, Rectangle rec) {
+    Image piece = blankImage(static_cast<int>(rec.width), static_cast<int>(rec.height));
+    if (!piece.data || !image.data) return piece;
+    // the same copy raylib makes, the pixels are all zero here but the sizes have to add up
+    for (int y = 0; y < piece.height; ++y) {
+        int srcY = static_cast<int>(rec.y) + y;
+        if (srcY < 0 || srcY >= image.height) continue;
+        int srcX = std::clamp(static_cast<int>(rec.x), 0, image.width);
+        int count = std::min(piece.width, image.width - srcX);
+        std::memcpy(static_cast<Color*>(piece.data) + static_cast<size_t>(y) * piece.width,
+            static_cast<const Color*>(image.data) + static_cast<size_t>(srcY) * image.width + srcX, count * sizeof(Color));
+    }
+    return piece;
+}
+void UnloadImage(Image image) { std::free(image.data); }
+Color* LoadImageColors(Image image) {
+    size_t count = static_cast<size_t>(image.width) * image.height;
+    Color* colors = static_cast<Color*>(std::calloc(std::max<size_t>(count, 1), sizeof(Color)));
+    if (image.data) std::memcpy(colors, image.data, count * sizeof(Color));
+    return colors;
+}
+void UnloadImageColors(Color* colors) { std::free(colors); }
+
+// textures, just an id and a size
+Texture2D LoadTexture(const char* fileName) {
+    Image image = LoadImage(fileName);
+    if (!image.data) return Texture2D{ 0 };
+    Texture2D texture = stubTexture(image.width, image.height);
+    UnloadImage(image);
+    return texture;
+}
+Texture2D LoadTextureFromImage(Image image) {
+    if (!image.data) return Texture2D{ 0 };
+    return stubTexture(image.width, image.height);
+}
+void UnloadTexture(Texture2D texture) {
+    if (texture.id != 0) stats.texturesUnloaded++;
+}
+RenderTexture2D LoadRenderTexture(int width, int height) {
+    RenderTexture2D target = { 0 };
+    target.id = nextId++;
+    target.texture = stubTexture(width, height);
+    return target;
+}
+void UnloadRenderTexture(RenderTexture2D target) { UnloadTexture(target.texture); }
+void SetTextureFilter(Texture2D texture, int filter) {}
+
+// drawing, counted
+void DrawTexture(Texture2D texture, int posX, int posY, Color tint) { stats.drawCalls++; }
+void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) { stats.drawCalls++; }
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) { stats.drawCalls++; }
+void DrawRectangle(int posX, int posY, int width, int height, Color color) { stats.drawCalls++; }
+void DrawRectangleRec(Rectangle rec, Color color) { stats.drawCalls++; }
+void DrawRectangleLines(int posX, int posY, int width, int height, Color color) { stats.drawCalls++; }
+void DrawRectangleRounded(Rectangle rec, float roundness, int segments, Color color) { stats.drawCalls++; }
+void DrawCircle(int centerX, int centerY, float radius, Color color) { stats.drawCalls++; }
+void DrawText(const char* text, int posX, int posY, int fontSize, Color color) { stats.drawCalls++; }
+void DrawTextEx(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color tint) { stats.drawCalls++; }
+
+// rlgl, the batched glyphs of TextLayout
+bool rlCheckRenderBatchLimit(int vCount) { return false; }
+void rlSetTexture(unsigned int id) {}
+void rlBegin(int mode) { stats.drawCalls++; }
+void rlEnd(void) {}
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a) {}
+void rlNormal3f(float x, float y, float z) {}
+void rlTexCoord2f(float x, float y) {}
+void rlVertex2f(float x, float y) {}
+
+// text
+Font GetFontDefault(void) {
+    static Font font = stubFont(10);
+    return font;
+}
+Font LoadFontEx(const char* fileName, int fontSize, int* codepoints, int codepointCount) { return stubFont(fontSize); }
+Font LoadFontFromMemory(const char* fileType, const unsigned char* fileData, int dataSize, int fontSize, int* codepoints, int codepointCount) {
+    return stubFont(fontSize);
+}
+void UnloadFont(Font font) {
+    UnloadTexture(font.texture);
+    std::free(font.recs);
+    std::free(font.glyphs);
+}
+int GetGlyphIndex(Font font, int codepoint) {
+    for (int i = 0; i < font.glyphCount; ++i) {
+        if (font.glyphs[i].value == codepoint) return i;
+    }
+    return std::min('?' - 32, font.glyphCount - 1); // the fallback raylib uses
+}
+Vector2 MeasureTextEx(Font font, const char* text, float fontSize, float spacing) {
+    // widest line and the number of lines, like raylib
+    int lines = 1;
+    int longest = 0;
+    int length = 0;
+    for (const char* c = text; *c; ++c) {
+        if (*c == '\n') {
+            lines++;
+            length = 0;
+            continue;
+        }
+        longest = std::max(longest, ++length);
+    }
+    float width = longest * (fontSize / 2.0f + spacing) - (longest > 0 ? spacing : 0.0f);
+    return Vector2{ width, lines * fontSize + (lines - 1) * fontSize / 2.0f };
+}
+int MeasureText(const char* text, int fontSize) {
+    if (!text) return 0;
+    int spacing = std::max(fontSize / 10, 1);
+    return static_cast<int>(MeasureTextEx(GetFontDefault(), text, float(fontSize), float(spacing)).x);
+}
+
+// shaders
+Shader LoadShader(const char* vsFileName, const char* fsFileName) { return Shader{ nextId++, nullptr }; }
+Shader LoadShaderFromMemory(const char* vsCode, const char* fsCode) { return Shader{ nextId++, nullptr }; }
+void UnloadShader(Shader shader) {}
+int GetShaderLocation(Shader shader, const char* uniformName) { return -1; }
+void SetShaderValue(Shader shader, int locIndex, const void* value, int uniformType) {}
+void SetShaderValueV(Shader shader, int locIndex, const void* value, int uniformType, int count) {}
+
+// audio, nothing is loaded or played
+void InitAudioDevice(void) {}
+void CloseAudioDevice(void) {}
+Wave LoadWave(const char* fileName) { return Wave{ 0 }; }
+Wave LoadWaveFromMemory(const char* fileType, const unsigned char* fileData, int dataSize) { return Wave{ 0 }; }
+void UnloadWave(Wave wave) {}
+Sound LoadSound(const char* fileName) { return Sound{}; }
+Sound LoadSoundFromWave(Wave wave) { return Sound{}; }
+void UnloadSound(Sound sound) {}
+void PlaySound(Sound sound) {}
+void SetSoundPitch(Sound sound, float pitch) {}
+void SetSoundVolume(Sound sound, float volume) {}
+Music LoadMusicStream(const char* fileName) { return Music{}; }
+Music LoadMusicStreamFromMemory(const char* fileType, const unsigned char* data, int dataSize) { return Music{}; }
+void UnloadMusicStream(Music music) {}
+void PlayMusicStream(Music music) {}
+void StopMusicStream(Music music) {}
+void UpdateMusicStream(Music music) {}
+void SetMusicVolume(Music music, float volume) {}
+
+// math helpers that live in the raylib library (raymath is header only)
+bool CheckCollisionRecs(Rectangle rec1, Rectangle rec2) {
+    return (rec1.x < rec2.x + rec2.width) && (rec1.x + rec1.width > rec2.x) &&
+        (rec1.y < rec2.y + rec2.height) && (rec1.y + rec1.height > rec2.y);
+}
+Color Fade(Color color, float alpha) {
+    color.a = static_cast<unsigned char>(255.0f * std::clamp(alpha, 0.0f, 1.0f));
+    return color;
+}
+Vector2 GetWorldToScreen2D(Vector2 position, Camera2D camera) {
+    // the game never rotates the camera
+    return Vector2{
+        (position.x - camera.target.x) * camera.zoom + camera.offset.x,
+        (position.y - camera.target.y) * camera.zoom + camera.offset.y
+    };
+}
+
+}
+#endif
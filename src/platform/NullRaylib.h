@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+/*
+Null raylib backend for the headless build (CMake option GAME_HEADLESS)
+NullRaylib.cpp implements the part of the raylib API the game uses without a window, GPU or audio
+device, so the whole simulation runs on a machine without a display (CI, benchmarks)
+
+- images keep their size (read from the PNG header) and get zeroed pixels, so the CPU side code
+  (spritesheet slicing, tile colours, the mini map atlas) still works
+- textures and render textures are ids with a size, draws are counted but go nowhere
+- sounds, music and fonts are stubs, the input is never pressed
+- GetTime is the real time since InitWindow, the headless Game uses a fixed time step (see Game::run)
+- CompressData/DecompressData aren't there, a resources.pak with compressed entries can't be read
+  (the loose files in ./resources are used when there's no archive)
+*/
+
+struct HeadlessStats {
+    uint64_t frames = 0; // EndDrawing calls
+    uint64_t drawCalls = 0; // textures, shapes and text that would have been drawn
+    uint64_t texturesLoaded = 0;
+    uint64_t texturesUnloaded = 0;
+};
+
+const HeadlessStats& GetHeadlessStats();
@@ -6,13 +6,13 @@
 
 
 void GameOver::startup() {
-    game.playSound("gameover");
+    game.playSound("gameover"_id);
 
     Sprite* player = game.getPlayer();
     if (player)
         player->moveTo(game.gameScreenWidth / 2.0f - ((player->lastDirection == LEFT) ? 16 : 0), game.gameScreenHeight / 2.0f);
 
-    game.eventManager.pushDelayedEvent("advanceGameOver", 2.0f, nullptr, [this]() {
+    game.eventManager.pushDelayedEvent("advanceGameOver"_id, 2.0f, nullptr, [this]() {
         showText1 = true;
         music = &const_cast<Music&>(game.loader.getMusic("gameover"));
         PlayMusicStream(*music);
@@ -21,7 +21,7 @@ void GameOver::startup() {
         if (player)
             player->rotationAngle = 90.0f * ((player->lastDirection == LEFT) ? 1 : -1);
     });
-    game.eventManager.pushDelayedEvent("advanceGameOver2", 4.0f, nullptr, [this]() {
+    game.eventManager.pushDelayedEvent("advanceGameOver2"_id, 4.0f, nullptr, [this]() {
         showText2 = true;
      });
 }
@@ -41,7 +41,9 @@ void GameOver::draw() {
     Sprite* player = game.getPlayer();
     if (player) {
         player->iFrameTimer = 0.0f;
-        player->draw();
+        playerSnapshot.clear();
+        player->draw(playerSnapshot);
+        playerSnapshot.draw();
     }
 
     if (showText1) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Scene.h"
+#include "RenderSnapshot.h"
 #include <iostream>
 #include <string>
 
@@ -13,4 +14,5 @@ public:
 private:
     bool showText1 = false;
     bool showText2 = false;
+    RenderSnapshot playerSnapshot;
 };
@@ -9,57 +9,81 @@
 
 HUD::HUD(Game& game, const std::string& name) : Scene(game, name), heartImages{} {
     // event listeners
-    game.eventManager.addListener("hideHUD", [this](std::any) {
+    subscriptions.push_back(game.eventManager.listen("hideHUD", [this](std::any) {
         // start hiding the HUD
         if (visible && !retracting) retracting = true;
-        });
+        }));
 
-    game.eventManager.addListener("showHUD", [this](std::any) {
+    subscriptions.push_back(game.eventManager.listen("showHUD", [this](std::any) {
         // sliding in the HUD
         if (!visible && retracting) {
             retracting = false;
             visible = true;
         }
-        });
+        }));
 
-    game.eventManager.addListener("weaponSet", [this](std::any data) {
+    subscriptions.push_back(game.eventManager.listen("weaponSet", [this](std::any data) {
         std::string weapon = std::any_cast<std::string>(data);
         equippedWeapon = std::any_cast<std::string>(data);
         TraceLog(LOG_INFO, "player equipped the %s", equippedWeapon.c_str());
-        });
+        dirty = true;
+        }));
 
-    game.eventManager.addListener("itemAdded", [this](std::any data) {
+    subscriptions.push_back(game.eventManager.listen("itemAdded", [this](std::any data) {
         collectedItem = std::any_cast<std::string>(data);
         showCollectedItem = true;
         collectedItemTimer = 0.0f;
-        });
+        // the item was already added, so the quantity is up to date
+        collectedItemText = "x" + std::to_string(this->game.inventory.getItemQuantity(collectedItem));
+        }));
 
-    game.eventManager.addListener("showCoinAmount", [this](std::any data) {
+    subscriptions.push_back(game.eventManager.listen("showCoinAmount", [this](std::any data) {
         showCoinAmount = true;
-        });
+        dirty = true;
+        }));
 
-    game.eventManager.addListener("hideCoinAmount", [this](std::any data) {
+    subscriptions.push_back(game.eventManager.listen("hideCoinAmount", [this](std::any data) {
         showCoinAmount = false;
-        });
+        dirty = true;
+        }));
 
-    game.eventManager.addListener("showHelpText", [this](std::any data) {
+    subscriptions.push_back(game.eventManager.listen("roomChanged", [this](std::any data) {
+        dirty = true;
+        }));
+
+    subscriptions.push_back(game.eventManager.listen<ShowHelpText>([this](const ShowHelpText& event) {
         if (showHelpText) return;
-        auto [label, key, index] = std::any_cast<std::tuple<std::string, char, int>>(data);
-        helpText = label;
-        helpTextKey = key;
-        helpTextButtonIndex = index;
+        helpText = event.label;
+        helpTextKey = event.key;
+        helpTextButtonIndex = event.buttonIndex;
         showHelpText = true;
-        });
+        dirty = true;
+        }));
 
-    game.eventManager.addListener("hideHelpText", [this](std::any data) {
+    subscriptions.push_back(game.eventManager.listen<HideHelpText>([this](const HideHelpText&) {
         showHelpText = false;
-        });
+        dirty = true;
+        }));
 }
 
 void HUD::startup() {
     width = float(game.gameScreenWidth);
     heartImages = game.loader.getTextures("hearts");
     height = game.getSetting("HudHeight");
+    cache = LoadRenderTexture(game.gameScreenWidth, game.gameScreenHeight);
+    dirty = true;
+}
+
+HUD::Snapshot HUD::takeSnapshot() const {
+    Snapshot s;
+    if (Sprite* player = game.getPlayer()) {
+        s.health = player->health;
+        s.maxHealth = player->maxHealth;
+    }
+    if (game.currentDungeon) s.roomIndex = game.currentDungeon->getCurrentRoomIndex();
+    if (showCoinAmount) s.coins = game.inventory.getItemQuantity("coin");
+    if (showHelpText) s.gamepad = WasGamepadUsedLast();
+    return s;
 }
 
 void HUD::update(float deltaTime) {
@@ -76,15 +100,32 @@ void HUD::update(float deltaTime) {
     if (collectedItemTimer >= 2.0f) {
         showCollectedItem = false;
     }
+
+    // health etc. change without events, so compare them here
+    Snapshot current = takeSnapshot();
+    if (current != snapshot) {
+        snapshot = current;
+        dirty = true;
+    }
+    rebuildTimer += deltaTime;
+    if (rebuildTimer >= 1.0f) {
+        rebuildsPerSecond = rebuildCount;
+        rebuildCount = 0;
+        rebuildTimer -= 1.0f;
+    }
 }
 
-void HUD::draw() {
-    if (!visible) return;
+void HUD::rebuildCache() {
+    dirty = false;
+    rebuildCount++;
+    if (cache.id == 0) return;
 
-    DrawRectangle(int(x), int(y), int(width), int(height), DARKBURGUNDY);
+    BeginTextureMode(cache);
+    ClearBackground(BLANK);
+    // the bar is drawn at y = 0, draw() moves it while sliding
+    DrawRectangle(0, 0, int(width), int(height), DARKBURGUNDY);
 
     // draw player health as hearts
-    // TODO draw the hearts ON the reactangle as a texture?
     Sprite* player = game.getPlayer();
     if (player) {
         int spacing = heartImages[0].width + 2;
@@ -92,13 +133,13 @@ void HUD::draw() {
         int hp = player->health;
         for (int i = 0; i < totalHearts; i++) {
             int imgIndex = (hp >= 2) ? 2 : (hp == 1 ? 1 : 0);
-            DrawTexture(heartImages[imgIndex], 8 + spacing * i, int(y) + 8, WHITE);
+            DrawTexture(heartImages[imgIndex], 8 + spacing * i, 8, WHITE);
             hp -= 2;
         }
     }
     // draw the currently equipped weapon on a background texture frame
     int weaponX = int(x) + int(game.gameScreenWidth * 2 / 3);
-    int weaponY = int(y) + 16;
+    int weaponY = 16;
     const auto& frameTex = game.loader.getTextures("inventory_item_frame")[0];
     DrawTexture(frameTex, weaponX - frameTex.width / 2, weaponY - frameTex.height / 2, WHITE);
     auto& textures = game.loader.getTextures(equippedWeapon);
@@ -114,7 +155,7 @@ void HUD::draw() {
     const int cellWidth = 6;
     const int cellHeight = 4;
     const int mapX = static_cast<int>(game.gameScreenWidth) - static_cast<int>(cols) * (cellWidth + spacing) - 6;
-    const int mapY = static_cast<int>(y) + 6;
+    const int mapY = 6;
     for (size_t i = 0; i < cols * rows; ++i) {
         int col = static_cast<int>(i % cols);
         int row = static_cast<int>(i / cols);
@@ -127,29 +168,14 @@ void HUD::draw() {
         DrawRectangle(cellX, cellY, cellWidth, cellHeight, color);
     }
 
-    // whenever a collectable item is picked up
-    // TODO this break when it's not a coin
-    if (showCollectedItem) {
-        auto& itemData = game.inventory.getItemData();
-        auto& invItems = game.inventory.getItems();
-        const ItemData& data = itemData.at(collectedItem);
-        const Texture2D& itemTex = game.loader.getTextures(data.textureKey)[0];
-        int itemX = weaponX + 24;
-        DrawTexture(itemTex, itemX, collectedItemY, WHITE);
-        ItemType type = data.type;
-        uint32_t qty = invItems[type].at(collectedItem).second;
-        std::string qtyText = "x" + std::to_string(qty);
-        DrawText(qtyText.c_str(), itemX + 8, collectedItemY, 10, LIGHTGRAY);
-    }
     if (showCoinAmount) {
-        // TODO get rid of repeated code
         const auto& coinTex = game.loader.getTextures("itemDropCoin")[0];
         int coinX = weaponX + 36;
         DrawTexture(coinTex, coinX, 8, WHITE);
-        uint32_t qty = game.inventory.getItemQuantity("coin");
-        std::string qtyText = "x" + std::to_string(qty);
+        std::string qtyText = "x" + std::to_string(snapshot.coins);
         DrawText(qtyText.c_str(), coinX + 8, 8, 10, LIGHTGRAY);
     }
+    helpTextRect = { 0, 0, 0, 0 };
     if (showHelpText) {
         const char* ht = helpText.c_str();
         int fontSize = 10;
@@ -157,26 +183,66 @@ void HUD::draw() {
         int txtPosX = 12;
         int txtPosY = static_cast<int>(game.gameScreenHeight) - 2 * margin - fontSize;
         int txtH = fontSize + 2 * margin;
-        if (WasGamepadUsedLast()) {
+        if (snapshot.gamepad) {
             // show the respective button texture
             const auto& buttonTex = game.loader.getTextures("xbox_buttons")[helpTextButtonIndex];
             int txtW = MeasureText(ht, fontSize) + 2 * margin + buttonTex.width;
             DrawRectangle(txtPosX, txtPosY, txtW, txtH, BLACK);
             DrawTexture(buttonTex, txtPosX, txtPosY, WHITE);
+            helpTextRect = { (float)txtPosX, (float)txtPosY, (float)txtW, (float)txtH };
             txtPosX += buttonTex.width;
             DrawText(ht, txtPosX + margin, txtPosY + margin, fontSize, LIGHTGRAY);
         }
         else {
             // show a text with the respective key
-            std::string displayText = helpText;
-            displayText = "[" + std::string(1, helpTextKey) + "]: " + helpText;
+            std::string displayText = "[" + std::string(1, helpTextKey) + "]: " + helpText;
             int txtW = MeasureText(displayText.c_str(), fontSize) + 2 * margin;
             DrawRectangle(txtPosX, txtPosY, txtW, txtH, BLACK);
             DrawText(displayText.c_str(), txtPosX + margin, txtPosY + margin, fontSize, LIGHTGRAY);
+            helpTextRect = { (float)txtPosX, (float)txtPosY, (float)txtW, (float)txtH };
         }
     }
+    EndTextureMode();
+}
+
+bool HUD::capture() {
+    // rebuilding has to happen here and not in draw(), since draw() is already inside the game's texture mode
+    // (and not in update() either, that can run on the simulation thread)
+    if (dirty) rebuildCache();
+
+    RenderSnapshot& out = frameSnapshot;
+    out.clear();
+    if (!visible || cache.id == 0) return true;
+
+    // render textures are upside down, so the source rects are flipped
+    float texH = static_cast<float>(cache.texture.height);
+    out.drawTextureRec(cache.texture, { 0, texH - height, width, -height }, { x, y }, WHITE);
+    if (showHelpText && helpTextRect.width > 0) {
+        const Rectangle& r = helpTextRect;
+        out.drawTextureRec(cache.texture, { r.x, texH - r.y - r.height, r.width, -r.height }, { r.x, r.y }, WHITE);
+    }
+
+    // whenever a collectable item is picked up
+    // TODO this break when it's not a coin
+    if (showCollectedItem) {
+        const ItemData& data = game.inventory.getItemData().at(collectedItem);
+        const Texture2D& itemTex = game.loader.getTextures(data.textureKey)[0];
+        int itemX = int(x) + int(game.gameScreenWidth * 2 / 3) + 24;
+        out.drawTexture(itemTex, itemX, collectedItemY, WHITE);
+        out.drawText(collectedItemText, itemX + 8, collectedItemY, 10, LIGHTGRAY);
+    }
+
+    if (game.debug) {
+        out.drawText("HUD rebuilds/s: " + std::to_string(rebuildsPerSecond), 4, int(y + height) + 2, 10, LIGHTGRAY);
+    }
+    return true;
+}
+
+void HUD::draw() {
+    frameSnapshot.draw();
 }
 
 void HUD::end() {
-    // TODO
+    if (cache.id != 0) UnloadRenderTexture(cache);
+    cache = { 0 };
 }
\ No newline at end of file
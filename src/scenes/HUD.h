@@ -3,6 +3,7 @@
 #include "Scene.h"
 #include <iostream>
 #include "raylib.h"
+#include "RenderSnapshot.h"
 #include <vector>
 
 class HUD : public Scene {
@@ -12,6 +13,7 @@ public:
     void update(float deltaTime) override;
     void draw() override;
     void end() override;
+    bool capture() override;
 
 private:
     std::vector<Texture2D> heartImages;
@@ -28,6 +30,7 @@ private:
     int collectedItemY = 0;
     float collectedItemTimer = 0.0f;
     std::string collectedItem;
+    std::string collectedItemText; // quantity text, set when the item is collected
     // show the amount of coins for shopping
     bool showCoinAmount = false;
     // show a help text for the controls
@@ -35,4 +38,31 @@ private:
     std::string helpText;
     char helpTextKey = '\0';
     int helpTextButtonIndex = 0;
-};
\ No newline at end of file
+
+    // the static parts (bar, hearts, weapon, mini map, coins, help text) are drawn into a texture
+    // and only redrawn when something changes, the collected item animation is drawn on top
+    // the bar is rendered at the top of the texture, the help text at its real position (bottom of the screen)
+    RenderTexture2D cache = { 0 };
+    bool dirty = true;
+    void rebuildCache();
+    // state that changes without an event, compared every frame
+    struct Snapshot {
+        uint32_t health = 0;
+        uint32_t maxHealth = 0;
+        size_t roomIndex = 0;
+        uint32_t coins = 0;
+        bool gamepad = false;
+        bool operator!=(const Snapshot& other) const {
+            return health != other.health || maxHealth != other.maxHealth || roomIndex != other.roomIndex ||
+                coins != other.coins || gamepad != other.gamepad;
+        }
+    };
+    Snapshot snapshot;
+    Snapshot takeSnapshot() const;
+    Rectangle helpTextRect = { 0, 0, 0, 0 }; // area of the help text in the cache
+    RenderSnapshot frameSnapshot;
+    // debug info
+    int rebuildCount = 0;
+    int rebuildsPerSecond = 0;
+    float rebuildTimer = 0.0f;
+};
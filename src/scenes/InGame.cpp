@@ -4,6 +4,7 @@
 #include "Controls.h"
 #include "Events.h"
 #include "Utils.h"
+#include "Profiler.h"
 
 void InGame::startup() {
     // create the player sprite
@@ -25,9 +26,9 @@ void InGame::startup() {
         player->maxHealth = saveData->playerMaxHealth;
         player->health = std::max(static_cast<uint32_t>(6), saveData->playerHealth);
         // add the items once the scenes have fully started
-        game.eventManager.pushDelayedEvent("itemFromSaveData", 0.1f, nullptr, [this, saveData]() {
+        game.eventManager.pushDelayedEvent("itemFromSaveData"_id, 0.1f, nullptr, [this, saveData]() {
             for (const auto& itemPair : saveData->items) {
-                this->game.eventManager.pushEvent("addItem", std::make_any<std::pair<std::string, uint32_t>>(itemPair.first, itemPair.second));
+                this->game.eventManager.pushEvent("addItem"_id, std::make_any<std::pair<std::string, uint32_t>>(itemPair.first, itemPair.second));
             }
             });
 
@@ -52,8 +53,9 @@ void InGame::startup() {
 
     // event listeners for the InGame scene
 
-    game.eventManager.addListener("moveCamera", [&](std::any data) {
-        auto [targetX, targetY] = std::any_cast<std::pair<float, float>>(data);
+    subscriptions.push_back(game.eventManager.listen<MoveCamera>([this](const MoveCamera& event) {
+        float targetX = event.x;
+        float targetY = event.y;
         // clamp to world boundaries
         // TODO: make this a function
         // TODO: take into account whether the HUD is visible or not
@@ -67,7 +69,7 @@ void InGame::startup() {
         targetX = Clamp(targetX, minX, maxX);
         targetY = Clamp(targetY, minY, maxY);
         camera.target = Vector2{ targetX, targetY };
-        });
+        }));
 
     /*game.eventManager.addListener("teleport", [this](std::any data) {
         const auto& teleportData = std::any_cast<const TeleportEvent&>(data);
@@ -75,12 +77,12 @@ void InGame::startup() {
         player->moveTo(teleportData.targetPos.x * tileSize, teleportData.targetPos.y * tileSize);
         });*/
 
-    game.eventManager.addListener("setMusicVolume", [this](std::any data) {
-            if (music) SetMusicVolume(*music, std::any_cast<float>(data));
-        });
+    subscriptions.push_back(game.eventManager.listen<MusicVolume>([this](const MusicVolume& event) {
+            if (music) SetMusicVolume(*music, event.volume);
+        }));
 
     // event listener that changes the current weapon key
-    game.eventManager.addListener("weaponSet", [this](const std::any& data) {
+    subscriptions.push_back(game.eventManager.listen("weaponSet", [this](const std::any& data) {
         if (data.has_value()) {
             currentWeapon = std::any_cast<std::string>(data);
         }
@@ -88,25 +90,22 @@ void InGame::startup() {
             // event allows for removal of the weapon
             currentWeapon = std::nullopt;
         }
-        });
+        }));
 
-    game.eventManager.addListener("screenShake", [this](std::any value) {
-        if (value.has_value() && value.type() == typeid(std::tuple<float, float, float>)) {
-            auto [duration, xMag, yMag] = std::any_cast<std::tuple<float, float, float>>(value);
-            cameraShake.start(duration, xMag, yMag);
-        }
-        });
+    subscriptions.push_back(game.eventManager.listen<ScreenShake>([this](const ScreenShake& event) {
+        cameraShake.start(event.duration, event.xMagnitude, event.yMagnitude);
+        }));
 
     // ##### Events that progress the game ####
     // // TODO: comment out during debugging
     setupConditionalEvents(*this);
 
     // TODO: adding some items for testing
-    game.eventManager.pushDelayedEvent("testItemsForStart", 0.1f, nullptr, [this]() {
+    game.eventManager.pushDelayedEvent("testItemsForStart"_id, 0.1f, nullptr, [this]() {
         // give the player the sword for starters
-        //game.eventManager.pushEvent("addItem", std::make_any<std::pair<std::string, uint32_t>>("heart_1up", 99));
-        //game.eventManager.pushEvent("addItem", std::make_any<std::pair<std::string, uint32_t>>("weapon_hammer", 1));
-        //game.eventManager.pushEvent("weaponSet", std::string("weapon_hammer"));
+        //game.eventManager.pushEvent("addItem"_id, std::make_any<std::pair<std::string, uint32_t>>("heart_1up", 99));
+        //game.eventManager.pushEvent("addItem"_id, std::make_any<std::pair<std::string, uint32_t>>("weapon_hammer", 1));
+        //game.eventManager.pushEvent("weaponSet"_id, std::string("weapon_hammer"));
         });
 }
 
@@ -118,359 +117,304 @@ Sprite* InGame::getSprite(const std::string& name) {
     return nullptr;
 }
 
-void InGame::addBehaviorsToSprite(std::shared_ptr<Sprite> sprite, const std::vector<std::string>& behaviors, const nlohmann::json& behaviorData) {
-    for (const auto& key : behaviors) {
-        if (key == "RandomWalk") {
+void InGame::addBehaviorsToSprite(std::shared_ptr<Sprite> sprite, const SpriteArchetype& archetype) {
+    const BehaviorParams& params = archetype.behaviorParams;
+    for (BehaviorKind kind : archetype.behaviors) {
+        switch (kind) {
+        case BehaviorKind::RandomWalk:
             sprite->addBehavior(std::make_unique<RandomWalkBehavior>(sprite));
-        }
-        else if (key == "Watch") {
-            std::string targetName = behaviorData.value("watchTarget", "");
-            if (spriteMap.find(targetName) != spriteMap.end()) {
-                sprite->addBehavior(std::make_unique<WatchBehavior>(sprite, spriteMap[targetName]));
+            break;
+        case BehaviorKind::Watch:
+            if (spriteMap.find(params.watchTarget) != spriteMap.end()) {
+                sprite->addBehavior(std::make_unique<WatchBehavior>(sprite, spriteMap[params.watchTarget]));
             }
             else {
-                TraceLog(LOG_WARNING, "Target \"%s\" not found in spriteMap. Skipping WatchBehavior for %s.", targetName.c_str(), sprite->spriteName.c_str());
+                TraceLog(LOG_WARNING, "Target \"%s\" not found in spriteMap. Skipping WatchBehavior for %s.", params.watchTarget.c_str(), sprite->spriteName.c_str());
             }
-        }
-        else if (key == "Chase") {
+            break;
+        case BehaviorKind::Chase:
             // TODO get distance values from file
-            std::string targetName = behaviorData.value("chaseTarget", "");
-            if (spriteMap.find(targetName) != spriteMap.end()) {
-                sprite->addBehavior(std::make_unique<ChaseBehavior>(game, sprite, spriteMap[targetName], 48.0f, 2.0f, 64.0f));
+            if (spriteMap.find(params.chaseTarget) != spriteMap.end()) {
+                sprite->addBehavior(std::make_unique<ChaseBehavior>(game, sprite, spriteMap[params.chaseTarget], 48.0f, 2.0f, 64.0f));
             }
             else {
-                TraceLog(LOG_WARNING, "Target \"%s\" not found in spriteMap. Skipping ChaseBehavior for %s.", targetName.c_str(), sprite->spriteName.c_str());
+                TraceLog(LOG_WARNING, "Target \"%s\" not found in spriteMap. Skipping ChaseBehavior for %s.", params.chaseTarget.c_str(), sprite->spriteName.c_str());
             }
-        }
-        else if (key == "Dialogue") {
-            std::string textKey = behaviorData.value("dialogue", "");
-            if (textKey.length()) {
+            break;
+        case BehaviorKind::Dialogue:
+            if (params.dialogue.length()) {
+                std::string textKey = params.dialogue;
                 std::vector<std::string> texts = game.loader.getText(textKey);
-                std::string voice = behaviorData.value("voice", "tone");
-                sprite->addBehavior(std::make_unique<DialogueBehavior>(game, sprite, player, texts, voice));
+                sprite->addBehavior(std::make_unique<DialogueBehavior>(game, sprite, player, texts, params.voice));
             }
-        }
-        else if (key == "Shoot") {
-            std::string targetName = behaviorData.value("shootTarget", "");
+            break;
+        case BehaviorKind::Shoot: {
             shootingConfig conf;
             // TODO get these values from Tiled data
             conf.projectileKey = "fireball";
             conf.speed = 20.0f;
-            conf.amount = 10;
-            conf.velocityVariance = { 1.0f, 1.0f };
-            conf.spawnInterval = 0.1f;
-            conf.lifetimeVariance = 0.2f;
-            sprite->addBehavior(std::make_unique<ShootBehavior>(game, sprite, spriteMap[targetName], conf));
+            // the trail's look is defined by the "projectileTrail" preset in particles.json
+            sprite->addBehavior(std::make_unique<ShootBehavior>(game, sprite, spriteMap[params.shootTarget], conf));
+            break;
         }
-        else if (key == "Emitter") {
-            // TODO: make the emitter and particle more customizable
-            std::unique_ptr<Emitter> emitter = std::make_unique<Emitter>(20);
-            emitter->spawnInterval = 0.2f;
-            emitter->lifetimeVariance = 0.05f;
-            emitter->velocityVariance = { 20.0f, 20.0f };
-
-            std::unique_ptr<Particle> proto = std::make_unique<Particle>();
-            proto->velocity = { 0.0f, 0.0f };
-            proto->lifetime = 1.6f;
-            proto->startAlpha = 0.5f;
-            proto->endSize = 0.2f;
-            proto->setAnimationFrames(game.loader.getTextures(behaviorData.value("particle", "")));
-
-            emitter->prototype = *proto;
-            sprite->addBehavior(std::make_unique<EmitterBehavior>(game, sprite, std::move(emitter), std::move(proto)));
+        case BehaviorKind::Emitter:
+            // preset from particles.json, "particle" optionally replaces its texture
+            sprite->addBehavior(std::make_unique<EmitterBehavior>(game, sprite, params.emitterPreset, params.particle));
+            break;
         }
     }
 }
 
-void InGame::loadTilemap() {
-    // TODO: this gets big, put this somewhere else
-    tileMap = game.currentDungeon->loadCurrentTileMap();
-    // remove static and dynamic (non-persistent) sprites
-    game.walls.clear();
-    game.clearSprites();
-    // check if there even is a valid tile map
-    if (!tileMap)
-        return;
-    // the room state controls how objects are spawned
-    // states start with 1
+std::shared_ptr<Sprite> InGame::spawnObject(const SpawnEntry& entry) {
+    // creates the wall or sprite for a map object, returns the sprite (nullptr for walls and skipped objects)
     uint8_t currentState = game.currentDungeon->getCurrentRoomState();
+    if (!entry.existsIn(currentState))
+        // object does not spawn in the currentState
+        return nullptr;
+    if (entry.kind == SpawnKind::Wall) {
+        game.walls.push_back(std::make_unique<Rectangle>(entry.bounds));
+        return nullptr;
+    }
     auto& objectStates = game.currentDungeon->getCurrentRoomObjectStates();
-    const auto& spriteData = game.loader.getSpriteData();
-    size_t spritesLen = tileMap->getObjects().size();
-    game.sprites.reserve(spritesLen);
-    // build static collision objects from map data
-    for (auto& obj : tileMap->getObjects()) {
-        if (!obj.visible) 
-            continue;
-        // first, check if the object should exist in this room state
-        uint8_t objectState = obj.properties.value("roomState", 0); // objects spawn in every state by default
-        TraceLog(LOG_INFO, "creating %s - <%s>, id: %d, objectState: %d",
-            obj.type.c_str(), 
-            obj.name.empty() ? "unnamed" : obj.name.c_str(), 
-            obj.id, objectState
-        );
-        if (objectState != 0 && (objectState & currentState) == 0)
-            // object does not spawn in the currentState
-            continue;
-        // object type-specific code
-        if (obj.type == "wall") {
-            game.walls.push_back(std::make_unique<Rectangle>(
-                Rectangle{ obj.x, obj.y, obj.width, obj.height })
-            );
+    auto savedState = objectStates.find(entry.id);
+    if (savedState != objectStates.end() && savedState->second.isDefeated) {
+        // this sprite is dead, skip it
+        return nullptr;
+    }
+    const TileObject& obj = tileMap->objects[entry.object];
+    const SpriteArchetype* archetype = &game.loader.getArchetype(entry.archetype);
+    const std::string& spriteName = archetype->name;
+    // get the hitbox dimensions for the constructor
+    // if not specified in the JSON data, it takes the dimensions from the Tiled object data
+    Vector2 hitbox = archetype->hasHitbox ? archetype->hitbox : Vector2{ entry.bounds.width, entry.bounds.height };
+    // instanciate the sprite
+    auto sprite = std::make_shared<Sprite>(
+        game, entry.bounds.x, entry.bounds.y, hitbox.x, hitbox.y, obj.name
+    );
+    // generic attributes
+    // from JSON data
+    sprite->health = archetype->health;
+    sprite->damage = archetype->damage;
+    sprite->speed = archetype->speed;
+    sprite->knockback = archetype->knockback;
+    sprite->hitboxOffset = archetype->hitboxOffset;
+    //sprite->emitsLight = true; // TODO
+    // attributes from Tiled data (instance-specific, overwrite JSON data)
+    sprite->spriteName = spriteName;
+    const SpawnOverrides& overrides = entry.overrides;
+    if (overrides.set & SpawnOverrides::SPEED) sprite->speed = overrides.speed;
+    if (overrides.set & SpawnOverrides::DAMAGE) sprite->damage = overrides.damage;
+    if (overrides.set & SpawnOverrides::KNOCKBACK) sprite->knockback = overrides.knockback;
+    sprite->tileMapID = entry.id;
+    sprite->drawLayer = overrides.drawLayer;
+    if (overrides.set & SpawnOverrides::HURTBOX) {
+        sprite->setHurtbox(-1.0f, -1.0f, overrides.hurtbox.x, overrides.hurtbox.y);
+    }
+    if (archetype->hasCollides) {
+        sprite->isColliding = archetype->collides;
+    }
+    // TODO: is this still needed?
+    //if (obj.properties.contains("dialogue")) {
+    //    data["behaviorData"]["dialogue"] = obj.properties["dialogue"].get<std::string>();
+    //}
+
+    // specific sprite attributes
+    // TODO: for persistent sprites, check if they exist in the spriteMap
+    if (entry.kind == SpawnKind::Teleport) {
+        sprite->isColliding = false;
+        sprite->visible = false;
+        std::string targetMap = obj.properties.value("targetMap", "");
+        float targetX = obj.properties.value("targetPosX", 0.0f);
+        float targetY = obj.properties.value("targetPosY", 0.0f);
+        sprite->addBehavior(std::make_unique<TeleportBehavior>(
+            game, sprite, player, targetMap,
+            Vector2{ targetX, targetY }
+        ));
+    }
+    else if (entry.kind == SpawnKind::Npc) {
+        if (!spriteMap[spriteName]) {
+            // // TODO: handle this differently, this might create empty references
+            spriteMap[spriteName] = sprite;
         }
-        else if (obj.type == "sprite") {
-            if (objectStates[obj.id].isDefeated) {
-                // this sprite is dead, skip it
-                continue;
-            }
-            std::string spriteName = obj.properties.value("spriteName", "sprite_default");
-            // get the data for this sprite from the JSON
-            const auto& data = spriteData.contains(spriteName)
-                ? spriteData.at(spriteName)
-                : spriteData.at("sprite_default");
-            if (!spriteData.contains(spriteName)) {
-                TraceLog(LOG_WARNING, "Missing sprite data for %s, falling back to sprite_default", spriteName.c_str());
-            }
-            // store default data seperately to replace individual attributes
-            const auto& defaultData = spriteData.at("sprite_default");
-            auto textureKeys = data.contains("textures") ? data.at("textures").get<std::vector<std::string>>() : defaultData.at("textures").get<std::vector<std::string>>();
-            // get the hitbox dimensions for the constructor
-            // if not specified in the JSON data, it takes the dimensions from the Tiled object data
-            Vector2 hitbox = data.contains("hitbox") ?
-                Vector2{ data.at("hitbox")[0].get<float>(), data.at("hitbox")[1].get<float>() } :
-                Vector2{ obj.width, obj.height };
-            // instanciate the sprite
-            auto sprite = std::make_shared<Sprite>(
-                game, obj.x, obj.y, hitbox.x, hitbox.y, obj.name
-            );
-            // generic attributes
-            // from JSON data
-            sprite->health = data.contains("health") ? data.at("health").get<int>() : defaultData.at("health").get<int>();
-            sprite->damage = data.contains("damage") ? data.at("damage").get<int>() : defaultData.at("damage").get<int>();
-            sprite->speed = data.contains("speed") ? data.at("speed").get<float>() : defaultData.at("speed").get<float>();
-            sprite->knockback = data.contains("knockback") ? data.at("knockback").get<float>() : defaultData.at("knockback").get<float>();
-            sprite->hitboxOffset = data.contains("hitboxOffset") ?
-                Vector2{ data.at("hitboxOffset")[0].get<float>(), data.at("hitboxOffset")[1].get<float>() } :
-                Vector2{ 0.0f, 0.0f };
-            //sprite->emitsLight = true; // TODO
-            // attributes from Tiled data (instance-specific, overwrite JSON data)
-            sprite->spriteName = spriteName;
-            sprite->speed = obj.properties.value("speed", sprite->speed);
-            sprite->damage = obj.properties.value("damage", sprite->damage);
-            sprite->knockback = obj.properties.value("knockback", sprite->knockback);
-            sprite->tileMapID = obj.id;
-            sprite->drawLayer = obj.properties.value("drawLayer", 0);
-            float hurtboxW = obj.properties.value("hurtboxW", 0.0f);
-            float hurtboxH = obj.properties.value("hurtboxH", 0.0f);
-            if (hurtboxW != 0.0f && hurtboxH != 0.0f) {
-                sprite->setHurtbox(-1.0f, -1.0f, hurtboxW, hurtboxH);
-            }
-            if (data.contains("collides")) {
-                sprite->isColliding = static_cast<bool>(data.at("collides").get<int>());
-            }
-            // TODO: is this still needed?
-            //if (obj.properties.contains("dialogue")) {
-            //    data["behaviorData"]["dialogue"] = obj.properties["dialogue"].get<std::string>();
-            //}
-
-            // specific sprite attributes
-            // TODO: for persistent sprites, check if they exist in the spriteMap
-            if (obj.name == "teleport") {
-                sprite->isColliding = false;
-                sprite->visible = false;
-                std::string targetMap = obj.properties.value("targetMap", "");
-                float targetX = obj.properties.value("targetPosX", 0.0f);
-                float targetY = obj.properties.value("targetPosY", 0.0f);
-                sprite->addBehavior(std::make_unique<TeleportBehavior>(
-                    game, sprite, player, targetMap,
-                    Vector2{ targetX, targetY }
-                ));
-            }
-            else if (obj.name == "npc") {
-                if (!spriteMap[spriteName]) {
-                    // // TODO: handle this differently, this might create empty references
-                    spriteMap[spriteName] = sprite;
-                }
-                sprite->setTextures(textureKeys);
-            }
-            else if (obj.name == "tradeItem") {
-                sprite->setTextures(std::vector<std::string>{ spriteName });
-                sprite->doesAnimate = false;
-                uint32_t cost = obj.properties.value("cost", 999);
-                std::string name = obj.properties.value("name", "error"); // TODO switch spriteName and Name
-                sprite->addBehavior(std::make_unique<TradeItemBehavior>(game, sprite, player, name, cost));
-            }
-            else if (obj.name == "enemy") {
-                sprite->canHurtPlayer = true;
-                sprite->isEnemy = true;
-                sprite->setTextures(textureKeys);
-                // spawn the item drops if the enemy is defeated
-                if (data.contains("itemDrops")) {
-                    std::weak_ptr<Sprite> weakSprite = sprite;
-                    std::string eventName = "killSprite_" + std::to_string(reinterpret_cast<uintptr_t>(sprite.get()));
-                    game.eventManager.addListener(eventName, [this, weakSprite, data](std::any) {
-                        auto s = weakSprite.lock();
-                        if (!s) 
-                            return;
-                        float rand = static_cast<float>(GetRandomValue(0, 10000)) / 10000.0f;
-                        float accum = 0.0f;
-                        for (const auto& drop : data["itemDrops"]) {
-                            std::string itemId = drop.at(0);
-                            float chance = drop.at(1);
-                            accum += chance;
-                            if (rand < accum) {
-                                auto item = std::make_shared<Sprite>(
-                                    game, s->position.x, s->position.y, 12.0f, 12.0f, itemId
-                                );
-                                auto& itemData = game.inventory.getItemData();
-                                auto it = itemData.find(itemId);
-                                if (it != itemData.end()) {
-                                    const ItemData& data = it->second;
-                                    item->setTextures(std::vector<std::string>{ data.textureKey });
-                                }
-                                else {
-                                    item->setTextures(std::vector<std::string>{ "sprite_default" }); // missing item data
-                                }
-                                item->drawLayer = 1;
-                                item->doesAnimate = false;
-                                item->isColliding = false;
-                                // TODO: this does not scale well. write a function that handles any itemID
-                                // make ItemDripHeart an Item with type "IMMEDIATE"
-                                if (itemId == "itemDropHeart" && player) {
-                                    item->addBehavior(std::make_unique<HealBehavior>(game, item, player, 2));
-                                }
-                                else {
-                                    item->addBehavior(std::make_unique<CollectItemBehavior>(game, item, player, itemId, 1));
-                                }
-                                game.sprites.emplace_back(item);
-                                break;
-                            }
+        sprite->frames = archetype->frames;
+    }
+    else if (entry.kind == SpawnKind::TradeItem) {
+        sprite->setTextures(std::vector<std::string>{ spriteName });
+        sprite->doesAnimate = false;
+        uint32_t cost = obj.properties.value("cost", 999);
+        std::string name = obj.properties.value("name", "error"); // TODO switch spriteName and Name
+        sprite->addBehavior(std::make_unique<TradeItemBehavior>(game, sprite, player, name, cost));
+    }
+    else if (entry.kind == SpawnKind::Enemy) {
+        sprite->canHurtPlayer = true;
+        sprite->isEnemy = true;
+        sprite->frames = archetype->frames;
+        // spawn the item drops if the enemy is defeated
+        if (!archetype->itemDrops.empty()) {
+            std::weak_ptr<Sprite> weakSprite = sprite;
+            std::string eventName = "killSprite_" + std::to_string(reinterpret_cast<uintptr_t>(sprite.get()));
+            sprite->subscriptions.push_back(game.eventManager.listen(eventName, [this, weakSprite, archetype](std::any) {
+                auto s = weakSprite.lock();
+                if (!s) 
+                    return;
+                float rand = static_cast<float>(GetRandomValue(0, 10000)) / 10000.0f;
+                float accum = 0.0f;
+                for (const ItemDrop& drop : archetype->itemDrops) {
+                    const std::string& itemId = drop.itemId;
+                    accum += drop.chance;
+                    if (rand < accum) {
+                        auto item = std::make_shared<Sprite>(
+                            game, s->position.x, s->position.y, 12.0f, 12.0f, itemId
+                        );
+                        auto& itemData = game.inventory.getItemData();
+                        auto it = itemData.find(itemId);
+                        if (it != itemData.end()) {
+                            const ItemData& data = it->second;
+                            item->setTextures(std::vector<std::string>{ data.textureKey });
                         }
-                        });
-                }
-            }
-            else if (obj.name == "door") {
-                sprite->spriteName = spriteName;
-                sprite->setTextures(textureKeys);
-                sprite->doesAnimate = false;
-                // TODO: set the open state in Tiled Data
-                uint8_t openState = obj.properties.value("openState", 0);
-
-                std::string triggerKey = obj.properties.value("event", "");
-
-                if (currentState < openState && !objectStates[obj.id].isOpened) {
-                    sprite->staticCollision = true;
-                    bool locked = obj.properties.value("locked", false);
-                    if (locked) {
-                        sprite->currentFrame = 2;
-                        sprite->addBehavior(std::make_unique<OpenLockBehavior>(game, sprite, player, triggerKey));
-                    }
-                }
-                else {
-                    sprite->currentFrame = 1;
-                    sprite->staticCollision = false;
-                }
-                // external door trigger
-                game.eventManager.addListener(triggerKey, [&, sprite = sprite.get()](std::any) {
-                    objectStates[obj.id].isOpened = true;
-                    sprite->currentFrame = 1;
-                    sprite->staticCollision = false;
-                    });
-            }
-            else if (obj.name == "hurt") {
-                // invisible sprite with hurtbox (e.g. floor spikes)
-                sprite->canHurtPlayer = true;
-                sprite->visible = false;
-                sprite->isColliding = false;
-            }
-            else if (obj.name == "chest") {
-                sprite->doesAnimate = false;
-                sprite->staticCollision = true;
-                sprite->setTextures({ "chest" });
-
-                if (objectStates[obj.id].isOpened) {
-                    sprite->currentFrame = 2;
-                }
-                else {
-                    std::string eventKey = "chest_opened_" + std::to_string(obj.id);
-                    game.eventManager.removeListeners(eventKey);
-                    game.eventManager.addListener(eventKey, [&](std::any data) {
-                        uint32_t eventId = std::any_cast<uint32_t>(data);
-                        if (eventId == obj.id) {
-                            objectStates[obj.id].isOpened = true;
+                        else {
+                            item->setTextures(std::vector<std::string>{ "sprite_default" }); // missing item data
+                        }
+                        item->drawLayer = 1;
+                        item->doesAnimate = false;
+                        item->isColliding = false;
+                        // TODO: this does not scale well. write a function that handles any itemID
+                        // make ItemDripHeart an Item with type "IMMEDIATE"
+                        if (itemId == "itemDropHeart" && player) {
+                            item->addBehavior(std::make_unique<HealBehavior>(game, item, player, 2));
                         }
-                        });
-                    sprite->addBehavior(std::make_unique<ChestBehavior>(game, sprite, player, static_cast<std::string>(obj.properties.value("item", "coin")), static_cast<uint32_t>(obj.properties.value("amount", 999))));
+                        else {
+                            item->addBehavior(std::make_unique<CollectItemBehavior>(game, item, player, itemId, 1));
+                        }
+                        game.sprites.emplace_back(item);
+                        break;
+                    }
                 }
+                }, true));
+        }
+    }
+    else if (entry.kind == SpawnKind::Door) {
+        sprite->spriteName = spriteName;
+        sprite->frames = archetype->frames;
+        sprite->doesAnimate = false;
+        // TODO: set the open state in Tiled Data
+        uint8_t openState = obj.properties.value("openState", 0);
+
+        std::string triggerKey = obj.properties.value("event", "");
+
+        if (currentState < openState && !objectStates[obj.id].isOpened) {
+            sprite->staticCollision = true;
+            bool locked = obj.properties.value("locked", false);
+            if (locked) {
+                sprite->currentFrame = 2;
+                sprite->addBehavior(std::make_unique<OpenLockBehavior>(game, sprite, player, triggerKey));
             }
-            // add an event that changes the isDefeated field for this sprite
-            std::string eventKey = "defeated_" + std::to_string(obj.id);
-            game.eventManager.removeListeners(eventKey);
-            game.eventManager.addListener(eventKey, [&](std::any data) {
+        }
+        else {
+            sprite->currentFrame = 1;
+            sprite->staticCollision = false;
+        }
+        // external door trigger
+        sprite->subscriptions.push_back(game.eventManager.listen(triggerKey, [&, sprite = sprite.get()](std::any) {
+            objectStates[obj.id].isOpened = true;
+            sprite->currentFrame = 1;
+            sprite->staticCollision = false;
+            }));
+    }
+    else if (entry.kind == SpawnKind::Hurt) {
+        // invisible sprite with hurtbox (e.g. floor spikes)
+        sprite->canHurtPlayer = true;
+        sprite->visible = false;
+        sprite->isColliding = false;
+    }
+    else if (entry.kind == SpawnKind::Chest) {
+        sprite->doesAnimate = false;
+        sprite->staticCollision = true;
+        sprite->setTextures({ "chest" });
+
+        if (objectStates[obj.id].isOpened) {
+            sprite->currentFrame = 2;
+        }
+        else {
+            std::string eventKey = "chest_opened_" + std::to_string(obj.id);
+            sprite->subscriptions.push_back(game.eventManager.listen(eventKey, [&](std::any data) {
                 uint32_t eventId = std::any_cast<uint32_t>(data);
-                auto& currentRoomObjectStates = game.currentDungeon->getCurrentRoomObjectStates();
                 if (eventId == obj.id) {
-                    currentRoomObjectStates[obj.id].isDefeated = true;
+                    objectStates[obj.id].isOpened = true;
                 }
-                });
-            if (data.contains("behaviors")) {
-                addBehaviorsToSprite(sprite, data.at("behaviors"), data.at("behaviorData"));
-            }
-            game.sprites.emplace_back(sprite);
+                }));
+            sprite->addBehavior(std::make_unique<ChestBehavior>(game, sprite, player, static_cast<std::string>(obj.properties.value("item", "coin")), static_cast<uint32_t>(obj.properties.value("amount", 999))));
         }
     }
+    // add an event that changes the isDefeated field for this sprite
+    std::string eventKey = "defeated_" + std::to_string(obj.id);
+    sprite->subscriptions.push_back(game.eventManager.listen(eventKey, [&](std::any data) {
+        uint32_t eventId = std::any_cast<uint32_t>(data);
+        auto& currentRoomObjectStates = game.currentDungeon->getCurrentRoomObjectStates();
+        if (eventId == obj.id) {
+            currentRoomObjectStates[obj.id].isDefeated = true;
+        }
+        }));
+    addBehaviorsToSprite(sprite, *archetype);
+    game.sprites.emplace_back(sprite);
+    return sprite;
+}
+
+void InGame::loadTilemap() {
+    // TODO: this gets big, put this somewhere else
+    double startTime = GetTime();
+    tileMap = game.currentDungeon->loadCurrentTileMap();
+    spawnList = nullptr;
+    // remove static and dynamic (non-persistent) sprites
+    game.walls.clear();
+    game.clearSprites();
+    game.particles.killParticles(); // don't carry smoke trails over into the next room
+    // check if there even is a valid tile map
+    if (!tileMap)
+        return;
+    game.eventManager.pushEvent("roomChanged"_id, game.currentDungeon->getCurrentRoomIndex());
     // calculate the map dimensions (to be used by the camera)
     tileSize = tileMap->tileWidth;
     worldWidth = tileMap->width * tileSize;
     worldHeight = tileMap->height * tileSize;
-    // Tile map calculations, used for rendering
+    // the chunk textures are baked by the streamer once the camera gets close
     const Tileset& tileset = game.loader.getTileset(tileMap->getTilesetName());
     const Texture2D& texture = game.loader.getTextures(tileset.name)[0];
-    const size_t tilesPerRow = tileset.columns;
-    const size_t tilesPerChunkX = tileChunkSize / tileSize;
-    const size_t tilesPerChunkY = tileChunkSize / tileSize;
-    numChunksX = (worldWidth + tileChunkSize - 1) / tileChunkSize;
-    numChunksY = (worldHeight + tileChunkSize - 1) / tileChunkSize;
-    // prepare the Tilemap texture chunks
-    // TODO: draw chunks dynamically instead of storing them all beforehand?
-    size_t totalLayers = tileMap->layers.size();
-    tilemapChunks.resize(totalLayers);
-    for (size_t layerIndex = 0; layerIndex < totalLayers; ++layerIndex) {
-        const auto& layer = tileMap->getLayer(layerIndex);
-        if (!layer.visible) 
+    chunks.setBudget(
+        static_cast<size_t>(game.getSetting("chunkVramBudgetMB").get<float>() * 1024 * 1024),
+        game.getSetting("streamingMargin"), game.getSetting("chunkBakesPerFrame"));
+    chunks.setMap(game.currentDungeon->getCurrentRoom(), texture, tileset.columns);
+    // objects of big maps are only spawned near the camera, rooms spawn everything at once
+    streamObjects = chunks.getCellsX() * chunks.getCellsY() > game.getSetting("streamingMinChunks").get<size_t>();
+    cellObjects.assign(streamObjects ? chunks.getCellsX() * chunks.getCellsY() : 0, {});
+    cellWalls.assign(cellObjects.size(), {});
+    streamedWalls.clear();
+    streamedSprites.clear();
+    streamedStates.clear();
+    // the objects are compiled into a spawn list the first time the map is used
+    auto cached = spawnLists.find(tileMap->getName());
+    bool compiled = cached == spawnLists.end();
+    if (compiled) {
+        const SpriteArchetype* fallback = game.loader.findArchetype("sprite_default");
+        cached = spawnLists.emplace(tileMap->getName(),
+            SpawnList(*tileMap, game.loader.getArchetypeIds(), fallback ? fallback->id : 0)).first;
+    }
+    spawnList = &cached->second;
+    objectCells.assign(streamObjects ? spawnList->size() : 0, SIZE_MAX);
+    game.sprites.reserve(spawnList->size());
+    // build static collision objects and sprites from map data
+    size_t spritesBefore = game.sprites.size();
+    for (size_t i = 0; i < spawnList->size(); ++i) {
+        if (streamObjects && addStreamedObject(i))
             continue;
-        tilemapChunks[layerIndex].resize(numChunksX * numChunksY);
-        for (size_t cy = 0; cy < numChunksY; ++cy) {
-            for (size_t cx = 0; cx < numChunksX; ++cx) {
-                size_t idx = cy * numChunksX + cx;
-                RenderTexture2D chunk = LoadRenderTexture(tileChunkSize, tileChunkSize);
-                BeginTextureMode(chunk);
-                ClearBackground(BLANK);
-                size_t startTileX = cx * tilesPerChunkX;
-                size_t startTileY = cy * tilesPerChunkY;
-                for (size_t y = 0; y < tilesPerChunkY; ++y) {
-                    for (size_t x = 0; x < tilesPerChunkX; ++x) {
-                        size_t mapX = startTileX + x;
-                        size_t mapY = startTileY + y;
-                        if (mapX >= tileMap->width || mapY >= tileMap->height) continue;
-
-                        if (!layer.data[mapY][mapX]) continue; // 0 == transparent
-                        int tileIndex = layer.data[mapY][mapX] - 1;
-
-                        size_t tileX = ((size_t)tileIndex % tilesPerRow) * tileSize;
-                        size_t tileY = ((size_t)tileIndex / tilesPerRow) * tileSize;
-                        float srcX = std::clamp(static_cast<float>(tileX), 0.0f, static_cast<float>(texture.width - tileSize));
-                        float srcY = std::clamp(static_cast<float>(tileY), 0.0f, static_cast<float>(texture.height - tileSize));
-                        Rectangle src = { srcX, srcY, static_cast<float>(tileSize), static_cast<float>(tileSize) };
-
-                        Vector2 pos = { static_cast<float>(x * tileSize), static_cast<float>(y * tileSize) };
-                        DrawTextureRec(texture, src, pos, WHITE);
-                    }
-                }
-                EndTextureMode();
-                tilemapChunks[layerIndex][idx] = chunk;
-            }
-        }
+        spawnObject((*spawnList)[i]);
+    }
+    TraceLog(LOG_INFO, "Entered %s: %zu walls and %zu sprites from %zu objects in %.2f ms%s", tileMap->getName().c_str(),
+        game.walls.size(), game.sprites.size() - spritesBefore, spawnList->size(), (GetTime() - startTime) * 1000.0, compiled ? " (spawn list compiled)" : "");
+    if (streamObjects) {
+        TraceLog(LOG_INFO, "Streaming %s: %zu x %zu chunks, %zu walls and %zu objects streamed",
+            tileMap->getName().c_str(), chunks.getCellsX(), chunks.getCellsY(), streamedWalls.size(),
+            std::count_if(objectCells.begin(), objectCells.end(), [](size_t cell) { return cell != SIZE_MAX; }));
     }
     // check if a different music track should be played
     const std::string musicKey = tileMap->getMusicKey();
@@ -485,6 +429,7 @@ void InGame::loadTilemap() {
             sprite->moveTo(player->position.x, player->position.y);
         }
     }
+    game.eventManager.raiseSignal(SIGNAL_ROOM_CHANGED);
 }
 
 void InGame::resolveAxisX(const std::shared_ptr<Sprite>& sprite, const Rectangle& obstacle) {
@@ -551,18 +496,12 @@ void InGame::update(float deltaTime) {
             // and bind the Keys to events maybe?
             if (currentWeapon && !getSprite(*currentWeapon)) {
                 std::string weaponKey = *currentWeapon;
-                const auto& weaponData = game.loader.getSpriteData();
-
-                const auto& data = weaponData.contains(weaponKey)
-                    ? weaponData.at(weaponKey)
-                    : weaponData.at("weapon_default");
-
-                if (!weaponData.contains(weaponKey)) {
+                const SpriteArchetype* archetype = game.loader.findArchetype(weaponKey);
+                if (!archetype) {
                     TraceLog(LOG_WARNING, "Missing weapon data for %s, falling back to weapon_default", weaponKey.c_str());
+                    archetype = game.loader.findArchetype("weapon_default");
                 }
-
-                float offsetX = data.at("HurtboxOffsetX");
-                float offsetY = data.at("HurtboxOffsetY");
+                const WeaponStats& stats = archetype->weapon;
 
                 auto wpn = std::make_shared<Sprite>(
                     game, 0.0f, 0.0f, 16.0f, 16.0f, weaponKey
@@ -571,35 +510,32 @@ void InGame::update(float deltaTime) {
                 spriteMap[*currentWeapon] = wpn;
                 game.sprites.emplace_back(wpn);
 
-                wpn->setTextures({ weaponKey });
-                wpn->setHurtbox(-1.0f, -1.0f, data.at("HurtboxWidth"), data.at("HurtboxHeight"));
-                wpn->hurtboxOffset = { offsetX, offsetY };
+                wpn->frames = { stats.frames };
+                wpn->setHurtbox(-1.0f, -1.0f, stats.hurtboxSize.x, stats.hurtboxSize.y);
+                wpn->hurtboxOffset = stats.hurtboxOffset;
                 wpn->doesAnimate = false;
                 wpn->isColliding = false;
-                wpn->damage = data.at("damage");
-                weaponType type = static_cast<weaponType>(data.at("type"));
-                wpn->addBehavior(std::make_unique<WeaponBehavior>(game, wpn, player, data.at("lifetime"), type));
+                wpn->damage = stats.damage;
+                wpn->addBehavior(std::make_unique<WeaponBehavior>(game, wpn, player, stats.lifetime, static_cast<weaponType>(stats.type)));
 
                 // add an event listener that removes the sword
                 // the "killWeapon" event is dispatched by WeaponBehavior once it's finished
                 game.eventManager.addListener("killWeapon", [this, wpn](std::any) {
                     spriteMap.erase(*currentWeapon); // TODO: is this safe to do it here?
                     wpn->markForDeletion();
-                    game.eventManager.removeListeners("killWeapon");
-                    });
-                game.playSound("slash");
+                    }, true);
+                game.playSound("slash"_id);
             }
         }
         if (game.buttonsPressed & CONTROL_CONFIRM) {
             // TODO: bind events to all the button functionality
             game.pauseScene(this->getName());
             game.startScene("InventoryUI");
-            // TODO: make this a single-use event
             game.eventManager.addListener("InventoryDone", [this](std::any) {
                 // return to this scene
                 this->game.resumeScene(this->getName());
-                });
-            game.eventManager.pushEvent("setMusicVolume", 0.3f);
+                }, true);
+            game.eventManager.emit<MusicVolume>(0.3f);
         }
         if (game.buttonsPressed & CONTROL_CANCEL) {
             game.pauseScene(this->getName());
@@ -609,13 +545,39 @@ void InGame::update(float deltaTime) {
                 // return to this scene
                 this->game.resumeScene(this->getName());
                 game.wakeScene("HUD");
+                }, true);
+            game.eventManager.emit<MusicVolume>(0.3f);
+        }
+        // behaviors that push events, play sounds or draw random numbers run one after another,
+        // before the integration, so what they do to the acceleration counts this frame (like it did before the job system)
+        auto& sprites = game.sprites;
+        {
+            PROFILE_ZONE("behaviors");
+            for (const auto& sprite : sprites) {
+                if (sprite) sprite->executeBehavior(deltaTime);
+            }
+        }
+        // apply the acceleration from the controls, the behaviors and last frame's steering
+        {
+            PROFILE_ZONE("integrate");
+            game.jobs->parallelFor(sprites.size(), SPRITES_PER_JOB, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    if (sprites[i]) sprites[i]->update(deltaTime);
+                }
                 });
-            game.eventManager.pushEvent("setMusicVolume", 0.3f);
         }
-        for (const auto& sprite : game.sprites) {
-            if (sprite) {
-                sprite->executeBehavior(deltaTime);
-                sprite->update(deltaTime);
+        // steering behaviors read the sprites as they are now and write into their own slot,
+        // the result is applied after all of them are done (so the order doesn't matter) and moves the sprites next frame
+        {
+            PROFILE_ZONE("steering");
+            steering.assign(sprites.size(), Steering{});
+            game.jobs->parallelFor(sprites.size(), SPRITES_PER_JOB, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    if (sprites[i] && sprites[i]->hasSteering()) sprites[i]->steer(deltaTime, steering[i]);
+                }
+                });
+            for (size_t i = 0; i < sprites.size(); ++i) {
+                if (sprites[i]) sprites[i]->applySteering(steering[i]);
             }
         }
     }
@@ -628,9 +590,16 @@ void InGame::update(float deltaTime) {
         lights[i].active = false;
     }
 
+    // progress the animation index and change the textures if necessary
+    {
+        PROFILE_ZONE("animate");
+        game.jobs->parallelFor(game.sprites.size(), SPRITES_PER_JOB, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                game.sprites[i]->animate(deltaTime);
+            }
+            });
+    }
     for (const auto& sprite : game.sprites) {
-        // progress the animation index and change the textures if necessary
-        sprite->animate(deltaTime);
         // check if the sprite emits light in dark rooms
         // and give it a light cone
         if (game.currentDungeon->isRoomDark() && sprite->emitsLight && currentLightIndex < MAX_LIGHTS) {
@@ -645,62 +614,63 @@ void InGame::update(float deltaTime) {
     // TODO: make this a method of Sprite?
     // 
     // resolve collision in the X direction
-    for (const auto& sprite : game.sprites) {
-        sprite->rect.x = sprite->position.x;
-        for (const auto& wall : game.walls) {
-            resolveAxisX(sprite, *wall);
-        }
-        for (const auto& other : game.sprites) {
-            if (other != sprite && other->staticCollision) {
-                resolveAxisX(sprite, other->rect);
+    {
+        PROFILE_ZONE("collision");
+        for (const auto& sprite : game.sprites) {
+            sprite->rect.x = sprite->position.x;
+            for (const auto& wall : game.walls) {
+                resolveAxisX(sprite, *wall);
+            }
+            for (const auto& other : game.sprites) {
+                if (other != sprite && other->staticCollision) {
+                    resolveAxisX(sprite, other->rect);
+                }
             }
-        }
 
-        sprite->rect.y = sprite->position.y;
-        for (const auto& wall : game.walls) {
-            resolveAxisY(sprite, *wall);
-        }
-        for (const auto& other : game.sprites) {
-            if (other != sprite && other->staticCollision) {
-                resolveAxisY(sprite, other->rect);
+            sprite->rect.y = sprite->position.y;
+            for (const auto& wall : game.walls) {
+                resolveAxisY(sprite, *wall);
+            }
+            for (const auto& other : game.sprites) {
+                if (other != sprite && other->staticCollision) {
+                    resolveAxisY(sprite, other->rect);
+                }
             }
-        }
 
-        // hurtbox centering midbottom
-        sprite->hurtbox.x = sprite->rect.x + (sprite->rect.width - sprite->hurtbox.width) / 2 + sprite->hurtboxOffset.x;
-        sprite->hurtbox.y = sprite->rect.y + (sprite->rect.height - sprite->hurtbox.height) + sprite->hurtboxOffset.y;
+            // hurtbox centering midbottom
+            sprite->hurtbox.x = sprite->rect.x + (sprite->rect.width - sprite->hurtbox.width) / 2 + sprite->hurtboxOffset.x;
+            sprite->hurtbox.y = sprite->rect.y + (sprite->rect.height - sprite->hurtbox.height) + sprite->hurtboxOffset.y;
 
-        // player damage
-        if (sprite->canHurtPlayer && player->iFrameTimer < 0.001f && CheckCollisionRecs(sprite->hurtbox, player->rect)) {
-            if (sprite->damage < player->health) {
-                player->health -= sprite->damage;
-            }
-            else {
-                player->health = 0;
+            // player damage
+            if (sprite->canHurtPlayer && player->iFrameTimer < 0.001f && CheckCollisionRecs(sprite->hurtbox, player->rect)) {
+                if (sprite->damage < player->health) {
+                    player->health -= sprite->damage;
+                }
+                else {
+                    player->health = 0;
+                }
+                player->iFrameTimer = game.getSetting("PlayeriFrames");
+                applyKnockback(*sprite, *player, sprite->knockback);
+                game.playSound("hurt1"_id);
             }
-            player->iFrameTimer = game.getSetting("PlayeriFrames");
-            applyKnockback(*sprite, *player, sprite->knockback);
-            game.playSound("hurt1");
-        }
 
-        // weapon damage
-        // everything that can hurt the player can also be damaged
-        if (sprite->isEnemy && currentWeapon.has_value()) {
-            Sprite* weapon = getSprite(*currentWeapon);
-            if (weapon && sprite->iFrameTimer < 0.001f && sprite->health > 0 &&
-                CheckCollisionRecs(weapon->hurtbox, sprite->rect)) {
-                sprite->health = (weapon->damage > sprite->health) ? 0 : sprite->health - weapon->damage;
-                sprite->iFrameTimer = 0.5f;
-                applyKnockback(*weapon, *sprite, 8.0f);
-                game.playSound("creature_hurt_02");
+            // weapon damage
+            // everything that can hurt the player can also be damaged
+            if (sprite->isEnemy && currentWeapon.has_value()) {
+                Sprite* weapon = getSprite(*currentWeapon);
+                if (weapon && sprite->iFrameTimer < 0.001f && sprite->health > 0 &&
+                    CheckCollisionRecs(weapon->hurtbox, sprite->rect)) {
+                    sprite->health = (weapon->damage > sprite->health) ? 0 : sprite->health - weapon->damage;
+                    sprite->iFrameTimer = 0.5f;
+                    applyKnockback(*weapon, *sprite, 8.0f);
+                    game.playSound("creature_hurt_02"_id);
+                }
             }
         }
     }
 
     // particles
-    for (auto& emitter : game.emitters) {
-        emitter.update(deltaTime);
-    }
+    game.particles.update(deltaTime, game.jobs.get());
 
     // Camera follows the player (center)
     Vector2 target = {
@@ -763,39 +733,125 @@ void InGame::update(float deltaTime) {
     }
 }
 
-void InGame::drawTilemapChunks(int layerIndex) {
+void InGame::drawTilemapChunks(int layerIndex, RenderSnapshot& out) {
+    chunks.drawLayer(static_cast<size_t>(layerIndex), cameraView(), game.debug, out);
+}
+
+Rectangle InGame::cameraView() const {
+    // the part of the world that's on screen
     float viewX = camera.target.x - (camera.offset.x / camera.zoom);
     float viewY = camera.target.y - (camera.offset.y / camera.zoom);
+    return Rectangle{ viewX, viewY, game.gameScreenWidth / camera.zoom, game.gameScreenHeight / camera.zoom };
+}
 
-    for (size_t cy = 0; cy < numChunksY; ++cy) {
-        for (size_t cx = 0; cx < numChunksX; ++cx) {
-            size_t chunkWorldX = cx * tileChunkSize;
-            size_t chunkWorldY = cy * tileChunkSize;
-
-            // chunk is outside the camera fov
-            if (chunkWorldX + tileChunkSize < viewX || chunkWorldX > viewX + game.gameScreenWidth / camera.zoom ||
-                chunkWorldY + tileChunkSize < viewY || chunkWorldY > viewY + game.gameScreenHeight / camera.zoom)
-                continue;
-
-            size_t idx = cy * numChunksX + cx;
-            Vector2 drawPos = { (float)chunkWorldX, (float)chunkWorldY };
-
-            // chunks are flipped, so the src rect has to be flipped to draw the chunk correctly
-            Rectangle src = { 0, 0, (float)tileChunkSize, -(float)tileChunkSize };
-            Rectangle dst = { drawPos.x, drawPos.y, (float)tileChunkSize, (float)tileChunkSize };
-            Vector2 origin = { 0, 0 };
-            DrawTexturePro(tilemapChunks[layerIndex][idx].texture, src, dst, origin, 0.0f, WHITE);
-            if (game.debug) {
-                DrawRectangleLines((int)drawPos.x, (int)drawPos.y, tileChunkSize, tileChunkSize, RED);
+bool InGame::addStreamedObject(size_t index) {
+    // sorts an object of a big map into the cells of the chunk grid
+    // returns false if the object has to exist all the time
+    const SpawnEntry& entry = (*spawnList)[index];
+    const Rectangle& bounds = entry.bounds;
+    if (entry.kind == SpawnKind::Wall) {
+        if (!entry.existsIn(game.currentDungeon->getCurrentRoomState()))
+            return true;
+        // long walls are in every cell they touch
+        size_t wall = streamedWalls.size();
+        streamedWalls.push_back(bounds);
+        size_t first = chunks.cellAt(bounds.x, bounds.y);
+        size_t last = chunks.cellAt(bounds.x + bounds.width, bounds.y + bounds.height);
+        size_t cellsX = chunks.getCellsX();
+        for (size_t cy = first / cellsX; cy <= last / cellsX; ++cy) {
+            for (size_t cx = first % cellsX; cx <= last % cellsX; ++cx) {
+                cellWalls[cy * cellsX + cx].push_back(wall);
+            }
+        }
+        return true;
+    }
+    // these are referenced by name, events or the player, they stay around
+    if (entry.kind == SpawnKind::Door || entry.kind == SpawnKind::Npc || entry.kind == SpawnKind::Teleport)
+        return false;
+    size_t cell = chunks.cellAt(bounds.x + bounds.width * 0.5f, bounds.y + bounds.height * 0.5f);
+    objectCells[index] = cell;
+    cellObjects[cell].push_back(index);
+    return true;
+}
+
+void InGame::updateStreaming() {
+    if (!tileMap) return;
+    PROFILE_ZONE("streaming");
+    bool wallsChanged = false;
+    chunks.update(cameraView(), game.getSetting("streamingMargin").get<float>() * 2.0f,
+        [&](size_t cell) {
+            wallsChanged = wallsChanged || !cellWalls.empty();
+            if (!streamObjects) return;
+            for (size_t index : cellObjects[cell]) {
+                if (streamedSprites.count(index)) continue;
+                auto sprite = spawnObject((*spawnList)[index]);
+                if (!sprite) continue;
+                // continue where it was left
+                auto saved = streamedStates.find(index);
+                if (saved != streamedStates.end()) {
+                    sprite->moveTo(saved->second.position.x, saved->second.position.y);
+                    sprite->health = saved->second.health;
+                }
+                streamedSprites[index] = sprite;
+            }
+        },
+        [&](size_t) { wallsChanged = wallsChanged || !cellWalls.empty(); });
+    if (!streamObjects) return;
+
+    // sprites that walked (or were left) outside of the active cells are put to sleep
+    // their position and health are kept, and they go into the cell they're in now
+    for (auto it = streamedSprites.begin(); it != streamedSprites.end();) {
+        const auto& sprite = it->second;
+        size_t index = it->first;
+        if (sprite->isMarkedForDeletion()) {
+            it = streamedSprites.erase(it);
+            continue;
+        }
+        size_t cell = chunks.cellAt(sprite->position.x, sprite->position.y);
+        if (sprite->dying || chunks.isCellActive(cell)) {
+            ++it;
+            continue;
+        }
+        streamedStates[index] = StreamedState{ sprite->position, sprite->health };
+        sprite->subscriptions.clear();
+        sprite->markForDeletion();
+        auto& oldCell = cellObjects[objectCells[index]];
+        oldCell.erase(std::find(oldCell.begin(), oldCell.end(), index));
+        cellObjects[cell].push_back(index);
+        objectCells[index] = cell;
+        it = streamedSprites.erase(it);
+    }
+
+    if (wallsChanged) {
+        // walls can be in more than one cell, so the list is built again instead of patched
+        game.walls.clear();
+        std::vector<bool> added(streamedWalls.size(), false);
+        for (size_t cell = 0; cell < cellWalls.size(); ++cell) {
+            if (!chunks.isCellActive(cell)) continue;
+            for (size_t wall : cellWalls[cell]) {
+                if (added[wall]) continue;
+                added[wall] = true;
+                game.walls.push_back(std::make_unique<Rectangle>(streamedWalls[wall]));
             }
         }
     }
 }
 
-void InGame::draw() {
-    ClearBackground(RED);  // red just for camera debugging
+void InGame::lateUpdate() {
+    // the camera has its final position for this frame
+    // (streaming bakes chunk textures, so it can't be part of update())
+    updateStreaming();
+}
 
-    BeginMode2D(camera); // draw the textures that are affected by the camera
+bool InGame::capture() {
+    RenderSnapshot& out = frameSnapshot;
+    out.clear();
+    // room for every particle the budget allows and a sprite with its behavior, otherwise the snapshot
+    // grows in the middle of a frame whenever the particle count reaches a new high
+    out.reserve(game.particles.getGlobalBudget() + game.sprites.size() * 2);
+    out.clearBackground(RED);  // red just for camera debugging
+
+    out.beginMode2D(camera); // draw the textures that are affected by the camera
     // draw each tilemap layer except the top one
     int lastLayer = 0;
     if (tileMap) {
@@ -803,13 +859,12 @@ void InGame::draw() {
         lastLayer = (totalLayers > 1) ? totalLayers - 1 : -1;
         for (int layerIndex = 0; layerIndex < totalLayers; ++layerIndex) {
             if (layerIndex == lastLayer || !tileMap->layers[layerIndex].visible) continue;
-            drawTilemapChunks(layerIndex);
+            drawTilemapChunks(layerIndex, out);
         }
     }
     // Draw the sprites after sorting them by their bottom y position, also respect the drawing layer of each sprite (fixed)
     // TODO add a flag to sprite that makes an exception from this sorting
-    std::vector<Sprite*> drawOrder;
-    drawOrder.reserve(game.sprites.size());
+    drawOrder.clear();
     for (const auto& sprite : game.sprites) {
         drawOrder.push_back(sprite.get());
     }
@@ -819,50 +874,60 @@ void InGame::draw() {
         return (a->rect.y + a->rect.height) < (b->rect.y + b->rect.height);
         });
     for (Sprite* sprite : drawOrder) {
-        sprite->draw();
-        sprite->drawBehavior();
+        sprite->draw(out);
+        sprite->drawBehavior(out);
     }
     // particles
-    for (auto& emitter : game.emitters) {
-        emitter.draw();
-    }
+    game.particles.draw(out);
     if (tileMap) {
         // now draw the top layer above the sprites
         if (lastLayer >= 0 && tileMap->layers[lastLayer].visible) {
-            drawTilemapChunks(lastLayer);
+            drawTilemapChunks(lastLayer, out);
         }
     }
 
     if (game.debug) {
         for (const auto& wall : game.walls) {
-            DrawRectangleLines((int)wall->x, (int)wall->y, (int)wall->width, (int)wall->height, BLUE);
+            out.drawRectangleLines((int)wall->x, (int)wall->y, (int)wall->width, (int)wall->height, BLUE);
         }
         for (const auto& sprite : game.sprites) {
-            DrawRectangleLines((int)sprite->rect.x, (int)sprite->rect.y, (int)sprite->rect.width, (int)sprite->rect.height, GREEN);
+            out.drawRectangleLines((int)sprite->rect.x, (int)sprite->rect.y, (int)sprite->rect.width, (int)sprite->rect.height, GREEN);
         }
         for (const auto& sprite : game.sprites) {
-            DrawRectangleLines((int)sprite->hurtbox.x, (int)sprite->hurtbox.y, (int)sprite->hurtbox.width, (int)sprite->hurtbox.height, RED);
+            out.drawRectangleLines((int)sprite->hurtbox.x, (int)sprite->hurtbox.y, (int)sprite->hurtbox.width, (int)sprite->hurtbox.height, RED);
         }
-        DrawCircle((int)player->position.x, (int)player->position.y, 2, BLUE);
+        out.drawCircle((int)player->position.x, (int)player->position.y, 2, BLUE);
     }
-    EndMode2D();
+    out.endMode2D();
 
     // draw lighting in dark rooms
     // TODO: should game.target be passed as an argument to scene.draw() instead of being indirectly accessible to the scenes?
     if (game.currentDungeon->isRoomDark())
-        DrawLightOverlay(game.target.texture, game.loader.getShader("light_mask"), lights, lightCount, static_cast<float>(game.gameScreenWidth), static_cast<float>(game.gameScreenHeight));
+        out.drawLightOverlay(game.target.texture, game.loader.getShader("light_mask"), lights, lightCount, static_cast<float>(game.gameScreenWidth), static_cast<float>(game.gameScreenHeight));
 
-    // cutscene stuff (textboxes etc) gets drawn relative to window position
-    game.cutsceneManager.draw();
     // overlay debug info texts
     if (game.debug) {
         std::string debugText = "Debug: ";
         // show the player's z velocity
         debugText += "player z vel: " + std::to_string(player->vz);
-        DrawText(debugText.c_str(), 4, game.gameScreenHeight - 22, 10, LIGHTGRAY);
+        out.drawText(debugText, 4, game.gameScreenHeight - 22, 10, LIGHTGRAY);
+        const auto& ps = game.particles.getStats();
+        out.drawText(format("ptcl: %zu em: %zu/%zu thin: %zu drop: %zu",
+            ps.liveParticles, ps.liveEmitters, ps.pooledEmitters, ps.thinned, ps.dropped), 4, game.gameScreenHeight - 34, 10, LIGHTGRAY);
+        const auto& cs = game.eventManager.getConditionStats();
+        out.drawText(format("cond: eval %zu skip %zu", cs.evaluated, cs.skipped), 4, game.gameScreenHeight - 46, 10, LIGHTGRAY);
+
+        out.drawCircle((int)camera.target.x, (int)camera.target.y, 2, WHITE);
+    }
+    // cutscene stuff (textboxes etc) isn't in the snapshot, draw() calls into the cutscene manager
+    drawCutscene = game.cutsceneManager.isActive();
+    return !drawCutscene;
+}
 
-        DrawCircle((int)camera.target.x, (int)camera.target.y, 2, WHITE);
-    }
+void InGame::draw() {
+    frameSnapshot.draw();
+    // gets drawn relative to window position
+    if (drawCutscene) game.cutsceneManager.draw();
 }
 
 void InGame::end() {
@@ -871,4 +936,5 @@ void InGame::end() {
 
     if (music) StopMusicStream(*music);
     music = nullptr;
+    chunks.clear();
 }
\ No newline at end of file
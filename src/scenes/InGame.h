@@ -4,6 +4,10 @@
 #include "TileMap.h"
 #include "Utils.h"
 #include "CircleOverlay.h"
+#include "ChunkStreamer.h"
+#include "SpriteArchetype.h"
+#include "SpawnList.h"
+#include "StringId.h"
 #include <memory>
 #include "json.hpp"
 
@@ -14,11 +18,16 @@ public:
     void update(float deltaTime) override;
     void draw() override;
     void end() override;
+    void lateUpdate() override;
+    bool capture() override;
 
     void loadTilemap(); // function that handles room transitions
-    void drawTilemapChunks(int layerIndex);
+    std::shared_ptr<Sprite> spawnObject(const SpawnEntry& entry); // wall or sprite from the map data
+    void drawTilemapChunks(int layerIndex, RenderSnapshot& out);
+    void updateStreaming(); // bakes chunks and (on big maps) spawns/removes objects around the camera
+    Rectangle cameraView() const;
     Sprite* getSprite(const std::string& name);
-    void addBehaviorsToSprite(std::shared_ptr<Sprite> sprite, const std::vector<std::string>& behaviors, const nlohmann::json& behaviorData);
+    void addBehaviorsToSprite(std::shared_ptr<Sprite> sprite, const SpriteArchetype& archetype);
     // methods for collision handling
     void resolveAxisX(const std::shared_ptr<Sprite>& sprite, const Rectangle& obstacle);
     void resolveAxisY(const std::shared_ptr<Sprite>& sprite, const Rectangle& obstacle);
@@ -27,7 +36,7 @@ public:
     size_t tileSize = 0; // value is read from Tiled data 
     Camera2D camera = {};
     CameraShake cameraShake;
-    std::unordered_map<std::string, std::shared_ptr<Sprite>> spriteMap; // keep named references to certain sprites
+    std::unordered_map<StringId, std::shared_ptr<Sprite>> spriteMap; // keep named references to certain sprites
     std::shared_ptr<Sprite> player;  // keep a player variable for direct frequent access
     std::optional<std::string> currentWeapon = std::nullopt;
     // light effects
@@ -51,7 +60,26 @@ private:
     size_t worldWidth;
     size_t worldHeight;
     static const size_t tileChunkSize = 256; // limit the size of the textures that hold the tilemap layers
-    size_t numChunksX = 0;
-    size_t numChunksY = 0;
-    std::vector<std::vector<RenderTexture2D>> tilemapChunks; // stores chunks of eachs of the layers of a map
+    static const size_t SPRITES_PER_JOB = 32; // smallest chunk of the parallel sprite passes
+    std::vector<Steering> steering; // one slot per sprite, see update()
+    std::vector<Sprite*> drawOrder; // the sprites sorted for drawing, kept so draw() doesn't allocate
+    RenderSnapshot frameSnapshot; // the world as of the last capture()
+    bool drawCutscene = false; // textboxes etc. are drawn live, so the frame can't be pipelined
+    ChunkStreamer chunks{ static_cast<int>(tileChunkSize) };
+    // compiled on the first visit of a map, rooms with the same template share one
+    std::unordered_map<std::string, SpawnList> spawnLists;
+    const SpawnList* spawnList = nullptr; // the current map's
+    // object streaming, only for maps with more than "streamingMinChunks" chunks
+    struct StreamedState {
+        Vector2 position;
+        uint32_t health;
+    };
+    bool streamObjects = false;
+    std::vector<std::vector<size_t>> cellObjects; // indices into spawnList for each cell
+    std::vector<size_t> objectCells; // the other way around, SIZE_MAX for objects that aren't streamed
+    std::vector<std::vector<size_t>> cellWalls; // indices into streamedWalls
+    std::vector<Rectangle> streamedWalls;
+    std::unordered_map<size_t, std::shared_ptr<Sprite>> streamedSprites; // spawned streamed objects
+    std::unordered_map<size_t, StreamedState> streamedStates; // objects that were active before
+    bool addStreamedObject(size_t index);
 };
@@ -11,11 +11,11 @@ void InventoryUI::startup() {
     y = float(game.gameScreenHeight); // start the inventory hidden at the bottom
     topY = game.getSetting("HudHeight");
     width = game.gameScreenWidth;
-    height = game.gameScreenHeight - game.getSetting("HudHeight");
+    height = game.gameScreenHeight - game.getSetting("HudHeight").get<uint32_t>();
     // set the sliding speed so that it takes "slideDuration" seconds to expand the inventory
     speed = height / slideDuration;
     state = OPENING;
-    game.playSound("menuOpen");
+    game.playSound("menuOpen"_id);
 }
 
 void InventoryUI::update(float deltaTime) {
@@ -33,7 +33,7 @@ void InventoryUI::update(float deltaTime) {
             y = std::min(static_cast<float>(game.gameScreenHeight), y + deltaTime * speed);
         }
         else {
-            game.eventManager.pushEvent("InventoryDone");
+            game.eventManager.pushEvent("InventoryDone"_id);
             game.stopScene("InventoryUI");
         }
         break;
@@ -58,11 +58,11 @@ void InventoryUI::update(float deltaTime) {
     case OPENED:
         if (game.buttonsPressed & CONTROL_CONFIRM) {
             state = CLOSING;
-            game.playSound("menuClose");
+            game.playSound("menuClose"_id);
         }
         if (game.buttonsPressed & CONTROL_ACTIONR) {
             state = SLIDING_LEFT;
-            game.playSound("menuOpen");
+            game.playSound("menuOpen"_id);
             game.startScene("MapUI");
         }
         // cursor movement (only when there are weapons)
@@ -80,11 +80,11 @@ void InventoryUI::update(float deltaTime) {
 
         if (game.buttonsPressed & CONTROL_RIGHT) {
             index = (index + 1) % totalItems;
-            game.playSound("menuCursor");
+            game.playSound("menuCursor"_id);
         }
         if (game.buttonsPressed & CONTROL_LEFT) {
             index = (index + totalItems - 1) % totalItems;
-            game.playSound("menuCursor");
+            game.playSound("menuCursor"_id);
         }
 
         size_t weaponCount = items[WEAPON].size();
@@ -99,7 +99,7 @@ void InventoryUI::update(float deltaTime) {
                 if (candidateIndex < totalItems) index = candidateIndex;
                 else index = totalItems - 1;
             }
-            game.playSound("menuCursor");
+            game.playSound("menuCursor"_id);
         }
 
         if (game.buttonsPressed & CONTROL_UP) {
@@ -127,18 +127,18 @@ void InventoryUI::update(float deltaTime) {
                 // In second weapon row → move to first
                 index -= cols;
             }
-            game.playSound("menuCursor");
+            game.playSound("menuCursor"_id);
         }
 
         if (game.buttonsPressed & CONTROL_ACTION1) {
             // choose the appropriate action for the selected item
             const auto* selected = flatItems[index];
             if (selected->first->type == WEAPON) {
-                game.eventManager.pushEvent("weaponSet", selected->first->textureKey);
-                game.playSound("menuSelect");
+                game.eventManager.pushEvent("weaponSet"_id, selected->first->textureKey);
+                game.playSound("menuSelect"_id);
             }
             else {
-                game.eventManager.pushEvent("consumeItem", selected->first->textureKey);
+                game.eventManager.pushEvent("consumeItem"_id, selected->first->textureKey);
             }
         }
         break;
@@ -274,5 +274,5 @@ void InventoryUI::draw() {
 }
 
 void InventoryUI::end() {
-    game.eventManager.pushEvent("setMusicVolume", 1.0f);
+    game.eventManager.emit<MusicVolume>(1.0f);
 }
\ No newline at end of file
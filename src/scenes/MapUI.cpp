@@ -11,7 +11,7 @@ void MapUI::startup() {
     topY = game.getSetting("HudHeight");
     y = topY;
     width = game.gameScreenWidth;
-    height = game.gameScreenHeight - game.getSetting("HudHeight");
+    height = game.gameScreenHeight - game.getSetting("HudHeight").get<uint32_t>();
     // set the sliding speed so that it takes "slideDuration" seconds to expand the inventory
     speed = height / slideDuration;
     state = SLIDING_LEFT;
@@ -38,7 +38,7 @@ void MapUI::update(float deltaTime) {
             y = std::min(static_cast<float>(game.gameScreenHeight), y + deltaTime * speed);
         }
         else {
-            game.eventManager.pushEvent("InventoryDone");
+            game.eventManager.pushEvent("InventoryDone"_id);
             game.stopScene("MapUI");
         }
         break;
@@ -63,11 +63,11 @@ void MapUI::update(float deltaTime) {
     case OPENED:
         if (game.buttonsPressed & CONTROL_CONFIRM) {
             state = CLOSING;
-            game.playSound("menuClose");
+            game.playSound("menuClose"_id);
         }
         if (game.buttonsPressed & CONTROL_ACTIONL) {
             state = SLIDING_RIGHT;
-            game.playSound("menuOpen");
+            game.playSound("menuOpen"_id);
             game.resumeScene("InventoryUI");
         }
         break;
@@ -99,7 +99,7 @@ void MapUI::draw() {
     offsets[3].x = float(cellWidth / 2 - spacing / 2);
     offsets[3].y = float(cellHeight);
 
-    auto& minimaps = game.currentDungeon->minimapTextures;
+    const auto& minimapRects = game.currentDungeon->minimapRects;
     for (int i = 0; i < cols * rows; ++i) {
         int col = i % cols;
         int row = i / cols;
@@ -108,11 +108,9 @@ void MapUI::draw() {
         Color color = DARKGRAY;
         DrawRectangle(cellX, cellY, cellWidth, cellHeight, color);
 
-        if (i < minimaps.size() && game.currentDungeon->hasVisited(i)) {
-            const auto& tex = minimaps[i].texture;
-            Rectangle src = { 0, 0, (float)tex.width, (float)tex.height };
+        if (i < minimapRects.size() && game.currentDungeon->hasVisited(i)) {
             Rectangle dst = { (float)cellX, (float)cellY, (float)cellWidth, (float)cellHeight };
-            DrawTexturePro(tex, src, dst, { 0, 0 }, 0.0f, WHITE);
+            DrawTexturePro(game.currentDungeon->minimapAtlas, minimapRects[i], dst, { 0, 0 }, 0.0f, WHITE);
 
             // indicate the connections between rooms
             uint8_t doors = game.currentDungeon->getRoomDoors(i);
@@ -166,5 +164,5 @@ void MapUI::draw() {
 }
 
 void MapUI::end() {
-    game.eventManager.pushEvent("setMusicVolume", 1.0f);
+    game.eventManager.emit<MusicVolume>(1.0f);
 }
\ No newline at end of file
@@ -3,8 +3,8 @@
 #include "Scene.h"
 #include <iostream>
 #include <string>
-#include <functional>
-#include <queue>
+#include <memory>
+#include "AsyncLoader.h"
 
 class Preload : public Scene {
 public:
@@ -15,7 +15,8 @@ public:
     void end() override;
 
 private:
-    std::queue<std::pair<std::string, std::function<void()>>> loadQueue;
+    std::unique_ptr<AsyncLoader> assets;
     std::string currentMessage = "Loading...";
-    size_t totalLoadSteps = 0;
+    float progress = 0.0f;
+    double uploadBudgetMs = 4.0; // main thread time per frame for GPU uploads
 };
\ No newline at end of file
@@ -10,15 +10,15 @@ void SelectMenu::startup()
         {
             "Back to Game",
             [&]() {
-                game.eventManager.pushEvent("SelectMenuDone");
+                game.eventManager.pushEvent("SelectMenuDone"_id);
                 game.stopScene(getName());
             }
         },
         {
             "Save Game",
             [&]() {
-                game.eventManager.pushEvent("saveGame");
-                game.eventManager.pushEvent("SelectMenuDone");
+                game.eventManager.pushEvent("saveGame"_id);
+                game.eventManager.pushEvent("SelectMenuDone"_id);
                 game.stopScene(getName());
             }
         },
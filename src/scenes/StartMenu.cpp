@@ -7,11 +7,10 @@
 StartMenu::StartMenu(Game& game, const std::string& name) 
     : Scene(game, name), menu(MenuSelect(game)) {
 
-    game.eventManager.addListener("loadingSavegameSuccess", [&](const std::any& data) {
-            game.startScene("InGame");
-            game.startScene("HUD");
+    subscriptions.push_back(game.eventManager.listen("loadingSavegameSuccess", [&](const std::any& data) {
+            game.startInGame();
             game.stopScene(getName());
-        });
+        }));
 }
 
 void StartMenu::startup() {
@@ -20,8 +19,7 @@ void StartMenu::startup() {
             "New Game", 
             [&]() {
                 // starts a new game
-                game.startScene("InGame");
-                game.startScene("HUD");
+                game.startInGame();
                 game.stopScene(getName());
             }
         },
@@ -29,7 +27,7 @@ void StartMenu::startup() {
             "Load Game", 
             [&]() {
                 // TODO: Transition to another menu that lets you select a file
-                game.eventManager.pushEvent("loadGame");
+                game.eventManager.pushEvent("loadGame"_id);
             }
         },
         {
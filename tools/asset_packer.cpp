@@ -0,0 +1,168 @@
+#include "AssetArchive.h"
+#include "raylib.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+Builds the asset archive that the game mounts at startup
+usage: asset_packer <resources directory> <output file> [--no-compress]
+the paths in the archive start with the name of the resources directory ("resources/..."),
+the same way Preload refers to them
+*/
+
+namespace fs = std::filesystem;
+
+struct PackedFile {
+    std::string path; // key in the archive
+    std::vector<unsigned char> data; // stored bytes (compressed or not)
+    ArchiveEntry entry;
+};
+
+// already compressed formats (png, ogg, mp3) don't get any smaller
+// audio is never compressed because music is streamed straight from the archive
+static bool isCompressible(const fs::path& file) {
+    static const std::vector<std::string> extensions = { ".json", ".tsj", ".tmj", ".fs", ".vs", ".glsl", ".txt", ".ttf" };
+    std::string ext = file.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return std::find(extensions.begin(), extensions.end(), ext) != extensions.end();
+}
+
+static bool isCompiledAway(const fs::path& file) {
+    fs::path compiled = file;
+    if (file.extension() == ".tsj") compiled.replace_extension(".tsb");
+    else if (file.extension() == ".json" && file.parent_path().filename() == "tilemaps") compiled.replace_extension(".tmb");
+    else return false;
+    return fs::exists(compiled);
+}
+
+static std::vector<unsigned char> readFile(const fs::path& file) {
+    std::ifstream in(file, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+template <typename T>
+static void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: asset_packer <resources directory> <output file> [--no-compress]\n";
+        return 1;
+    }
+    fs::path root = fs::path(argv[1]).lexically_normal();
+    if (root.filename().empty()) root = root.parent_path(); // trailing slash
+    fs::path output = argv[2];
+    bool compress = !(argc > 3 && std::strcmp(argv[3], "--no-compress") == 0);
+    SetTraceLogLevel(LOG_WARNING);
+
+    if (!fs::is_directory(root)) {
+        std::cerr << "not a directory: " << root.string() << "\n";
+        return 1;
+    }
+
+    // sorted, so the same input always gives the same archive
+    std::vector<fs::path> inputs;
+    for (const auto& item : fs::recursive_directory_iterator(root)) {
+        if (!item.is_regular_file()) continue;
+        // settings stay a loose file so they can be edited after shipping
+        if (item.path().filename() == "settings.json") continue;
+        // Tiled files are not needed if there is a compiled version (see tilemap_compiler)
+        if (isCompiledAway(item.path())) continue;
+        inputs.push_back(item.path());
+    }
+    std::sort(inputs.begin(), inputs.end());
+
+    std::vector<PackedFile> files;
+    files.reserve(inputs.size());
+    uint64_t rawTotal = 0;
+    size_t compressedCount = 0;
+    for (const fs::path& input : inputs) {
+        PackedFile packed;
+        packed.path = AssetArchive::normalizePath((root.filename() / fs::relative(input, root)).string());
+        packed.data = readFile(input);
+        packed.entry.rawSize = packed.data.size();
+        rawTotal += packed.data.size();
+
+        if (compress && isCompressible(input) && !packed.data.empty()) {
+            int compSize = 0;
+            unsigned char* comp = CompressData(packed.data.data(), static_cast<int>(packed.data.size()), &compSize);
+            // only worth it if it saves at least 10 %
+            if (comp && static_cast<uint64_t>(compSize) * 10 < packed.entry.rawSize * 9) {
+                packed.data.assign(comp, comp + compSize);
+                packed.entry.flags |= ARCHIVE_FLAG_COMPRESSED;
+                compressedCount++;
+            }
+            if (comp) MemFree(comp);
+        }
+        packed.entry.size = packed.data.size();
+        files.push_back(std::move(packed));
+    }
+
+    // table of contents first, then the blobs
+    uint32_t tocSize = 0;
+    for (const auto& file : files) {
+        tocSize += static_cast<uint32_t>(sizeof(uint64_t) * 3 + sizeof(uint32_t) * 2 + file.path.size());
+    }
+    uint64_t offset = alignUp(sizeof(ArchiveHeader) + tocSize);
+    for (auto& file : files) {
+        file.entry.offset = offset;
+        offset = alignUp(offset + file.entry.size);
+    }
+
+    std::ofstream out(output, std::ios::binary);
+    if (!out) {
+        std::cerr << "can't write " << output.string() << "\n";
+        return 1;
+    }
+    ArchiveHeader header;
+    std::memcpy(header.magic, ARCHIVE_MAGIC, 4);
+    header.version = ARCHIVE_VERSION;
+    header.entryCount = static_cast<uint32_t>(files.size());
+    header.tocSize = tocSize;
+    writeValue(out, header);
+    for (const auto& file : files) {
+        writeValue(out, file.entry.offset);
+        writeValue(out, file.entry.size);
+        writeValue(out, file.entry.rawSize);
+        writeValue(out, file.entry.flags);
+        writeValue(out, static_cast<uint32_t>(file.path.size()));
+        out.write(file.path.data(), static_cast<std::streamsize>(file.path.size()));
+    }
+    for (const auto& file : files) {
+        uint64_t position = static_cast<uint64_t>(out.tellp());
+        static const char padding[ARCHIVE_ALIGNMENT] = {};
+        out.write(padding, static_cast<std::streamsize>(file.entry.offset - position));
+        out.write(reinterpret_cast<const char*>(file.data.data()), static_cast<std::streamsize>(file.data.size()));
+    }
+    out.close();
+
+    // read everything back through the game's code path
+    AssetArchive archive;
+    if (!archive.open(output.string())) {
+        std::cerr << "failed to open the written archive\n";
+        return 1;
+    }
+    for (const fs::path& input : inputs) {
+        std::string key = AssetArchive::normalizePath((root.filename() / fs::relative(input, root)).string());
+        AssetBlob blob = archive.read(key);
+        std::vector<unsigned char> original = readFile(input);
+        if (blob.size != original.size() || (blob.size > 0 && std::memcmp(blob.data, original.data(), blob.size) != 0)) {
+            std::cerr << "verification failed: " << key << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "packed " << files.size() << " files (" << compressedCount << " compressed) into " << output.string() << "\n"
+        << "  " << rawTotal / 1024 << " KiB of assets, archive is " << fs::file_size(output) / 1024 << " KiB\n";
+    return 0;
+}
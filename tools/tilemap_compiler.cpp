@@ -0,0 +1,162 @@
+#include "TileMapBinary.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+Compiles Tiled maps (.json) and tilesets (.tsj) into .tmb/.tsb files
+usage: tilemap_compiler [-o output directory] [--verify] [--bench iterations] files...
+    -o          where to write the compiled files (default: next to the input)
+    --verify    loads every compiled file again and compares it with the result of the JSON loader
+    --bench     times the JSON loader against the compiled loader for every map
+*/
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static std::string readText(const fs::path& file) {
+    std::ifstream in(file, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+static bool writeBytes(const fs::path& file, const std::vector<unsigned char>& bytes) {
+    std::ofstream out(file, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(out);
+}
+
+// returns an empty string if both maps are the same
+static std::string compareMaps(const TileMap& a, const TileMap& b) {
+    if (a.width != b.width || a.height != b.height) return "map size";
+    if (a.tileWidth != b.tileWidth || a.tileHeight != b.tileHeight) return "tile size";
+    if (a.getTilesetName() != b.getTilesetName()) return "tileset name";
+    if (a.getMusicKey() != b.getMusicKey()) return "music";
+    if (a.layers.size() != b.layers.size()) return "layer count";
+    for (size_t i = 0; i < a.layers.size(); ++i) {
+        const TileLayer& la = a.layers[i];
+        const TileLayer& lb = b.layers[i];
+        std::string where = "layer '" + la.name + "': ";
+        if (la.name != lb.name) return where + "name";
+        if (la.visible != lb.visible) return where + "visible";
+        if (la.width != lb.width || la.height != lb.height) return where + "size";
+        if (la != lb) return where + "tiles";
+        if (la.properties != lb.properties) return where + "properties";
+    }
+    if (a.objects.size() != b.objects.size()) return "object count";
+    for (size_t i = 0; i < a.objects.size(); ++i) {
+        const TileObject& oa = a.objects[i];
+        const TileObject& ob = b.objects[i];
+        std::string where = "object " + std::to_string(oa.id) + " (" + oa.name + "): ";
+        if (oa.type != ob.type || oa.name != ob.name) return where + "type/name";
+        if (oa.x != ob.x || oa.y != ob.y || oa.width != ob.width || oa.height != ob.height) return where + "rectangle";
+        if (oa.id != ob.id || oa.visible != ob.visible) return where + "id/visible";
+        if (oa.properties != ob.properties) return where + "properties";
+    }
+    return "";
+}
+
+static std::string compareTilesets(const Tileset& a, const std::string& imageA, const Tileset& b, const std::string& imageB) {
+    if (a.name != b.name || a.image != b.image || imageA != imageB) return "name/image";
+    if (a.imagewidth != b.imagewidth || a.imageheight != b.imageheight) return "image size";
+    if (a.tilecount != b.tilecount || a.columns != b.columns) return "tile count";
+    if (a.tilewidth != b.tilewidth || a.tileheight != b.tileheight) return "tile size";
+    return "";
+}
+
+int main(int argc, char** argv) {
+    fs::path outputDir;
+    bool verify = false;
+    int benchIterations = 0;
+    std::vector<fs::path> inputs;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) outputDir = argv[++i];
+        else if (arg == "--verify") verify = true;
+        else if (arg == "--bench" && i + 1 < argc) benchIterations = std::max(1, std::stoi(argv[++i]));
+        else inputs.push_back(arg);
+    }
+    if (inputs.empty()) {
+        std::cerr << "usage: tilemap_compiler [-o output directory] [--verify] [--bench iterations] files...\n";
+        return 1;
+    }
+    if (!outputDir.empty()) fs::create_directories(outputDir);
+
+    int failures = 0;
+    for (const fs::path& input : inputs) {
+        bool isTileset = input.extension() == ".tsj";
+        fs::path output = (outputDir.empty() ? input.parent_path() : outputDir) / input.filename();
+        output.replace_extension(isTileset ? ".tsb" : ".tmb");
+
+        std::string text = readText(input);
+        nlohmann::json j;
+        std::vector<unsigned char> compiled;
+        try {
+            j = nlohmann::json::parse(text);
+            compiled = isTileset ? compileTileset(j) : compileTileMap(j);
+        }
+        catch (const std::exception& e) {
+            // not fatal, the game just loads the JSON for this one
+            std::cerr << "skipped " << input.string() << ": " << e.what() << "\n";
+            continue;
+        }
+        if (!writeBytes(output, compiled)) {
+            std::cerr << "can't write " << output.string() << "\n";
+            failures++;
+            continue;
+        }
+        std::cout << input.filename().string() << " -> " << output.filename().string()
+            << " (" << text.size() / 1024 << " KiB -> " << compiled.size() / 1024 << " KiB)\n";
+
+        if (verify) {
+            std::string difference;
+            if (isTileset) {
+                Tileset fromBinary;
+                std::string imageFromBinary;
+                if (!loadCompiledTileset(compiled.data(), compiled.size(), fromBinary, imageFromBinary)) difference = "can't be loaded";
+                else difference = compareTilesets(Tileset(j), j["image"].get<std::string>(), fromBinary, imageFromBinary);
+            }
+            else {
+                std::string name = input.stem().string();
+                auto fromBinary = loadCompiledTileMap(compiled.data(), compiled.size(), name);
+                if (!fromBinary) difference = "can't be loaded";
+                else difference = compareMaps(TileMap(j, name), *fromBinary);
+            }
+            if (!difference.empty()) {
+                std::cerr << "  verify FAILED: " << difference << "\n";
+                failures++;
+            }
+            else {
+                std::cout << "  verified\n";
+            }
+        }
+
+        if (benchIterations > 0 && !isTileset) {
+            // what LoadtileMapFromTiled did (parse + construct) against the compiled loader, file IO excluded
+            std::string name = input.stem().string();
+            size_t check = 0;
+            auto start = Clock::now();
+            for (int i = 0; i < benchIterations; ++i) {
+                TileMap map(nlohmann::json::parse(text), name);
+                check += map.layers.size();
+            }
+            double jsonMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / benchIterations;
+            start = Clock::now();
+            for (int i = 0; i < benchIterations; ++i) {
+                auto map = loadCompiledTileMap(compiled.data(), compiled.size(), name);
+                check += map->layers.size();
+            }
+            double binaryMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / benchIterations;
+            std::printf("  bench: json %.3f ms, compiled %.3f ms, %.1fx faster (%zu)\n",
+                jsonMs, binaryMs, binaryMs > 0.0 ? jsonMs / binaryMs : 0.0, check);
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}